@@ -11,36 +11,20 @@ greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 TARGET = CubeSolver
 TEMPLATE = app
 
+CONFIG += c++14
+
 
 SOURCES += main.cpp\
         widget.cpp \
     solverthread.cpp \
-    solver/calculateordinal.cpp \
-    solver/cube.cpp \
-    solver/cubeparser.cpp \
-    solver/groupcube.cpp \
-    solver/idastarsearch.cpp \
-    solver/movetable.cpp \
-    solver/ordinalcube.cpp \
-    solver/printvector.cpp \
-    solver/pruningtable.cpp \
     opengl/glwidget.cpp
 
 HEADERS  += widget.h \
     solverthread.h \
-    solver/cube.h \
-    solver/cubeparser.h \
-    solver/groupcube.h \
-    solver/movetable.h \
-    solver/printvector.h \
-    solver/pruningtable.h \
-    solver/submovetable.h \
-    solver/timer.h \
-    solver/calculateordinal.h \
-    solver/idastarsearch.h \
-    solver/ordinalcube.h \
     opengl/glwidget.h
 
 FORMS    += widget.ui
 
+include(solver/solver.pri)
+
 LIBS += opengl32.lib glu32.lib
@@ -0,0 +1,114 @@
+#include "solver/ordinalcube.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // 計測に用いるCubeの数(2の累乗)
+    const int NumberOfCubes = 4096;
+    // 最適化で計算が省かれないように，結果の合計を書き込む
+    volatile long long g_sink;
+
+    // p_function(i)をp_iterations回呼び出して，1回あたりの時間(ns)を表示する
+    template <class TFunction>
+    void Measure(const char* p_name, const int p_iterations, TFunction p_function)
+    {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        long long sum = 0;
+        for (int i = 0; i < p_iterations; i++) {
+            sum += p_function(i);
+        }
+        const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        g_sink = sum;
+
+        const double nanoseconds = std::chrono::duration<double, std::nano>(end - start).count() / p_iterations;
+        std::printf("%-22s %8.2f ns/call\n", p_name, nanoseconds);
+    }
+
+    // Phase 2の移動(U, D, 他の面は180[deg]回転のみ)をランダムに選ぶ
+    int GetRandomPhase2Move(std::mt19937& p_random)
+    {
+        const int face = (int)(p_random() % 6);
+        if (face == CCube::Move::U || face == CCube::Move::D) {
+            return CCube::GetMoveOfPower(face, 1 + (int)(p_random() % 3));
+        }
+        return CCube::GetMoveOfPower(face, 2);
+    }
+
+    // 全ての序数について，序数 -> 状態 -> 序数で元の序数に戻ることを確認する
+    bool VerifyRoundTrip()
+    {
+        COrdinalCube cube;
+        for (int ordinal = 0; ordinal < COrdinalCube::Choices; ordinal++) {
+            cube.SetCleanCube();
+            cube.SetChoiceFromEdgePermutation(ordinal);
+            if (cube.GetChoiceFromEdgePermutation() != ordinal) {
+                return false;
+            }
+        }
+        for (int ordinal = 0; ordinal < COrdinalCube::CornerPermutations; ordinal++) {
+            cube.SetCleanCube();
+            cube.SetCornerPermutationFromOrdinal(ordinal);
+            if (cube.GetOrdinalFromCornerPermutation() != ordinal) {
+                return false;
+            }
+            cube.SetCleanCube();
+            cube.SetUpDownEdgePermutationFromOrdinal(ordinal);
+            if (cube.GetOrdinalFromUpDownEdgePermutation() != ordinal) {
+                return false;
+            }
+        }
+        for (int ordinal = 0; ordinal < COrdinalCube::MiddleEdgePermutations; ordinal++) {
+            cube.SetCleanCube();
+            cube.SetMiddleEdgePermutationFromOrdinal(ordinal);
+            if (cube.GetOrdinalFromMiddleEdgePermutation() != ordinal) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+// OrdinalBenchmark [1つの計測あたりの呼び出し回数]
+// 呼び出し回数を省略したときは20000000回
+int main(int argc, char *argv[])
+{
+    const int iterations = (argc > 1) ? std::atoi(argv[1]) : 20000000;
+
+    if (!VerifyRoundTrip()) {
+        std::fprintf(stderr, "Ordinal round trip failed\n");
+        return 1;
+    }
+
+    // ランダムな状態のCube(Phase 1用)と，Phase 1の完成状態から移動したCube(Phase 2用)
+    std::mt19937 random(1);
+    std::vector<COrdinalCube> cubes(NumberOfCubes);
+    std::vector<COrdinalCube> phase2Cubes(NumberOfCubes);
+    for (int i = 0; i < NumberOfCubes; i++) {
+        for (int j = 0; j < 30; j++) {
+            cubes[i].ApplyMove((int)(random() % CCube::NumberOfMoves));
+            phase2Cubes[i].ApplyMove(GetRandomPhase2Move(random));
+        }
+    }
+
+    const int mask = NumberOfCubes - 1;
+    COrdinalCube cube;
+    Measure("Choice get", iterations, [&](int i) { return cubes[i & mask].GetChoiceFromEdgePermutation(); });
+    Measure("Choice set", iterations, [&](int i) { cube.SetChoiceFromEdgePermutation(i % COrdinalCube::Choices); return cube.GetEdgePermutation()[i % CCube::NumberOfEdgeSets]; });
+    Measure("Twist get", iterations, [&](int i) { return cubes[i & mask].GetTwistFromOrientations(); });
+    Measure("Twist set", iterations, [&](int i) { cube.SetOrientationsFromTwist(i % COrdinalCube::Twists); return cube.GetCornerOrientations()[i % CCube::NumberOfCornerSets]; });
+    Measure("Flip get", iterations, [&](int i) { return cubes[i & mask].GetFlipFromOrientations(); });
+    Measure("Flip set", iterations, [&](int i) { cube.SetOrientationsFromFlip(i % COrdinalCube::Flips); return cube.GetEdgeOrientations()[i % CCube::NumberOfEdgeSets]; });
+    Measure("CornerPerm get", iterations, [&](int i) { return phase2Cubes[i & mask].GetOrdinalFromCornerPermutation(); });
+    Measure("CornerPerm set", iterations, [&](int i) { cube.SetCornerPermutationFromOrdinal(i % COrdinalCube::CornerPermutations); return cube.GetCornerPermutation()[i % CCube::NumberOfCornerSets]; });
+    Measure("UDEdgePerm get", iterations, [&](int i) { return phase2Cubes[i & mask].GetOrdinalFromUpDownEdgePermutation(); });
+    Measure("UDEdgePerm set", iterations, [&](int i) { cube.SetUpDownEdgePermutationFromOrdinal(i % COrdinalCube::UpDownEdgePermutations); return cube.GetEdgePermutation()[i % CCube::NumberOfCornerSets]; });
+    Measure("MiddleEdgePerm get", iterations, [&](int i) { return phase2Cubes[i & mask].GetOrdinalFromMiddleEdgePermutation(); });
+    Measure("MiddleEdgePerm set", iterations, [&](int i) { cube.SetMiddleEdgePermutationFromOrdinal(i % COrdinalCube::MiddleEdgePermutations); return cube.GetEdgePermutation()[CCube::FirstMiddleEdgeSet + i % 4]; });
+
+    return 0;
+}
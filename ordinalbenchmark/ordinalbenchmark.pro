@@ -0,0 +1,21 @@
+#-------------------------------------------------
+#
+# OrdinalBenchmark
+# COrdinalCubeの序数の計算(GetOrdinalFrom*, Set*FromOrdinal)の1回あたりの時間を計測する
+# (序数の計算を変更したときに，変更前後の速度を比較するために実行する)
+#
+#-------------------------------------------------
+
+QT       += core
+QT       -= gui
+
+TARGET = OrdinalBenchmark
+TEMPLATE = app
+
+CONFIG += c++14 console release
+CONFIG -= app_bundle
+
+
+SOURCES += main.cpp
+
+include(../solver/solver.pri)
@@ -1,10 +1,200 @@
-﻿// N Choose K を計算する
-// http://tsujimotter.hatenablog.com/entry/ruby-binomial-coefficient
-int NChooseK(int p_N, int p_K);
+﻿#ifndef	_CALCULATEORDINAL_H_
+#define	_CALCULATEORDINAL_H_
+
+#include <cstdint>
+
+// 序数の計算はMoveTableをコンパイル時に作成するときにも使用するので，constexprとしてヘッダで定義する
+// 実行時には探索の度に呼ばれるので，二項係数や組み合わせの序数はコンパイル時に作成したTableを引き，
+// 計算の途中でメモリを確保したり再帰したりしない
+
+// 序数の計算で扱う要素の数の上限(Edgeは12, Cornerは8)
+enum
+{
+	MaxOrdinalElements = 12,
+	MaxChoiceMask = (1 << MaxOrdinalElements)	// 12個の要素から選んだ組み合わせを表すbitの数
+};
+
+// 二項係数C(n, k)のTable(n, k = 0 ~ 12)
+struct SBinomialTable
+{
+	int values[MaxOrdinalElements + 1][MaxOrdinalElements + 1];
+};
+
+// パスカルの三角形で二項係数のTableを作成する
+constexpr SBinomialTable CreateBinomialTable()
+{
+	SBinomialTable table = {};
+	for (int n = 0; n <= MaxOrdinalElements; n++) {
+		table.values[n][0] = 1;
+		for (int k = 1; k <= n; k++) {
+			table.values[n][k] = table.values[n - 1][k - 1] + table.values[n - 1][k];
+		}
+	}
+	return table;
+}
+
+// 12個から4個を選ぶ組み合わせ(Middle層のEdgeの位置)と序数(choice)の変換Table
+// 組み合わせは選んだ位置のbitを立てた12bitの値で表す
+// 序数の順番はCOrdinalCube::ChoiceOrdinalの説明を参照
+struct SChoiceTable
+{
+	enum
+	{
+		ChoiceElements = 4,	// 選ぶ要素の数
+		Choices = 495	// 12 choose 4
+	};
+
+	int16_t maskToOrdinal[MaxChoiceMask];	// 4bitが立っていない値は使用しない(0)
+	int16_t ordinalToMask[Choices];
+};
+
+// 組み合わせの序数のTableを作成する
+// 選んだ要素の左から順に，選ばなかった位置ごとにC(右側の位置の数, 未チェックの要素の数 - 1)を加算する
+constexpr SChoiceTable CreateChoiceTable()
+{
+	const SBinomialTable binomials = CreateBinomialTable();
+	SChoiceTable table = {};
+
+	for (int mask = 0; mask < MaxChoiceMask; mask++) {
+		int elements = 0;
+		for (int i = 0; i < MaxOrdinalElements; i++) {
+			elements += (mask >> i) & 1;
+		}
+		if (elements != SChoiceTable::ChoiceElements) {
+			continue;
+		}
+
+		int elementsRemaining = SChoiceTable::ChoiceElements;
+		int ordinal = 0;
+		for (int i = 0; elementsRemaining > 0; i++) {
+			if ((mask >> i) & 1) {
+				elementsRemaining--;
+			}
+			else {
+				ordinal += binomials.values[MaxOrdinalElements - 1 - i][elementsRemaining - 1];
+			}
+		}
+		table.maskToOrdinal[mask] = (int16_t)ordinal;
+		table.ordinalToMask[ordinal] = (int16_t)mask;
+	}
+	return table;
+}
+
+// 12以下の数で割る除算を，乗算とshiftで行うための逆数のTable
+// reciprocals[d]は2^35 / dを切り上げた値で，割られる数が12! (< 2^29)未満なら商は正確に求まる
+struct SReciprocalTable
+{
+	enum
+	{
+		Shift = 35
+	};
+
+	uint64_t reciprocals[MaxOrdinalElements + 1];	// reciprocals[0]は使用しない
+};
+
+// 逆数のTableを作成する
+constexpr SReciprocalTable CreateReciprocalTable()
+{
+	SReciprocalTable table = {};
+	for (int d = 1; d <= MaxOrdinalElements; d++) {
+		table.reciprocals[d] = ((1ULL << SReciprocalTable::Shift) + d - 1) / d;
+	}
+	return table;
+}
+
+// コンパイル時に作成した序数の計算用のTable
+// (定義はordinalcube.cpp)
+class COrdinalTables
+{
+public:
+	static constexpr SBinomialTable Binomials = CreateBinomialTable();
+	static constexpr SChoiceTable Choices = CreateChoiceTable();
+	static constexpr SReciprocalTable Reciprocals = CreateReciprocalTable();
+
+	// p_valueをp_divisor(1 ~ 12)で割った商
+	static constexpr int Divide(const int p_value, const int p_divisor)
+	{
+		return (int)(((uint64_t)p_value * Reciprocals.reciprocals[p_divisor]) >> SReciprocalTable::Shift);
+	}
+};
+
+// N Choose K を求める(N, K <= 12)
+constexpr int NChooseK(const int p_N, const int p_K)
+{
+	return (p_K < 0 || p_N < p_K) ? 0 : COrdinalTables::Binomials.values[p_N][p_K];
+}
 
 // Corner or Edgeの順列を表現する序数を計算する
+// OrdinalToPermutationの逆演算
 // http://kociemba.org/math/coordlevel.htm
-int PermutationToOrdinal(const int* p_vector, const int p_n);
+// 要素(0 ~ 11の異なる値)は互いに異なるので，各要素の位置と残っている要素のbitを持っておけば，
+// 最も大きな要素とその位置を配列を走査せずに求められる
+constexpr int PermutationToOrdinal(const int* p_vector, const int p_n)
+{
+	int Ordinal = 0;
+	int Vector[MaxOrdinalElements] = {};	// Edgeは12, Cornerは8
+	int Position[MaxOrdinalElements] = {};	// 要素の値 -> Vectorの中の位置
+	int Remaining = 0;	// まだLimit位置に移していない要素のbit
+
+	// vectorをコピー
+	for (int i = 0; i < p_n; i++) {
+		Vector[i] = p_vector[i];
+		Position[p_vector[i]] = i;
+		Remaining |= 1 << p_vector[i];
+	}
+
+	// 置換を互換で表したときの互換の数を計算する
+	int Temp = MaxOrdinalElements - 1;	// 最も大きな値
+	for (int Limit = p_n - 1; Limit > 0; Limit--) {
+		// 各Limit(Edgeは11，Cornerは7)から1つずつ下げる
+
+		// 残っている要素で最も大きな値を求める(Limitを下げる度に小さくなるので，続きから探す)
+		while (!((Remaining >> Temp) & 1)) {
+			Temp--;
+		}
+		// Coeff_i:最も大きな値の要素番号
+		const int Coeff_i = Position[Temp];
+
+		// 積算する(Permutationを，p_n進数から10進数に変換するような処理)
+		// Limitは次第に小さくなるので，上位桁から設定する
+		// PermutationがCleanから遠いほど大きな値が格納される
+		Ordinal = Ordinal * (Limit + 1) + Coeff_i;
+
+		// Limit位置の要素が一番大きくなるように入れ替える
+		// (Limit位置には以降参照しないので，Coeff_i位置に移した要素の位置だけ更新する)
+		Vector[Coeff_i] = Vector[Limit];
+		Position[Vector[Coeff_i]] = Coeff_i;
+		Remaining &= ~(1 << Temp);
+
+		// 次のループでは2番目に大きな要素が最後から2番目に格納される
+	}
+	return Ordinal;
+}
 
 // 序数から，それに対してuniqueなCorner or Edgeの順列を求める
-void OrdinalToPermutation(int p_ordinal, int* vector, const int p_n, const int p_offset);
+// PermutationToOrdinalの逆演算
+constexpr void OrdinalToPermutation(int p_ordinal, int* vector, const int p_n, const int p_offset)
+{
+	int Temp = 0;
+ 
+	// cleanな順列を作成する
+	for (int i = 0; i < p_n; i++) {
+		vector[i] = i + p_offset;
+	}
+
+	for (int i = 1; i < p_n; i++) {
+		// 商と剰余を求める(除算は逆数の乗算で行う)
+		const int Quotient = COrdinalTables::Divide(p_ordinal, i + 1);
+		int Coeff_i = p_ordinal - Quotient * (i + 1);
+
+		// 剰余を求めたので(i + 1)で割る
+		p_ordinal = Quotient;
+
+		// 要素を交換する
+		Temp            = vector[i];
+		vector[i]       = vector[Coeff_i];
+		vector[Coeff_i] = Temp;
+	}
+}
+
+#endif	// _CALCULATEORDINAL_H_
@@ -0,0 +1,172 @@
+﻿#include "cornerpermutationpruningtable.h"
+#include "../solverthread.h"
+
+CCornerAndUpDownPruningTable::CCornerAndUpDownPruningTable(
+	CCornerPermutationMoveTable& cornerPermutationMoveTable, CUpDownEdgePermutationMoveTable& upDownEdgePermutationMoveTable,
+	CCornerPermutationSymmetryTable& cornerPermutationSymmetryTable,
+	const int p_homeCornerPermutation, const int p_homeUpDownEdgePermutation, const Encoding p_encoding) :
+	CPruningTable(CCornerPermutationSymmetryTable::CornerPermutationClasses * COrdinalCube::UpDownEdgePermutations, p_encoding),
+	m_cornerPermutationMoveTable(cornerPermutationMoveTable),
+	m_upDownEdgePermutationMoveTable(upDownEdgePermutationMoveTable),
+	m_cornerPermutationSymmetryTable(cornerPermutationSymmetryTable),
+	m_homeCornerPermutation(p_homeCornerPermutation),
+	m_homeUpDownEdgePermutation(p_homeUpDownEdgePermutation)
+{
+}
+
+// PruningTableを作成する
+void CCornerAndUpDownPruningTable::GeneratePruningTable()
+{
+	unsigned int depth = 0;
+	int numberOfNodes;
+	int numberOfNodesAtDepth;
+
+	Clear();	// Empty = 0x0F
+
+	// 探索木のスタート地点を設定する
+	int home = GetIndex(m_homeCornerPermutation, m_homeUpDownEdgePermutation);
+	SetValue(home, depth);
+	numberOfNodes = 1;	// ノードの数
+	numberOfNodes += SetSymmetricValues(home, depth);
+	numberOfNodesAtDepth = numberOfNodes;
+
+	// テーブルサイズいっぱいまで繰り返す
+	// MaxDepthに達したら，残りは全てMaxDepth以上なのでMaxDepthを格納する
+	while (numberOfNodes < GetSize() && depth + 1 < MaxDepth) {
+		// 複数のスレッドで分担して探索する
+		// 空のIndexの方が少なくなったら，空のIndexから逆向きに探索する
+		const bool isBackward = IsBackwardSearchEfficient(numberOfNodesAtDepth, numberOfNodes);
+		numberOfNodesAtDepth = ParallelFor(CCornerPermutationSymmetryTable::CornerPermutationClasses, ChunkSize, [&](const int p_begin, const int p_end) {
+			return isBackward ? ExpandClassesBackward(p_begin, p_end, depth) : ExpandClasses(p_begin, p_end, depth);
+		});
+		numberOfNodes += numberOfNodesAtDepth;
+		// 探索が終了したらdepthを深くする
+		depth++;
+		NotifyDepthCompleted(depth, numberOfNodes);
+	}
+
+	// MaxDepthまでに到達しなかった状態
+	for (int index = 0; index < GetSize(); index++) {
+		if (GetValue(index) == Empty) {
+			SetValue(index, MaxDepth);
+		}
+	}
+}
+
+// [p_begin, p_end)の同値類のうち，depthがp_depthのIndexから枝を伸ばす
+// 新たに格納したIndexの数をreturnする
+int CCornerAndUpDownPruningTable::ExpandClasses(const int p_begin, const int p_end, const unsigned int p_depth)
+{
+	int numberOfNodes = 0;
+
+	for (int classIndex = p_begin; classIndex < p_end; classIndex++) {
+		// 代表元のCornerの順列にPhase 2の10種類の移動を行った後の同値類と対称変換
+		// Edgeの順列によらないので，同値類ごとに1回だけ求める
+		int classIndices[CCube::Move::NumberOfMoves], symmetries[CCube::Move::NumberOfMoves];
+		bool isExpanded = false;
+		const int begin = classIndex * COrdinalCube::UpDownEdgePermutations;
+		const int end = begin + COrdinalCube::UpDownEdgePermutations;
+
+		// 現在のdepthと一致したら，そこから枝を伸ばす
+		for (int index = FindValue(begin, end, p_depth); index < end; index = FindValue(index + 1, end, p_depth)) {
+			int permutation = index - begin;
+
+			if (!isExpanded) {
+				GetMovedClasses(classIndex, classIndices, symmetries);
+				isExpanded = true;
+			}
+
+			// 代表元は対称変換が恒等変換なので，Edgeの順列はそのまま使える
+			for (int move = CCube::Move::U; move < CCube::Move::NumberOfMoves; move++) {
+				if (!CCube::IsPhase2Move(move)) continue;
+				int index2 = classIndices[move] * COrdinalCube::UpDownEdgePermutations
+					+ m_cornerPermutationSymmetryTable.ConjugateUpDownEdgePermutation(
+						m_upDownEdgePermutationMoveTable[permutation][move], symmetries[move]);
+
+				// 既にindex2の場所に状態が設定されていたら飛ばす
+				if (SetValueIfEmpty(index2, p_depth + 1)) {
+					numberOfNodes++;
+					numberOfNodes += SetSymmetricValues(index2, p_depth + 1);
+				}
+			}
+		}
+	}
+	return numberOfNodes;
+}
+
+// [p_begin, p_end)の同値類のうち，空のIndexから逆向きに枝を伸ばし，
+// depthがp_depthのIndexに隣接していればp_depth + 1を格納する
+// 新たに格納したIndexの数をreturnする
+int CCornerAndUpDownPruningTable::ExpandClassesBackward(const int p_begin, const int p_end, const unsigned int p_depth)
+{
+	int numberOfNodes = 0;
+
+	for (int classIndex = p_begin; classIndex < p_end; classIndex++) {
+		int classIndices[CCube::Move::NumberOfMoves], symmetries[CCube::Move::NumberOfMoves];
+		bool isExpanded = false;
+		const int begin = classIndex * COrdinalCube::UpDownEdgePermutations;
+		const int end = begin + COrdinalCube::UpDownEdgePermutations;
+
+		for (int index = FindValue(begin, end, Empty); index < end; index = FindValue(index + 1, end, Empty)) {
+			int permutation = index - begin;
+
+			if (!isExpanded) {
+				GetMovedClasses(classIndex, classIndices, symmetries);
+				isExpanded = true;
+			}
+
+			for (int move = CCube::Move::U; move < CCube::Move::NumberOfMoves; move++) {
+				if (!CCube::IsPhase2Move(move)) continue;
+				int index2 = classIndices[move] * COrdinalCube::UpDownEdgePermutations
+					+ m_cornerPermutationSymmetryTable.ConjugateUpDownEdgePermutation(
+						m_upDownEdgePermutationMoveTable[permutation][move], symmetries[move]);
+
+				// 1つでも見つかれば残りの移動は調べない
+				if (GetValueAtomic(index2) == p_depth) {
+					if (SetValueIfEmpty(index, p_depth + 1)) {
+						numberOfNodes++;
+						numberOfNodes += SetSymmetricValues(index, p_depth + 1);
+					}
+					break;
+				}
+			}
+		}
+	}
+	return numberOfNodes;
+}
+
+// 代表元のCornerの順列にPhase 2の10種類の移動を行った後の同値類と対称変換を取得する
+// Edgeの順列によらないので，同値類ごとに1回だけ求める
+void CCornerAndUpDownPruningTable::GetMovedClasses(const int p_classIndex, int* p_classIndices, int* p_symmetries) const
+{
+	int representative = m_cornerPermutationSymmetryTable.GetRepresentative(p_classIndex);
+	for (int move = CCube::Move::U; move < CCube::Move::NumberOfMoves; move++) {
+		if (!CCube::IsPhase2Move(move)) continue;
+		int cornerPermutation = m_cornerPermutationMoveTable[representative][move];
+		p_classIndices[move] = m_cornerPermutationSymmetryTable.GetClassIndex(cornerPermutation);
+		p_symmetries[move] = m_cornerPermutationSymmetryTable.GetSymmetry(cornerPermutation);
+	}
+}
+
+// 代表元が対称な同値類では，代表元を保存する対称変換でEdgeの順列を移したIndexも同じ状態を表すので，
+// 同じdepthを格納する
+// 格納したIndexの数をreturnする
+int CCornerAndUpDownPruningTable::SetSymmetricValues(const int p_index, const unsigned int p_depth)
+{
+	int classIndex = p_index / COrdinalCube::UpDownEdgePermutations;
+	int permutation = p_index % COrdinalCube::UpDownEdgePermutations;
+	int stabilizer = m_cornerPermutationSymmetryTable.GetStabilizer(classIndex);
+	int numberOfNodes = 0;
+
+	// 恒等変換(0番)以外の対称変換
+	for (int symmetry = 1; symmetry < CSymmetry::NumberOfUpDownSymmetries; symmetry++) {
+		if (stabilizer & (1 << symmetry)) {
+			int index = classIndex * COrdinalCube::UpDownEdgePermutations
+				+ m_cornerPermutationSymmetryTable.ConjugateUpDownEdgePermutation(permutation, symmetry);
+			if (SetValueIfEmpty(index, p_depth)) {
+				numberOfNodes++;
+			}
+		}
+	}
+	return numberOfNodes;
+}
@@ -0,0 +1,59 @@
+﻿#ifndef	_CORNERPERMUTATIONPRUNINGTABLE_H_
+#define	_CORNERPERMUTATIONPRUNINGTABLE_H_
+
+#include "pruningtable.h"
+#include "submovetable.h"
+#include "cornerpermutationtable.h"
+
+// Cornerの順列の同値類とUp層・Down層のEdgeの順列を組み合わせたPhase 2のPruningTable
+// Index = 同値類の番号 * UpDownEdgePermutations + 代表元に移す対称変換で移したEdgeの順列
+// Middle層のEdgeの順列を考慮しないので，Phase 2の完成までの手数の下限になる
+class CCornerAndUpDownPruningTable : public CPruningTable
+{
+public:
+	CCornerAndUpDownPruningTable(
+		CCornerPermutationMoveTable& cornerPermutationMoveTable, CUpDownEdgePermutationMoveTable& upDownEdgePermutationMoveTable,
+		CCornerPermutationSymmetryTable& cornerPermutationSymmetryTable,
+		const int p_homeCornerPermutation, const int p_homeUpDownEdgePermutation,
+		const Encoding p_encoding = FourBitDepth
+		);
+
+	// Phase 2の序数からPruningTableのIndexを取得
+	int GetIndex(const int p_cornerPermutation, const int p_upDownEdgePermutation) const
+	{
+		return m_cornerPermutationSymmetryTable.GetClassIndex(p_cornerPermutation) * COrdinalCube::UpDownEdgePermutations
+			+ m_cornerPermutationSymmetryTable.ConjugateUpDownEdgePermutation(
+				p_upDownEdgePermutation, m_cornerPermutationSymmetryTable.GetSymmetry(p_cornerPermutation));
+	}
+
+protected:
+	// PruningTableを作成する
+	// 各同値類の代表元に対して移動を行い，移動後のCornerの順列を同値類と対称変換に変換する
+	void GeneratePruningTable();
+
+private:
+	// 1つのスレッドが一度に探索する同値類の数
+	enum { ChunkSize = 4 };
+
+	// 指定した範囲の同値類のうち，depthがp_depthのIndexから枝を伸ばす
+	int ExpandClasses(const int p_begin, const int p_end, const unsigned int p_depth);
+	// 指定した範囲の同値類のうち，空のIndexからdepthがp_depthのIndexを逆向きに探す
+	int ExpandClassesBackward(const int p_begin, const int p_end, const unsigned int p_depth);
+	// 代表元にPhase 2の移動を行った後の同値類と対称変換を取得する
+	void GetMovedClasses(const int p_classIndex, int* p_classIndices, int* p_symmetries) const;
+
+	// 代表元が対称な同値類で，同じ状態を表す他のIndexにもdepthを格納する
+	int SetSymmetricValues(const int p_index, const unsigned int p_depth);
+
+	// MoveTableへのReference
+	CCornerPermutationMoveTable& m_cornerPermutationMoveTable;
+	CUpDownEdgePermutationMoveTable& m_upDownEdgePermutationMoveTable;
+	// Cornerの順列の同値類のTableへのReference
+	CCornerPermutationSymmetryTable& m_cornerPermutationSymmetryTable;
+
+	// PruningTable作成の初期位置
+	int m_homeCornerPermutation;
+	int m_homeUpDownEdgePermutation;
+};
+
+#endif	// _CORNERPERMUTATIONPRUNINGTABLE_H_
@@ -0,0 +1,130 @@
+﻿#include "cornerpermutationtable.h"
+#include "../solverthread.h"
+
+CCornerPermutationSymmetryTable::CCornerPermutationSymmetryTable()
+	: m_tableFile(COrdinalCube::CornerPermutations, CornerPermutationClasses, 16, GetDataBytes())
+{
+	// TableはInitializeで確保(またはマップ)する
+	m_classIndices = NULL;
+	m_symmetries = NULL;
+	m_representatives = NULL;
+	m_stabilizers = NULL;
+	m_upDownEdgePermutationConjugates = NULL;
+}
+
+CCornerPermutationSymmetryTable::~CCornerPermutationSymmetryTable()
+{
+	// 各Tableはm_tableFileが解放する
+}
+
+// Tableのファイルをメモリマップする
+// ファイルが無いとき，ヘッダかチェックサムが一致しないときは作成する
+bool CCornerPermutationSymmetryTable::Initialize(const std::string p_fileName, const CTableBundle* p_bundle)
+{
+	// バンドルがあれば，バンドルの中のTableだけを使う(作成し直さない)
+	if (p_bundle) {
+		if (m_tableFile.Open(*p_bundle, p_fileName) != CTableFile::Loaded) {
+            emit notifySolverMessage("Invalid table in bundle: " + QString::fromStdString(p_fileName));
+			return false;
+		}
+		AttachTables(m_tableFile.GetData());
+		return true;
+	}
+
+	CTableFile::Status status = m_tableFile.Open(p_fileName);
+	if (status != CTableFile::Loaded) {
+		// 古い形式のファイルや壊れたファイルは作成し直す
+		if (status == CTableFile::Invalid) {
+            emit notifySolverMessage("Invalid table file: " + QString::fromStdString(p_fileName));
+		}
+        emit notifySolverMessage("Generating...");
+		AttachTables(m_tableFile.Allocate());
+		GenerateTables();
+        emit notifySolverMessage("Saving...");
+		if (!m_tableFile.Save(p_fileName)) {
+            emit notifySolverMessage("Failed to save " + QString::fromStdString(p_fileName));
+		}
+        emit notifySolverMessage("Done");
+	}
+	AttachTables(m_tableFile.GetData());
+	return true;
+}
+
+// 1つのファイルに全てのTableを並べたときのサイズ(byte)
+uint64_t CCornerPermutationSymmetryTable::GetDataBytes()
+{
+	return CornerPermutationClasses * sizeof(int)
+		+ COrdinalCube::CornerPermutations * sizeof(unsigned short)
+		+ CornerPermutationClasses * sizeof(unsigned short)
+		+ COrdinalCube::UpDownEdgePermutations * CSymmetry::NumberOfUpDownSymmetries * sizeof(unsigned short)
+		+ COrdinalCube::CornerPermutations * sizeof(unsigned char);
+}
+
+// ファイルのデータの各Tableの先頭アドレスを設定する
+// 要素のサイズが大きいTableから順に並べるので，各Tableの先頭は要素のサイズの境界に揃う
+void CCornerPermutationSymmetryTable::AttachTables(unsigned char* p_data)
+{
+	m_representatives = (int*)p_data;
+	p_data += CornerPermutationClasses * sizeof(int);
+	m_classIndices = (unsigned short*)p_data;
+	p_data += COrdinalCube::CornerPermutations * sizeof(unsigned short);
+	m_stabilizers = (unsigned short*)p_data;
+	p_data += CornerPermutationClasses * sizeof(unsigned short);
+	m_upDownEdgePermutationConjugates = (unsigned short (*)[CSymmetry::NumberOfUpDownSymmetries])p_data;
+	p_data += COrdinalCube::UpDownEdgePermutations * CSymmetry::NumberOfUpDownSymmetries * sizeof(unsigned short);
+	m_symmetries = p_data;
+}
+
+// Tableを作成する
+void CCornerPermutationSymmetryTable::GenerateTables()
+{
+	enum { Unassigned = 0xFFFF };
+	COrdinalCube cube;
+
+	CSymmetry::Initialize();
+
+	// Up層とDown層のEdgeの順列の対称変換
+	for (int permutation = 0; permutation < COrdinalCube::UpDownEdgePermutations; permutation++) {
+		for (int symmetry = 0; symmetry < CSymmetry::NumberOfUpDownSymmetries; symmetry++) {
+			cube.SetCleanCube();
+			cube.SetUpDownEdgePermutationFromOrdinal(permutation);
+			CSymmetry::Conjugate(symmetry, cube);
+			m_upDownEdgePermutationConjugates[permutation][symmetry] =
+				(unsigned short)cube.GetOrdinalFromUpDownEdgePermutation();
+		}
+	}
+
+	// Cornerの順列の同値類
+	// まだ分類されていない順列を新しい同値類の代表元とし，
+	// 代表元を16種類の対称変換で移した順列を同じ同値類に分類する
+	for (int permutation = 0; permutation < COrdinalCube::CornerPermutations; permutation++) {
+		m_classIndices[permutation] = Unassigned;
+	}
+
+	int classIndex = 0;
+	for (int permutation = 0; permutation < COrdinalCube::CornerPermutations; permutation++) {
+		if (m_classIndices[permutation] != Unassigned) {
+			continue;
+		}
+		m_representatives[classIndex] = permutation;
+		m_stabilizers[classIndex] = 0;
+
+		for (int symmetry = 0; symmetry < CSymmetry::NumberOfUpDownSymmetries; symmetry++) {
+			cube.SetCleanCube();
+			cube.SetCornerPermutationFromOrdinal(permutation);
+			CSymmetry::Conjugate(symmetry, cube);
+			int conjugate = cube.GetOrdinalFromCornerPermutation();
+			if (conjugate == permutation) {
+				m_stabilizers[classIndex] |= (1 << symmetry);
+			}
+
+			// 代表元自身が対称なときは，複数の対称変換で同じ順列に移るので，最初のものを使う
+			// (代表元に移す対称変換は恒等変換になる)
+			if (m_classIndices[conjugate] == Unassigned) {
+				m_classIndices[conjugate] = (unsigned short)classIndex;
+				m_symmetries[conjugate] = (unsigned char)CSymmetry::GetInverseSymmetry(symmetry);
+			}
+		}
+		classIndex++;
+	}
+}
@@ -0,0 +1,92 @@
+﻿#ifndef	_CORNERPERMUTATIONTABLE_H_
+#define	_CORNERPERMUTATIONTABLE_H_
+
+#include "ordinalcube.h"
+#include "symmetry.h"
+#include "tablefile.h"
+
+#include <string>
+#include <QObject>
+
+// Cornerの順列の序数を，U-D軸を保存する16種類の対称変換で同値類に分類するTable
+// http://kociemba.org/math/symmetric.htm
+// 8! = 40320通りのCornerの順列は2768個の同値類になる
+// 各Cornerの順列に対して，同値類の番号と，代表元に移す対称変換を保存する
+class CCornerPermutationSymmetryTable : public QObject
+{
+    Q_OBJECT
+signals:
+    void notifySolverMessage(QString p_message);
+
+public:
+	CCornerPermutationSymmetryTable();
+	~CCornerPermutationSymmetryTable();
+
+	enum
+	{
+		CornerPermutationClasses = 2768	// Cornerの順列の同値類の数
+	};
+
+	// Tableのファイルをメモリマップする
+	// ファイルが無いとき，ヘッダかチェックサムが一致しないときは作成して保存する
+	// p_bundleを指定したときはバンドルの中のTableを使い，見つからなければfalseを返す
+	bool Initialize(const std::string p_fileName, const CTableBundle* p_bundle = NULL);
+
+	// Cornerの順列が属する同値類の番号を取得する
+	int GetClassIndex(const int p_cornerPermutation) const
+	{
+		return m_classIndices[p_cornerPermutation];
+	}
+
+	// Cornerの順列を同値類の代表元に移す対称変換を取得する
+	// 代表元 = S * cornerPermutation * S^-1
+	int GetSymmetry(const int p_cornerPermutation) const
+	{
+		return m_symmetries[p_cornerPermutation];
+	}
+
+	// 同値類の代表元のCornerの順列を取得する
+	int GetRepresentative(const int p_classIndex) const
+	{
+		return m_representatives[p_classIndex];
+	}
+
+	// 同値類の代表元を自分自身に移す対称変換を取得する
+	// p_symmetry番目のビットが1なら，p_symmetryで代表元は変化しない(恒等変換は常に含まれる)
+	int GetStabilizer(const int p_classIndex) const
+	{
+		return m_stabilizers[p_classIndex];
+	}
+
+	// Up層とDown層のEdgeの順列を対称変換した順列を取得する (S * permutation * S^-1)
+	// U-D軸を保存する対称変換では，Up層とDown層のEdgeはUp層とDown層に移る
+	int ConjugateUpDownEdgePermutation(const int p_upDownEdgePermutation, const int p_symmetry) const
+	{
+		return m_upDownEdgePermutationConjugates[p_upDownEdgePermutation][p_symmetry];
+	}
+
+private:
+	// Tableを作成する
+	void GenerateTables();
+
+	// 1つのファイルに全てのTableを並べたときのサイズ(byte)
+	static uint64_t GetDataBytes();
+	// ファイルのデータの各Tableの先頭アドレスを設定する
+	void AttachTables(unsigned char* p_data);
+
+	// Cornerの順列の同値類の番号
+	unsigned short* m_classIndices;
+	// Cornerの順列を同値類の代表元に移す対称変換
+	unsigned char* m_symmetries;
+	// 同値類の代表元のCornerの順列
+	int* m_representatives;
+	// 同値類の代表元を自分自身に移す対称変換のビット列
+	unsigned short* m_stabilizers;
+	// Up層とDown層のEdgeの順列を対称変換した順列
+	unsigned short (*m_upDownEdgePermutationConjugates)[CSymmetry::NumberOfUpDownSymmetries];
+
+	// Tableのファイル
+	CTableFile m_tableFile;
+};
+
+#endif	// _CORNERPERMUTATIONTABLE_H_
@@ -55,30 +55,110 @@ void CCube::SetState(
 	}
 }
 
+// cubeの移動を行う
+// 移動をClean Cubeに行った状態(CubieMoves)との積を計算する
+// どの移動もCubieの置換1回と方向の加算だけで行い，180[deg]回転も90[deg]回転を2回行わない
 void CCube::ApplyMove(const int p_move)
 {
-	switch (p_move){
-	case CCube::U:	Move_U();	break;
-	case CCube::D:	Move_D();	break;
-	case CCube::L:	Move_L();	break;
-	case CCube::R:	Move_R();	break;
-	case CCube::F:	Move_F();	break;
-	case CCube::B:	Move_B();	break;
+	const SCubieMove& move = CubieMoves[p_move];
+	int cornerPermutation[NumberOfCornerSets];
+	int cornerOrientations[NumberOfCornerSets];
+	int edgePermutation[NumberOfEdgeSets];
+	int edgeOrientations[NumberOfEdgeSets];
+
+	for (int corner = FirstCornerSet; corner <= LastCornerSet; corner++) {
+		int from = move.cornerPermutation[corner];
+		int orientation = CornerSetOrientations[from] + move.cornerTwists[corner];
+		cornerPermutation[corner] = CornerSetPermutation[from];
+		cornerOrientations[corner] = (orientation >= NumberOfTwists) ? orientation - NumberOfTwists : orientation;
+	}
+	for (int edge = FirstEdgeSet; edge <= LastEdgeSet; edge++) {
+		int from = move.edgePermutation[edge];
+		edgePermutation[edge] = EdgeSetPermutation[from];
+		edgeOrientations[edge] = EdgeSetOrientations[from] ^ move.edgeFlips[edge];
+	}
+
+	std::memcpy(CornerSetPermutation, cornerPermutation, sizeof(cornerPermutation));
+	std::memcpy(CornerSetOrientations, cornerOrientations, sizeof(cornerOrientations));
+	std::memcpy(EdgeSetPermutation, edgePermutation, sizeof(edgePermutation));
+	std::memcpy(EdgeSetOrientations, edgeOrientations, sizeof(edgeOrientations));
+}
+
+// cubeの積を計算する (this = this * p_cube)
+// http://kociemba.org/math/cubielevel.htm
+// 積の位置iにあるCubieは，p_cubeが位置iに持ってくる位置(p_cube.Permutation[i])にあったthisのCubie
+// Orientationは，移動前のOrientationにp_cubeの位置iでの回転・反転を加えたもの
+// CornerのOrientationが3以上のものは鏡映された回転状態を表す(対称変換の鏡映で使用する)
+void CCube::Multiply(const CCube& p_cube)
+{
+	int cornerPermutation[NumberOfCornerSets];
+	int cornerOrientations[NumberOfCornerSets];
+	int edgePermutation[NumberOfEdgeSets];
+	int edgeOrientations[NumberOfEdgeSets];
+
+	for (int corner = FirstCornerSet; corner <= LastCornerSet; corner++) {
+		int from = p_cube.CornerSetPermutation[corner];
+		int orientationA = CornerSetOrientations[from];
+		int orientationB = p_cube.CornerSetOrientations[corner];
+		int orientation;
+
+		cornerPermutation[corner] = CornerSetPermutation[from];
+
+		if (orientationA < NumberOfTwists && orientationB < NumberOfTwists) {
+			// 回転どうし
+			orientation = (orientationA + orientationB) % NumberOfTwists;
+		}
+		else if (orientationA < NumberOfTwists) {
+			// 回転 * 鏡映 は鏡映
+			orientation = orientationA + orientationB;
+			if (orientation >= 2 * NumberOfTwists) orientation -= NumberOfTwists;
+		}
+		else if (orientationB < NumberOfTwists) {
+			// 鏡映 * 回転 は鏡映
+			orientation = orientationA - orientationB;
+			if (orientation < NumberOfTwists) orientation += NumberOfTwists;
+		}
+		else {
+			// 鏡映どうしは回転
+			orientation = orientationA - orientationB;
+			if (orientation < 0) orientation += NumberOfTwists;
+		}
+		cornerOrientations[corner] = orientation;
+	}
+
+	for (int edge = FirstEdgeSet; edge <= LastEdgeSet; edge++) {
+		int from = p_cube.EdgeSetPermutation[edge];
+		edgePermutation[edge] = EdgeSetPermutation[from];
+		edgeOrientations[edge] = EdgeSetOrientations[from] ^ p_cube.EdgeSetOrientations[edge];
+	}
 
-	case CCube::Ui:	Move_Ui();	break;
-	case CCube::Di:	Move_Di();	break;
-	case CCube::Li:	Move_Li();	break;
-	case CCube::Ri:	Move_Ri();	break;
-	case CCube::Fi:	Move_Fi();	break;
-	case CCube::Bi:	Move_Bi();	break;
+	SetState(cornerPermutation, cornerOrientations, edgePermutation, edgeOrientations);
+}
 
-	case CCube::U2:	Move_U2();	break;
-	case CCube::D2:	Move_D2();	break;
-	case CCube::L2:	Move_L2();	break;
-	case CCube::R2:	Move_R2();	break;
-	case CCube::F2:	Move_F2();	break;
-	case CCube::B2:	Move_B2();	break;
+// 逆元を計算する (this * inverse = clean cube)
+void CCube::Invert()
+{
+	int cornerPermutation[NumberOfCornerSets];
+	int cornerOrientations[NumberOfCornerSets];
+	int edgePermutation[NumberOfEdgeSets];
+	int edgeOrientations[NumberOfEdgeSets];
+
+	// 位置iにあるCubie cを，位置cに戻すと位置iのCubieになる
+	for (int corner = FirstCornerSet; corner <= LastCornerSet; corner++) {
+		int cubie = CornerSetPermutation[corner];
+		int orientation = CornerSetOrientations[corner];
+		cornerPermutation[cubie] = corner;
+		// 回転は逆回転に，鏡映はそのまま
+		cornerOrientations[cubie] = (orientation < NumberOfTwists) ?
+			(NumberOfTwists - orientation) % NumberOfTwists : orientation;
+	}
+	for (int edge = FirstEdgeSet; edge <= LastEdgeSet; edge++) {
+		int cubie = EdgeSetPermutation[edge];
+		edgePermutation[cubie] = edge;
+		edgeOrientations[cubie] = EdgeSetOrientations[edge];
 	}
+
+	SetState(cornerPermutation, cornerOrientations, edgePermutation, edgeOrientations);
 }
 
 // 移動記号の文字列から移動記号を取得する
@@ -108,200 +188,8 @@ void CCube::PrintCubeState() const
 	PrintVector(EdgeSetOrientations, NumberOfEdgeSets);
 }
 
-void CCube::Move_U()
-{
-	ShiftCorners(ULB, UBR, URF, UFL);
-	ShiftEdges(UB, UR, UF, UL);
-}
-void CCube::Move_D()
-{
-	ShiftCorners(DLF, DFR, DRB, DBL);
-	ShiftEdges(DF, DR, DB, DL);
-}
-void CCube::Move_L()
-{
-	ShiftCorners(ULB, UFL, DLF, DBL);
-
-	TwistCornerCw(ULB);
-	TwistCornerCcw(UFL);
-	TwistCornerCw(DLF);
-	TwistCornerCcw(DBL);
-
-	ShiftEdges(UL, FL, DL, LB);
-
-	FlipEdge(UL);	
-	FlipEdge(FL);	
-	FlipEdge(DL);	
-	FlipEdge(LB);
-}
-void CCube::Move_R()
-{
-	ShiftCorners(URF, UBR, DRB, DFR);
-
-	TwistCornerCw(URF);
-	TwistCornerCcw(UBR);
-	TwistCornerCw(DRB);
-	TwistCornerCcw(DFR);
-
-	ShiftEdges(UR, BR, DR, RF);
-
-	FlipEdge(UR);	
-	FlipEdge(BR);	
-	FlipEdge(DR);	
-	FlipEdge(RF);
-}
-void CCube::Move_F()
-{
-	ShiftCorners(UFL, URF, DFR, DLF);
-
-	TwistCornerCw(UFL);
-	TwistCornerCcw(URF);
-	TwistCornerCw(DFR);
-	TwistCornerCcw(DLF);
-
-	ShiftEdges(UF, RF, DF, FL);
-}
-void CCube::Move_B()
-{
-	ShiftCorners(UBR, ULB, DBL, DRB);
-
-	TwistCornerCw(UBR);
-	TwistCornerCcw(ULB);
-	TwistCornerCw(DBL);
-	TwistCornerCcw(DRB);
-
-	ShiftEdges(UB, LB, DB, BR);
-}
-
-void CCube::Move_Ui()
-{
-	ShiftCorners(UBR, ULB, UFL, URF);
-	ShiftEdges(UB, UL, UF, UR);
-}
-void CCube::Move_Di()
-{
-	ShiftCorners(DFR, DLF, DBL, DRB);
-	ShiftEdges(DF, DL, DB, DR);
-}
-void CCube::Move_Li()
-{
-	ShiftCorners(UFL, ULB, DBL, DLF);
-
-	TwistCornerCcw(UFL);
-	TwistCornerCw(ULB);
-	TwistCornerCcw(DBL);
-	TwistCornerCw(DLF);
-
-	ShiftEdges(UL, LB, DL, FL);
-
-	FlipEdge(UL);	
-	FlipEdge(LB);	
-	FlipEdge(DL);	
-	FlipEdge(FL);
-}
-void CCube::Move_Ri()
-{
-	ShiftCorners(UBR, URF, DFR, DRB);
-
-	TwistCornerCcw(UBR);
-	TwistCornerCw(URF);
-	TwistCornerCcw(DFR);
-	TwistCornerCw(DRB);
-
-	ShiftEdges(UR, RF, DR, BR);
-
-	FlipEdge(UR);	
-	FlipEdge(RF);	
-	FlipEdge(DR);	
-	FlipEdge(BR);
-}
-void CCube::Move_Fi()
-{
-	ShiftCorners(URF, UFL, DLF, DFR);
-
-	TwistCornerCcw(URF);
-	TwistCornerCw(UFL);
-	TwistCornerCcw(DLF);
-	TwistCornerCw(DFR);
-
-	ShiftEdges(UF, FL, DF, RF);
-}
-void CCube::Move_Bi()
-{
-	ShiftCorners(ULB, UBR, DRB, DBL);
-
-	TwistCornerCcw(ULB);
-	TwistCornerCw(UBR);
-	TwistCornerCcw(DRB);
-	TwistCornerCw(DBL);
-
-	ShiftEdges(UB, BR, DB, LB);
-}
-
-void CCube::Move_U2()
-{
-	Move_U(); Move_U();
-}
-void CCube::Move_D2()
-{
-	Move_D(); Move_D();
-}
-void CCube::Move_L2()
-{
-	Move_L(); Move_L();
-}
-void CCube::Move_R2()
-{
-	Move_R(); Move_R();
-}
-void CCube::Move_F2()
-{
-	Move_F(); Move_F();
-}
-void CCube::Move_B2()
-{
-	Move_B(); Move_B();
-}
-
-// 4か所のEdgeをシフトするようにPermutation,Orientationsを操作
-void CCube::ShiftEdges(const EdgeSet p_1, const EdgeSet p_2, const EdgeSet p_3, const EdgeSet p_4)
-{
-	ShiftVector(EdgeSetPermutation, p_1, p_2, p_3, p_4);
-	ShiftVector(EdgeSetOrientations, p_1, p_2, p_3, p_4);
-}
-// 4か所のCornerをシフトするようにPermutation,Orientationsを操作
-void CCube::ShiftCorners(const CornerSet p_1, const CornerSet p_2, const CornerSet p_3, const CornerSet p_4)
-{
-	ShiftVector(CornerSetPermutation, p_1, p_2, p_3, p_4);
-	ShiftVector(CornerSetOrientations, p_1, p_2, p_3, p_4);
-}
-// 4か所のEdge,Cornerを1つずつシフトする
-void CCube::ShiftVector(int* vector, const int p_1, const int p_2, const int p_3, const int p_4)
-{
-	int temp = vector[p_4];
-	vector[p_4] = vector[p_3];
-	vector[p_3] = vector[p_2];
-	vector[p_2] = vector[p_1];
-	vector[p_1] = temp;
-}
-
-// EdgeSetの位置のEdgeを反転する
-void CCube::FlipEdge(const EdgeSet p_edge)
-{
-	// EX-ORを計算することで反転する
-	EdgeSetOrientations[p_edge] ^= 1;
-}
-
-// CornerSetの位置のCornerを時計回りに回す
-void CCube::TwistCornerCw(const CornerSet p_corner)
-{
-	CornerSetOrientations[p_corner] = ClockwiseTwists[CornerSetOrientations[p_corner]];
-}
-// CornerSetの位置のCornerを反時計回りに回す
-void CCube::TwistCornerCcw(const CornerSet p_corner)
-{
-	CornerSetOrientations[p_corner] = CounterClockwiseTwists[CornerSetOrientations[p_corner]];
-}
+// 時計回り90[deg]の移動の定義(値はクラス内で初期化する)
+constexpr CCube::SQuarterTurn CCube::QuarterTurns[NumberOfClockwiseQuarterTurnMoves];
 
 // 反対の動き(ex:R -> Ri, B2 -> B2)
 const CCube::Move CCube::InverseMoves[NumberOfMoves] =
@@ -325,14 +213,51 @@ const std::string CCube::MoveNames[NumberOfMoves] =
 	"U2", "D2", "L2", "R2", "F2", "B2"
 };
 
-// Cornerを時計回りに回すTable
-const int CCube::ClockwiseTwists[NumberOfTwists] =
+
+namespace
 {
-	Clockwise, CounterClockwise, NoTwist
-};
+	// 4か所の要素を p[0] -> p[1] -> p[2] -> p[3] -> p[0] の位置にシフトする
+	constexpr void ShiftVector(int* vector, const int* p_positions)
+	{
+		int temp = vector[p_positions[3]];
+		vector[p_positions[3]] = vector[p_positions[2]];
+		vector[p_positions[2]] = vector[p_positions[1]];
+		vector[p_positions[1]] = vector[p_positions[0]];
+		vector[p_positions[0]] = temp;
+	}
+
+	// Clean Cubeに移動を行った状態を求める
+	// 時計回り90[deg]の移動(QuarterTurns)を，反時計回りは3回，180[deg]は2回行う
+	constexpr CCube::SCubieMove MakeCubieMove(const int p_move)
+	{
+		CCube::SCubieMove cube = {};
+		for (int corner = CCube::FirstCornerSet; corner <= CCube::LastCornerSet; corner++) {
+			cube.cornerPermutation[corner] = corner;
+		}
+		for (int edge = CCube::FirstEdgeSet; edge <= CCube::LastEdgeSet; edge++) {
+			cube.edgePermutation[edge] = edge;
+		}
+
+		const CCube::SQuarterTurn& turn = CCube::QuarterTurns[p_move % CCube::NumberOfClockwiseQuarterTurnMoves];
+		const int power = (p_move < CCube::Ui) ? 1 : (p_move < CCube::U2) ? 3 : 2;
+		for (int i = 0; i < power; i++) {
+			ShiftVector(cube.cornerPermutation, turn.corners);
+			ShiftVector(cube.cornerTwists, turn.corners);
+			ShiftVector(cube.edgePermutation, turn.edges);
+			ShiftVector(cube.edgeFlips, turn.edges);
+			for (int j = 0; j < 4; j++) {
+				cube.cornerTwists[turn.corners[j]] = (cube.cornerTwists[turn.corners[j]] + turn.cornerTwists[j]) % CCube::NumberOfTwists;
+				cube.edgeFlips[turn.edges[j]] ^= turn.edgeFlips[j];
+			}
+		}
+		return cube;
+	}
+}
 
-// Cornerを反時計回りに回すTable
-const int CCube::CounterClockwiseTwists[NumberOfTwists] =
+// 18種類の移動をClean Cubeに行った状態(コンパイル時に作成する)
+const CCube::SCubieMove CCube::CubieMoves[NumberOfMoves] =
 {
-	CounterClockwise, NoTwist, Clockwise
+	MakeCubieMove(U), MakeCubieMove(D), MakeCubieMove(L), MakeCubieMove(R), MakeCubieMove(F), MakeCubieMove(B),
+	MakeCubieMove(Ui), MakeCubieMove(Di), MakeCubieMove(Li), MakeCubieMove(Ri), MakeCubieMove(Fi), MakeCubieMove(Bi),
+	MakeCubieMove(U2), MakeCubieMove(D2), MakeCubieMove(L2), MakeCubieMove(R2), MakeCubieMove(F2), MakeCubieMove(B2)
 };
@@ -75,6 +75,53 @@ public:
 		NumberOfMoves = 18
 	};
 
+	// 時計回り90[deg]の移動(U, D, L, R, F, B)の定義
+	// corners[0] -> corners[1] -> corners[2] -> corners[3] -> corners[0] の位置にCornerをシフトした後，
+	// 各位置のCornerをcornerTwists(NoTwist, Clockwise, CounterClockwise)だけ回す
+	// Edgeも同様にシフトした後，edgeFlipsが1の位置のEdgeを反転する
+	// Move_U ~ Move_Bと同じ操作で，コンパイル時にMoveTableを作成するときに使用する
+	struct SQuarterTurn
+	{
+		int corners[4];
+		int cornerTwists[4];
+		int edges[4];
+		int edgeFlips[4];
+	};
+	static constexpr SQuarterTurn QuarterTurns[NumberOfClockwiseQuarterTurnMoves] =
+	{
+		// U
+		{ { ULB, UBR, URF, UFL }, { NoTwist, NoTwist, NoTwist, NoTwist },
+		  { UB, UR, UF, UL }, { NotFlipped, NotFlipped, NotFlipped, NotFlipped } },
+		// D
+		{ { DLF, DFR, DRB, DBL }, { NoTwist, NoTwist, NoTwist, NoTwist },
+		  { DF, DR, DB, DL }, { NotFlipped, NotFlipped, NotFlipped, NotFlipped } },
+		// L
+		{ { ULB, UFL, DLF, DBL }, { Clockwise, CounterClockwise, Clockwise, CounterClockwise },
+		  { UL, FL, DL, LB }, { Flipped, Flipped, Flipped, Flipped } },
+		// R
+		{ { URF, UBR, DRB, DFR }, { Clockwise, CounterClockwise, Clockwise, CounterClockwise },
+		  { UR, BR, DR, RF }, { Flipped, Flipped, Flipped, Flipped } },
+		// F
+		{ { UFL, URF, DFR, DLF }, { Clockwise, CounterClockwise, Clockwise, CounterClockwise },
+		  { UF, RF, DF, FL }, { NotFlipped, NotFlipped, NotFlipped, NotFlipped } },
+		// B
+		{ { UBR, ULB, DBL, DRB }, { Clockwise, CounterClockwise, Clockwise, CounterClockwise },
+		  { UB, LB, DB, BR }, { NotFlipped, NotFlipped, NotFlipped, NotFlipped } }
+	};
+
+	// 18種類の移動をClean Cubeに行った状態(QuarterTurnsから作成する)
+	// 移動後の位置iには，移動前の位置cornerPermutation[i]にあったCornerが来て，cornerTwists[i]だけ回る
+	// Edgeも同様に，移動前の位置edgePermutation[i]にあったEdgeが来て，edgeFlipsが1なら反転する
+	// 全ての移動(90[deg], -90[deg], 180[deg])を，同じ1回の置換と方向の加算で行うために使用する
+	struct SCubieMove
+	{
+		int cornerPermutation[NumberOfCornerSets];
+		int cornerTwists[NumberOfCornerSets];
+		int edgePermutation[NumberOfEdgeSets];
+		int edgeFlips[NumberOfEdgeSets];
+	};
+	static const SCubieMove CubieMoves[NumberOfMoves];
+
 	// 同じ状態かを判別する演算子
 	bool operator==(const CCube& cube) const;
 	bool operator!=(const CCube& cube) const;
@@ -90,6 +137,15 @@ public:
 	// cubeの移動を行う
 	virtual void ApplyMove(const int p_move);
 
+	// cubeの積を計算する (this = this * p_cube)
+	// thisの状態に対してp_cubeの置換を作用させる
+	// p_cubeがclean cubeに移動を行ったものであれば，ApplyMoveと同じ結果になる
+	// 鏡映を含む対称変換を扱うため，CornerのOrientationが3以上(鏡映された回転状態)の場合にも対応する
+	void Multiply(const CCube& p_cube);
+
+	// 逆元を計算する (this * inverse = clean cube)
+	void Invert();
+
 	// moveの反対方向の移動を取得する
 	inline static int const GetInverseOfMove(const int p_move)
 	{
@@ -102,6 +158,18 @@ public:
 		return (U2 + p_move % (B + 1));
 	}
 
+	// 面と反復回数から移動記号を取得する (ex. (R, 1) -> R, (R, 2) -> R2, (R, 3) -> Ri)
+	static constexpr int GetMoveOfPower(const int p_face, const int p_power)
+	{
+		return p_face + ((p_power == 1) ? U : (p_power == 2) ? U2 : Ui);
+	}
+
+	// Phase 2の群<U,D,R2,L2,F2,B2>に含まれる移動かを判別する
+	static constexpr bool IsPhase2Move(const int p_move)
+	{
+		return p_move >= U2 || p_move == U || p_move == D || p_move == Ui || p_move == Di;
+	}
+
 	// 反対のFaceを取得する
 	inline static int const GetOpposingFace(const int p_move)
 	{
@@ -121,44 +189,13 @@ public:
 	// Cubeの状態を出力する
 	virtual void PrintCubeState() const;
 
-protected:
-	// 移動関数(時計回り90[deg])
-	void Move_U();
-	void Move_D();
-	void Move_L();
-	void Move_R();
-	void Move_F();
-	void Move_B();
-	// 移動関数(反時計回り90[deg])
-	void Move_Ui();
-	void Move_Di();
-	void Move_Li();
-	void Move_Ri();
-	void Move_Fi();
-	void Move_Bi();
-	// 移動関数(180[deg])
-	void Move_U2();
-	void Move_D2();
-	void Move_L2();
-	void Move_R2();
-	void Move_F2();
-	void Move_B2();
-
-	// 4か所のEdgeをシフトするようにPermutation,Orientationsを操作
-	void ShiftEdges(const EdgeSet p_1, const EdgeSet p_2, const EdgeSet p_3, const EdgeSet p_4);
-	// 4か所のCornerをシフトするようにPermutation,Orientationsを操作
-	void ShiftCorners(const CornerSet p_1, const CornerSet p_2, const CornerSet p_3, const CornerSet p_4);
-	// 4か所のEdge,Cornerを1つずつシフトする
-	void ShiftVector(int* vector, const int p_1, const int p_2, const int p_3, const int p_4);
-	
-	// EdgeSetの位置のEdgeを反転する
-	void FlipEdge(const EdgeSet p_edge);
-
-	// CornerSetの位置のCornerを時計回りに回す
-	void TwistCornerCw(const CornerSet p_corner);
-	// CornerSetの位置のCornerを反時計回りに回す
-	void TwistCornerCcw(const CornerSet p_corner);
+	// PermutationとOrientationを取得する
+	const int* GetCornerPermutation() const { return CornerSetPermutation; }
+	const int* GetCornerOrientations() const { return CornerSetOrientations; }
+	const int* GetEdgePermutation() const { return EdgeSetPermutation; }
+	const int* GetEdgeOrientations() const { return EdgeSetOrientations; }
 
+protected:
 	// Clean Cubeにおけるcornerの位置にあるCornerを格納する
 	// http://kociemba.org/math/coordlevel.htm
 	int CornerSetPermutation[NumberOfCornerSets];
@@ -182,12 +219,6 @@ private:
 	static const Move OppositeFaces[NumberOfMoves / 3];
 	// 移動記号の文字列
 	static const std::string MoveNames[NumberOfMoves];
-	// Cornerを時計回りに回すTable
-	static const int ClockwiseTwists[NumberOfTwists];
-	// Cornerを反時計回りに回すTable
-	static const int CounterClockwiseTwists[NumberOfTwists];
-
-
 };
 
 #endif	// _CUBE_H_
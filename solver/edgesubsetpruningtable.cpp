@@ -0,0 +1,111 @@
+﻿#include "edgesubsetpruningtable.h"
+#include "../solverthread.h"
+
+CEdgeSubsetPruningTable::CEdgeSubsetPruningTable(CEdgeSubsetMoveTable& edgeSubsetMoveTable, const int p_homeIndex) :
+	CPruningTable(COrdinalCube::EdgeSubsetPositions * COrdinalCube::EdgeSubsetOrientations),
+	m_edgeSubsetMoveTable(edgeSubsetMoveTable),
+	m_homeIndex(p_homeIndex)
+{
+}
+
+// PruningTableを作成する
+void CEdgeSubsetPruningTable::GeneratePruningTable()
+{
+	unsigned int depth = 0;
+	int numberOfNodes;
+	int numberOfNodesAtDepth;
+
+	Clear();	// Empty = 0x0F
+
+	// 探索木のスタート地点を設定する
+	SetValue(m_homeIndex, depth);
+	numberOfNodes = numberOfNodesAtDepth = 1;	// ノードの数
+
+	// テーブルサイズいっぱいまで繰り返す
+	while (numberOfNodes < GetSize()) {
+		// 複数のスレッドで分担して探索する
+		// 空のIndexの方が少なくなったら，空のIndexから逆向きに探索する
+		const bool isBackward = IsBackwardSearchEfficient(numberOfNodesAtDepth, numberOfNodes);
+		numberOfNodesAtDepth = ParallelFor(COrdinalCube::EdgeSubsetPositions, ChunkSize, [&](const int p_begin, const int p_end) {
+			return isBackward ? ExpandPositionsBackward(p_begin, p_end, depth) : ExpandPositions(p_begin, p_end, depth);
+		});
+		numberOfNodes += numberOfNodesAtDepth;
+		// 探索が終了したらdepthを深くする
+		depth++;
+		NotifyDepthCompleted(depth, numberOfNodes);
+	}
+}
+
+// [p_begin, p_end)の位置のうち，depthがp_depthのIndexから枝を伸ばす
+// 新たに格納したIndexの数をreturnする
+int CEdgeSubsetPruningTable::ExpandPositions(const int p_begin, const int p_end, const unsigned int p_depth)
+{
+	const int begin = p_begin * COrdinalCube::EdgeSubsetOrientations;
+	const int end = p_end * COrdinalCube::EdgeSubsetOrientations;
+	// 18種類の移動を行った後の位置と反転したEdge
+	// Orientationによらないので，位置ごとに1回だけ求める
+	int movedIndices[CCube::Move::NumberOfMoves];
+	int expandedPosition = -1;
+	int numberOfNodes = 0;
+
+	// 現在のdepthと一致したら，そこから枝を伸ばす
+	for (int index = FindValue(begin, end, p_depth); index < end; index = FindValue(index + 1, end, p_depth)) {
+		int orientation = index & (COrdinalCube::EdgeSubsetOrientations - 1);
+
+		if ((index >> COrdinalCube::EdgeSubsetSize) != expandedPosition) {
+			expandedPosition = index >> COrdinalCube::EdgeSubsetSize;
+			GetMovedIndices(expandedPosition, movedIndices);
+		}
+
+		for (int move = CCube::Move::U; move < CCube::Move::NumberOfMoves; move++) {
+			int index2 = movedIndices[move] ^ orientation;
+
+			// 既にindex2の場所に状態が設定されていたら飛ばす
+			if (SetValueIfEmpty(index2, p_depth + 1)) {
+				numberOfNodes++;
+			}
+		}
+	}
+	return numberOfNodes;
+}
+
+// [p_begin, p_end)の位置のうち，空のIndexから逆向きに枝を伸ばし，
+// depthがp_depthのIndexに隣接していればp_depth + 1を格納する
+// 新たに格納したIndexの数をreturnする
+int CEdgeSubsetPruningTable::ExpandPositionsBackward(const int p_begin, const int p_end, const unsigned int p_depth)
+{
+	const int begin = p_begin * COrdinalCube::EdgeSubsetOrientations;
+	const int end = p_end * COrdinalCube::EdgeSubsetOrientations;
+	int movedIndices[CCube::Move::NumberOfMoves];
+	int expandedPosition = -1;
+	int numberOfNodes = 0;
+
+	for (int index = FindValue(begin, end, Empty); index < end; index = FindValue(index + 1, end, Empty)) {
+		int orientation = index & (COrdinalCube::EdgeSubsetOrientations - 1);
+
+		if ((index >> COrdinalCube::EdgeSubsetSize) != expandedPosition) {
+			expandedPosition = index >> COrdinalCube::EdgeSubsetSize;
+			GetMovedIndices(expandedPosition, movedIndices);
+		}
+
+		for (int move = CCube::Move::U; move < CCube::Move::NumberOfMoves; move++) {
+			// 1つでも見つかれば残りの移動は調べない
+			if (GetValueAtomic(movedIndices[move] ^ orientation) == p_depth) {
+				if (SetValueIfEmpty(index, p_depth + 1)) {
+					numberOfNodes++;
+				}
+				break;
+			}
+		}
+	}
+	return numberOfNodes;
+}
+
+// 位置に18種類の移動を行った後のIndex(Orientationが0のとき)を取得する
+void CEdgeSubsetPruningTable::GetMovedIndices(const int p_position, int* p_movedIndices) const
+{
+	for (int move = CCube::Move::U; move < CCube::Move::NumberOfMoves; move++) {
+		p_movedIndices[move] = ApplyMove(m_edgeSubsetMoveTable,
+			p_position * COrdinalCube::EdgeSubsetOrientations, move);
+	}
+}
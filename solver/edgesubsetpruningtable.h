@@ -0,0 +1,46 @@
+﻿#ifndef	_EDGESUBSETPRUNINGTABLE_H_
+#define	_EDGESUBSETPRUNINGTABLE_H_
+
+#include "pruningtable.h"
+#include "ordinalcube.h"
+#include "submovetable.h"
+
+// 6個のEdgeの位置とOrientationのPruningTable(最適解探索のパターンデータベース)
+// Index = 位置の序数 * EdgeSubsetOrientations + Orientation
+// CEdgeSubsetMoveTableの値と同じ形式なので，移動後のIndexは
+//   moveTable[index >> 6][move] ^ (index & 63)
+// で求められる(移動で反転したEdgeのビットとOrientationの排他的論理和)
+class CEdgeSubsetPruningTable : public CPruningTable
+{
+public:
+	CEdgeSubsetPruningTable(CEdgeSubsetMoveTable& edgeSubsetMoveTable, const int p_homeIndex);
+
+	// Indexに移動を行った後のIndexを取得する
+	static int ApplyMove(CEdgeSubsetMoveTable& edgeSubsetMoveTable, const int p_index, const int p_move)
+	{
+		return edgeSubsetMoveTable[p_index >> COrdinalCube::EdgeSubsetSize][p_move]
+			^ (p_index & (COrdinalCube::EdgeSubsetOrientations - 1));
+	}
+
+protected:
+	// PruningTableを作成する
+	void GeneratePruningTable();
+
+private:
+	// 1つのスレッドが一度に探索する位置の数
+	enum { ChunkSize = 1024 };
+
+	// 指定した範囲の位置のうち，depthがp_depthのIndexから枝を伸ばす
+	int ExpandPositions(const int p_begin, const int p_end, const unsigned int p_depth);
+	// 指定した範囲の位置のうち，空のIndexからdepthがp_depthのIndexを逆向きに探す
+	int ExpandPositionsBackward(const int p_begin, const int p_end, const unsigned int p_depth);
+	// 位置に18種類の移動を行った後のIndexを取得する
+	void GetMovedIndices(const int p_position, int* p_movedIndices) const;
+
+	// MoveTableへのReference
+	CEdgeSubsetMoveTable& m_edgeSubsetMoveTable;
+	// PruningTable作成の初期位置
+	int m_homeIndex;
+};
+
+#endif	// _EDGESUBSETPRUNINGTABLE_H_
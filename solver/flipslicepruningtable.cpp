@@ -0,0 +1,162 @@
+﻿#include "flipslicepruningtable.h"
+#include "../solverthread.h"
+
+CTwistAndFlipSlicePruningTable::CTwistAndFlipSlicePruningTable(
+	CTwistMoveTable& twistMoveTable, CFlipMoveTable& flipMoveTable, CChoiceMoveTable& choiceMoveTable,
+	CFlipSliceSymmetryTable& flipSliceSymmetryTable,
+	const int p_homeTwist, const int p_homeFlip, const int p_homeChoice, const Encoding p_encoding) :
+	CPruningTable(CFlipSliceSymmetryTable::FlipSliceClasses * COrdinalCube::Twists, p_encoding),
+	m_twistMoveTable(twistMoveTable),
+	m_flipMoveTable(flipMoveTable),
+	m_choiceMoveTable(choiceMoveTable),
+	m_flipSliceSymmetryTable(flipSliceSymmetryTable),
+	m_homeTwist(p_homeTwist),
+	m_homeFlip(p_homeFlip),
+	m_homeChoice(p_homeChoice)
+{
+}
+
+// PruningTableを作成する
+void CTwistAndFlipSlicePruningTable::GeneratePruningTable()
+{
+	unsigned int depth = 0;
+	int numberOfNodes;
+	int numberOfNodesAtDepth;
+
+	Clear();	// Empty = 0x0F
+
+	// 探索木のスタート地点を設定する
+	SetValue(GetIndex(m_homeTwist, m_homeFlip, m_homeChoice), depth);
+	numberOfNodes = 1;	// ノードの数
+	numberOfNodes += SetSymmetricValues(GetIndex(m_homeTwist, m_homeFlip, m_homeChoice), depth);
+	numberOfNodesAtDepth = numberOfNodes;
+
+	// テーブルサイズいっぱいまで繰り返す
+	while (numberOfNodes < GetSize()) {
+		// 複数のスレッドで分担して探索する
+		// 空のIndexの方が少なくなったら，空のIndexから逆向きに探索する
+		const bool isBackward = IsBackwardSearchEfficient(numberOfNodesAtDepth, numberOfNodes);
+		numberOfNodesAtDepth = ParallelFor(CFlipSliceSymmetryTable::FlipSliceClasses, ChunkSize, [&](const int p_begin, const int p_end) {
+			return isBackward ? ExpandClassesBackward(p_begin, p_end, depth) : ExpandClasses(p_begin, p_end, depth);
+		});
+		numberOfNodes += numberOfNodesAtDepth;
+		// 探索が終了したらdepthを深くする
+		depth++;
+		NotifyDepthCompleted(depth, numberOfNodes);
+	}
+}
+
+// [p_begin, p_end)の同値類のうち，depthがp_depthのIndexから枝を伸ばす
+// 新たに格納したIndexの数をreturnする
+int CTwistAndFlipSlicePruningTable::ExpandClasses(const int p_begin, const int p_end, const unsigned int p_depth)
+{
+	int numberOfNodes = 0;
+
+	for (int classIndex = p_begin; classIndex < p_end; classIndex++) {
+		// 代表元のflipsliceに18種類の移動を行った後の同値類と対称変換
+		// twistによらないので，同値類ごとに1回だけ求める
+		int classIndices[CCube::Move::NumberOfMoves], symmetries[CCube::Move::NumberOfMoves];
+		bool isExpanded = false;
+		const int begin = classIndex * COrdinalCube::Twists;
+		const int end = begin + COrdinalCube::Twists;
+
+		// 現在のdepthと一致したら，そこから枝を伸ばす
+		for (int index = FindValue(begin, end, p_depth); index < end; index = FindValue(index + 1, end, p_depth)) {
+			int twist = index - begin;
+
+			if (!isExpanded) {
+				GetMovedClasses(classIndex, classIndices, symmetries);
+				isExpanded = true;
+			}
+
+			// 代表元は対称変換が恒等変換なので，twistはそのまま使える
+			for (int move = CCube::Move::U; move < CCube::Move::NumberOfMoves; move++) {
+				int index2 = classIndices[move] * COrdinalCube::Twists
+					+ m_flipSliceSymmetryTable.ConjugateTwist(m_twistMoveTable[twist][move], symmetries[move]);
+
+				// 既にindex2の場所に状態が設定されていたら飛ばす
+				if (SetValueIfEmpty(index2, p_depth + 1)) {
+					numberOfNodes++;
+					numberOfNodes += SetSymmetricValues(index2, p_depth + 1);
+				}
+			}
+		}
+	}
+	return numberOfNodes;
+}
+
+// [p_begin, p_end)の同値類のうち，空のIndexから逆向きに枝を伸ばし，
+// depthがp_depthのIndexに隣接していればp_depth + 1を格納する
+// 新たに格納したIndexの数をreturnする
+int CTwistAndFlipSlicePruningTable::ExpandClassesBackward(const int p_begin, const int p_end, const unsigned int p_depth)
+{
+	int numberOfNodes = 0;
+
+	for (int classIndex = p_begin; classIndex < p_end; classIndex++) {
+		int classIndices[CCube::Move::NumberOfMoves], symmetries[CCube::Move::NumberOfMoves];
+		bool isExpanded = false;
+		const int begin = classIndex * COrdinalCube::Twists;
+		const int end = begin + COrdinalCube::Twists;
+
+		for (int index = FindValue(begin, end, Empty); index < end; index = FindValue(index + 1, end, Empty)) {
+			int twist = index - begin;
+
+			if (!isExpanded) {
+				GetMovedClasses(classIndex, classIndices, symmetries);
+				isExpanded = true;
+			}
+
+			for (int move = CCube::Move::U; move < CCube::Move::NumberOfMoves; move++) {
+				int index2 = classIndices[move] * COrdinalCube::Twists
+					+ m_flipSliceSymmetryTable.ConjugateTwist(m_twistMoveTable[twist][move], symmetries[move]);
+
+				// 1つでも見つかれば残りの移動は調べない
+				if (GetValueAtomic(index2) == p_depth) {
+					if (SetValueIfEmpty(index, p_depth + 1)) {
+						numberOfNodes++;
+						numberOfNodes += SetSymmetricValues(index, p_depth + 1);
+					}
+					break;
+				}
+			}
+		}
+	}
+	return numberOfNodes;
+}
+
+// 代表元のflipsliceに18種類の移動を行った後の同値類と対称変換を取得する
+// twistによらないので，同値類ごとに1回だけ求める
+void CTwistAndFlipSlicePruningTable::GetMovedClasses(const int p_classIndex, int* p_classIndices, int* p_symmetries) const
+{
+	int representative = m_flipSliceSymmetryTable.GetRepresentative(p_classIndex);
+	int flip = representative % COrdinalCube::Flips;
+	int choice = representative / COrdinalCube::Flips;
+	for (int move = CCube::Move::U; move < CCube::Move::NumberOfMoves; move++) {
+		int flipSlice = CFlipSliceSymmetryTable::GetFlipSlice(
+			m_flipMoveTable[flip][move], m_choiceMoveTable[choice][move]);
+		p_classIndices[move] = m_flipSliceSymmetryTable.GetClassIndex(flipSlice);
+		p_symmetries[move] = m_flipSliceSymmetryTable.GetSymmetry(flipSlice);
+	}
+}
+
+// 代表元が対称な同値類では，代表元を保存する対称変換でtwistを移したIndexも同じ状態を表すので，
+// 同じdepthを格納する
+// 格納したIndexの数をreturnする
+int CTwistAndFlipSlicePruningTable::SetSymmetricValues(const int p_index, const unsigned int p_depth)
+{
+	int classIndex = p_index / COrdinalCube::Twists;
+	int twist = p_index % COrdinalCube::Twists;
+	int stabilizer = m_flipSliceSymmetryTable.GetStabilizer(classIndex);
+	int numberOfNodes = 0;
+
+	// 恒等変換(0番)以外の対称変換
+	for (int symmetry = 1; symmetry < CSymmetry::NumberOfUpDownSymmetries; symmetry++) {
+		if (stabilizer & (1 << symmetry)) {
+			int index = classIndex * COrdinalCube::Twists + m_flipSliceSymmetryTable.ConjugateTwist(twist, symmetry);
+			if (SetValueIfEmpty(index, p_depth)) {
+				numberOfNodes++;
+			}
+		}
+	}
+	return numberOfNodes;
+}
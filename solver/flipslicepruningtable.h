@@ -0,0 +1,61 @@
+﻿#ifndef	_FLIPSLICEPRUNINGTABLE_H_
+#define	_FLIPSLICEPRUNINGTABLE_H_
+
+#include "pruningtable.h"
+#include "submovetable.h"
+#include "flipslicetable.h"
+
+// twistとflipsliceの同値類を組み合わせたPruningTable
+// Index = 同値類の番号 * Twists + 代表元に移す対称変換で移したtwist
+// (twist, flip, choice)はPhase 1の状態そのものなので，Phase 1の完成までの正確な手数が得られる
+class CTwistAndFlipSlicePruningTable : public CPruningTable
+{
+public:
+	CTwistAndFlipSlicePruningTable(
+		CTwistMoveTable& twistMoveTable, CFlipMoveTable& flipMoveTable, CChoiceMoveTable& choiceMoveTable,
+		CFlipSliceSymmetryTable& flipSliceSymmetryTable,
+		const int p_homeTwist, const int p_homeFlip, const int p_homeChoice,
+		const Encoding p_encoding = FourBitDepth
+		);
+
+	// Phase 1の序数からPruningTableのIndexを取得
+	int GetIndex(const int p_twist, const int p_flip, const int p_choice) const
+	{
+		int flipSlice = CFlipSliceSymmetryTable::GetFlipSlice(p_flip, p_choice);
+		return m_flipSliceSymmetryTable.GetClassIndex(flipSlice) * COrdinalCube::Twists
+			+ m_flipSliceSymmetryTable.ConjugateTwist(p_twist, m_flipSliceSymmetryTable.GetSymmetry(flipSlice));
+	}
+
+protected:
+	// PruningTableを作成する
+	// 各同値類の代表元に対して移動を行い，移動後のflipsliceを同値類と対称変換に変換する
+	void GeneratePruningTable();
+
+private:
+	// 1つのスレッドが一度に探索する同値類の数
+	enum { ChunkSize = 64 };
+
+	// 指定した範囲の同値類のうち，depthがp_depthのIndexから枝を伸ばす
+	int ExpandClasses(const int p_begin, const int p_end, const unsigned int p_depth);
+	// 指定した範囲の同値類のうち，空のIndexからdepthがp_depthのIndexを逆向きに探す
+	int ExpandClassesBackward(const int p_begin, const int p_end, const unsigned int p_depth);
+	// 代表元に18種類の移動を行った後の同値類と対称変換を取得する
+	void GetMovedClasses(const int p_classIndex, int* p_classIndices, int* p_symmetries) const;
+
+	// 代表元が対称な同値類で，同じ状態を表す他のIndexにもdepthを格納する
+	int SetSymmetricValues(const int p_index, const unsigned int p_depth);
+
+	// MoveTableへのReference
+	CTwistMoveTable& m_twistMoveTable;
+	CFlipMoveTable& m_flipMoveTable;
+	CChoiceMoveTable& m_choiceMoveTable;
+	// flipsliceの同値類のTableへのReference
+	CFlipSliceSymmetryTable& m_flipSliceSymmetryTable;
+
+	// PruningTable作成の初期位置
+	int m_homeTwist;
+	int m_homeFlip;
+	int m_homeChoice;
+};
+
+#endif	// _FLIPSLICEPRUNINGTABLE_H_
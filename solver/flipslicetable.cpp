@@ -0,0 +1,147 @@
+﻿#include "flipslicetable.h"
+#include "../solverthread.h"
+
+CFlipSliceSymmetryTable::CFlipSliceSymmetryTable()
+	: m_tableFile(FlipSlices, FlipSliceClasses, 16, GetDataBytes())
+{
+	// TableはInitializeで確保(またはマップ)する
+	m_classIndices = NULL;
+	m_symmetries = NULL;
+	m_representatives = NULL;
+	m_stabilizers = NULL;
+	m_twistConjugates = NULL;
+}
+
+CFlipSliceSymmetryTable::~CFlipSliceSymmetryTable()
+{
+	// 各Tableはm_tableFileが解放する
+}
+
+// Tableのファイルをメモリマップする
+// ファイルが無いとき，ヘッダかチェックサムが一致しないときは作成する
+bool CFlipSliceSymmetryTable::Initialize(const std::string p_fileName, const CTableBundle* p_bundle)
+{
+	// バンドルがあれば，バンドルの中のTableだけを使う(作成し直さない)
+	if (p_bundle) {
+		if (m_tableFile.Open(*p_bundle, p_fileName) != CTableFile::Loaded) {
+            emit notifySolverMessage("Invalid table in bundle: " + QString::fromStdString(p_fileName));
+			return false;
+		}
+		AttachTables(m_tableFile.GetData());
+		return true;
+	}
+
+	CTableFile::Status status = m_tableFile.Open(p_fileName);
+	if (status != CTableFile::Loaded) {
+		// 古い形式のファイルや壊れたファイルは作成し直す
+		if (status == CTableFile::Invalid) {
+            emit notifySolverMessage("Invalid table file: " + QString::fromStdString(p_fileName));
+		}
+        emit notifySolverMessage("Generating...");
+		AttachTables(m_tableFile.Allocate());
+		GenerateTables();
+        emit notifySolverMessage("Saving...");
+		if (!m_tableFile.Save(p_fileName)) {
+            emit notifySolverMessage("Failed to save " + QString::fromStdString(p_fileName));
+		}
+        emit notifySolverMessage("Done");
+	}
+	AttachTables(m_tableFile.GetData());
+	return true;
+}
+
+// 1つのファイルに全てのTableを並べたときのサイズ(byte)
+uint64_t CFlipSliceSymmetryTable::GetDataBytes()
+{
+	return FlipSliceClasses * sizeof(int)
+		+ FlipSlices * sizeof(unsigned short)
+		+ FlipSliceClasses * sizeof(unsigned short)
+		+ COrdinalCube::Twists * CSymmetry::NumberOfUpDownSymmetries * sizeof(unsigned short)
+		+ FlipSlices * sizeof(unsigned char);
+}
+
+// ファイルのデータの各Tableの先頭アドレスを設定する
+// 要素のサイズが大きいTableから順に並べるので，各Tableの先頭は要素のサイズの境界に揃う
+void CFlipSliceSymmetryTable::AttachTables(unsigned char* p_data)
+{
+	m_representatives = (int*)p_data;
+	p_data += FlipSliceClasses * sizeof(int);
+	m_classIndices = (unsigned short*)p_data;
+	p_data += FlipSlices * sizeof(unsigned short);
+	m_stabilizers = (unsigned short*)p_data;
+	p_data += FlipSliceClasses * sizeof(unsigned short);
+	m_twistConjugates = (unsigned short (*)[CSymmetry::NumberOfUpDownSymmetries])p_data;
+	p_data += COrdinalCube::Twists * CSymmetry::NumberOfUpDownSymmetries * sizeof(unsigned short);
+	m_symmetries = p_data;
+}
+
+// Tableを作成する
+void CFlipSliceSymmetryTable::GenerateTables()
+{
+	enum { Unassigned = 0xFFFF };
+	COrdinalCube cube;
+
+	CSymmetry::Initialize();
+
+	// twistの対称変換
+	for (int twist = 0; twist < COrdinalCube::Twists; twist++) {
+		for (int symmetry = 0; symmetry < CSymmetry::NumberOfUpDownSymmetries; symmetry++) {
+			cube.SetCleanCube();
+			cube.SetOrientationsFromTwist(twist);
+			CSymmetry::Conjugate(symmetry, cube);
+			m_twistConjugates[twist][symmetry] = (unsigned short)cube.GetTwistFromOrientations();
+		}
+	}
+
+	// flipsliceの同値類
+	// まだ分類されていないflipsliceを新しい同値類の代表元とし，
+	// 代表元を16種類の対称変換で移したflipsliceを同じ同値類に分類する
+	for (int flipSlice = 0; flipSlice < FlipSlices; flipSlice++) {
+		m_classIndices[flipSlice] = Unassigned;
+	}
+
+	int classIndex = 0;
+	for (int flipSlice = 0; flipSlice < FlipSlices; flipSlice++) {
+		if (m_classIndices[flipSlice] != Unassigned) {
+			continue;
+		}
+		m_representatives[classIndex] = flipSlice;
+		m_stabilizers[classIndex] = 0;
+
+		for (int symmetry = 0; symmetry < CSymmetry::NumberOfUpDownSymmetries; symmetry++) {
+			SetFlipSlice(cube, flipSlice % COrdinalCube::Flips, flipSlice / COrdinalCube::Flips);
+			CSymmetry::Conjugate(symmetry, cube);
+			int conjugate = GetFlipSlice(cube.GetFlipFromOrientations(), cube.GetChoiceFromEdgePermutation());
+			if (conjugate == flipSlice) {
+				m_stabilizers[classIndex] |= (1 << symmetry);
+			}
+
+			// 代表元自身が対称なときは，複数の対称変換で同じflipsliceに移るので，最初のものを使う
+			// (代表元に移す対称変換は恒等変換になる)
+			if (m_classIndices[conjugate] == Unassigned) {
+				m_classIndices[conjugate] = (unsigned short)classIndex;
+				m_symmetries[conjugate] = (unsigned char)CSymmetry::GetInverseSymmetry(symmetry);
+			}
+		}
+		classIndex++;
+	}
+}
+
+// flip, choiceに対応するCubeの状態を設定する
+void CFlipSliceSymmetryTable::SetFlipSlice(COrdinalCube& cube, const int p_flip, const int p_choice)
+{
+	int edgePermutation[CCube::NumberOfEdgeSets];
+	cube.SetCleanCube();
+	cube.SetChoiceFromEdgePermutation(p_choice);
+
+	// SetChoiceFromEdgePermutationで割り当てられなかった位置にUp層・Down層のEdgeを配置する
+	for (int edge = CCube::FirstEdgeSet, cubie = CCube::FirstEdgeSet; edge <= CCube::LastEdgeSet; edge++) {
+		edgePermutation[edge] = cube.GetEdgePermutation()[edge];
+		if (edgePermutation[edge] == CCube::InvalidSet) {
+			edgePermutation[edge] = cubie++;
+		}
+	}
+	cube.SetState(cube.GetCornerPermutation(), cube.GetCornerOrientations(),
+		edgePermutation, cube.GetEdgeOrientations());
+	cube.SetOrientationsFromFlip(p_flip);
+}
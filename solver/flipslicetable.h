@@ -0,0 +1,104 @@
+﻿#ifndef	_FLIPSLICETABLE_H_
+#define	_FLIPSLICETABLE_H_
+
+#include "ordinalcube.h"
+#include "symmetry.h"
+#include "tablefile.h"
+
+#include <string>
+#include <QObject>
+
+// FlipとChoice(Middle層のEdgeの位置)を組み合わせた序数(flipslice)を，
+// U-D軸を保存する16種類の対称変換で同値類に分類するTable
+// http://kociemba.org/math/symmetric.htm
+// flipslice = choice * Flips + flip の2048 * 495 = 1013760通りは64430個の同値類になる
+// 各flipsliceに対して，同値類の番号と，代表元に移す対称変換を保存する
+class CFlipSliceSymmetryTable : public QObject
+{
+    Q_OBJECT
+signals:
+    void notifySolverMessage(QString p_message);
+
+public:
+	CFlipSliceSymmetryTable();
+	~CFlipSliceSymmetryTable();
+
+	enum
+	{
+		FlipSlices = COrdinalCube::Flips * COrdinalCube::Choices,	// flipsliceの数 2048 * 495 = 1013760
+		FlipSliceClasses = 64430	// flipsliceの同値類の数
+	};
+
+	// Tableのファイルをメモリマップする
+	// ファイルが無いとき，ヘッダかチェックサムが一致しないときは作成して保存する
+	// p_bundleを指定したときはバンドルの中のTableを使い，見つからなければfalseを返す
+	bool Initialize(const std::string p_fileName, const CTableBundle* p_bundle = NULL);
+
+	// flipsliceの序数
+	static int GetFlipSlice(const int p_flip, const int p_choice)
+	{
+		return p_choice * COrdinalCube::Flips + p_flip;
+	}
+
+	// flipsliceが属する同値類の番号を取得する
+	int GetClassIndex(const int p_flipSlice) const
+	{
+		return m_classIndices[p_flipSlice];
+	}
+
+	// flipsliceを同値類の代表元に移す対称変換を取得する
+	// 代表元 = S * flipslice * S^-1
+	int GetSymmetry(const int p_flipSlice) const
+	{
+		return m_symmetries[p_flipSlice];
+	}
+
+	// 同値類の代表元のflipsliceを取得する
+	int GetRepresentative(const int p_classIndex) const
+	{
+		return m_representatives[p_classIndex];
+	}
+
+	// 同値類の代表元を自分自身に移す対称変換を取得する
+	// p_symmetry番目のビットが1なら，p_symmetryで代表元は変化しない(恒等変換は常に含まれる)
+	int GetStabilizer(const int p_classIndex) const
+	{
+		return m_stabilizers[p_classIndex];
+	}
+
+	// twistを対称変換したtwistを取得する (S * twist * S^-1)
+	// U-D軸を保存する対称変換では，twistはtwistのみで決まる
+	int ConjugateTwist(const int p_twist, const int p_symmetry) const
+	{
+		return m_twistConjugates[p_twist][p_symmetry];
+	}
+
+private:
+	// Tableを作成する
+	void GenerateTables();
+
+	// 1つのファイルに全てのTableを並べたときのサイズ(byte)
+	static uint64_t GetDataBytes();
+	// ファイルのデータの各Tableの先頭アドレスを設定する
+	void AttachTables(unsigned char* p_data);
+
+	// flip, choiceに対応するCubeの状態を設定する
+	// Middle層以外のEdgeは，空いている位置に順番に配置する
+	static void SetFlipSlice(COrdinalCube& cube, const int p_flip, const int p_choice);
+
+	// flipsliceの同値類の番号
+	unsigned short* m_classIndices;
+	// flipsliceを同値類の代表元に移す対称変換
+	unsigned char* m_symmetries;
+	// 同値類の代表元のflipslice
+	int* m_representatives;
+	// 同値類の代表元を自分自身に移す対称変換のビット列
+	unsigned short* m_stabilizers;
+	// twistを対称変換したtwist
+	unsigned short (*m_twistConjugates)[CSymmetry::NumberOfUpDownSymmetries];
+
+	// Tableのファイル
+	CTableFile m_tableFile;
+};
+
+#endif	// _FLIPSLICETABLE_H_
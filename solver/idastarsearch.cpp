@@ -5,192 +5,227 @@
 #include <iomanip>
 #include <string>
 #include <sstream>
+#include <thread>
+#include <algorithm>
+#include <array>
+
+CIDAstarSearch::CIDAstarSearch(CSolverTables& p_tables)
+	: m_solution(m_ownSolution),
+	m_isStopped(false),
+	m_numberOfThreads(1),
+	m_splitDepth(3),
+	m_numberOfPhase2Threads(0),
+	m_phase1Solutions(Phase1SolutionQueueSize),
+	m_isPhase1Finished(false),
+	m_isPhase2TimedOut(false),
+	m_isPortfolio(false),
+	m_symmetry(0),
+	m_isInverse(false),
+	m_isMultiLookup(false),
+	m_isChildOrdering(false),
+	m_timer(NULL),
+	m_tables(p_tables)
+{
+	m_context.subtreeQueues = NULL;
+	m_ownSolution.minSolutionLength = InitialSolutionLength;
+	m_ownSolution.firstSolutionTime = -1;
+	m_ownSolution.solutionStack.clear();
+}
 
-CIDAstarSearch::CIDAstarSearch()
-	// Clean Cubeを渡してconstructする
-	// Phase 1のMoveTable
-	: m_twistMoveTable(m_cube),
-	m_flipMoveTable(m_cube),
-	m_choiceMoveTable(m_cube),
-	// Phase 2のMoveTable
-	m_cornerPermutationMoveTable(m_cube),
-	m_upDownEdgePermutationMoveTable(m_cube),
-	m_middleEdgePermutationMoveTable(m_cube),
-
-	// MoveTable2つを組み合わせて，PruningTable(パターンデータベース)を作成する
-	// Phase 1の刈込テーブル
-	m_twistAndFlipPruningTable(
-		m_twistMoveTable, m_flipMoveTable,
-		m_cube.GetTwistFromOrientations(), m_cube.GetFlipFromOrientations()),
-	m_twistAndChoicePruningTable(
-		m_twistMoveTable, m_choiceMoveTable,
-		m_cube.GetTwistFromOrientations(), m_cube.GetChoiceFromEdgePermutation()),
-	m_flipAndChoicePruningTable(
-		m_flipMoveTable, m_choiceMoveTable,
-		m_cube.GetFlipFromOrientations(), m_cube.GetChoiceFromEdgePermutation()),
-	// Phase 2の刈込テーブル
-	m_cornerAndUpDownPruningTable(
-		m_cornerPermutationMoveTable, m_middleEdgePermutationMoveTable,
-		m_cube.GetOrdinalFromCornerPermutation(), m_cube.GetOrdinalFromMiddleEdgePermutation()),
-	m_upDownAndMiddlePruningTable(
-		m_upDownEdgePermutationMoveTable, m_middleEdgePermutationMoveTable,
-		m_cube.GetOrdinalFromUpDownEdgePermutation(), m_cube.GetOrdinalFromMiddleEdgePermutation())
-{
-	m_minSolutionLength = InitialSolutionLength;
-	m_solutionStack.clear();
-
-    // MoveTable connection
-    connect(&m_twistMoveTable, SIGNAL(notifySolverMessage(QString)),
-            this, SLOT(onGetSolverMessage(QString)));
-    connect(&m_flipMoveTable, SIGNAL(notifySolverMessage(QString)),
-            this, SLOT(onGetSolverMessage(QString)));
-    connect(&m_choiceMoveTable, SIGNAL(notifySolverMessage(QString)),
-            this, SLOT(onGetSolverMessage(QString)));
-    connect(&m_cornerPermutationMoveTable, SIGNAL(notifySolverMessage(QString)),
-            this, SLOT(onGetSolverMessage(QString)));
-    connect(&m_upDownEdgePermutationMoveTable, SIGNAL(notifySolverMessage(QString)),
-            this, SLOT(onGetSolverMessage(QString)));
-    connect(&m_middleEdgePermutationMoveTable, SIGNAL(notifySolverMessage(QString)),
-            this, SLOT(onGetSolverMessage(QString)));
-
-    // PruningTable connection
-    connect(&m_twistAndFlipPruningTable, SIGNAL(notifySolverMessage(QString)),
-            this, SLOT(onGetSolverMessage(QString)));
-    connect(&m_twistAndChoicePruningTable, SIGNAL(notifySolverMessage(QString)),
-            this, SLOT(onGetSolverMessage(QString)));
-    connect(&m_flipAndChoicePruningTable, SIGNAL(notifySolverMessage(QString)),
-            this, SLOT(onGetSolverMessage(QString)));
-    connect(&m_cornerAndUpDownPruningTable, SIGNAL(notifySolverMessage(QString)),
-            this, SLOT(onGetSolverMessage(QString)));
-    connect(&m_upDownAndMiddlePruningTable, SIGNAL(notifySolverMessage(QString)),
-            this, SLOT(onGetSolverMessage(QString)));
+// ポートフォリオ探索の1つの探索を作成する
+CIDAstarSearch::CIDAstarSearch(CIDAstarSearch& p_parent, const int p_index, const int p_symmetry, const bool p_isInverse)
+	: m_solution(p_parent.m_solution),
+	m_isStopped(false),
+	m_numberOfThreads(1),
+	m_splitDepth(p_parent.m_splitDepth),
+	m_numberOfPhase2Threads(0),
+	m_phase1Solutions(Phase1SolutionQueueSize),
+	m_isPhase1Finished(false),
+	m_isPhase2TimedOut(false),
+	m_isPortfolio(false),
+	m_symmetry(p_symmetry),
+	m_isInverse(p_isInverse),
+	m_isMultiLookup(p_parent.m_isMultiLookup),
+	m_isChildOrdering(p_parent.m_isChildOrdering),
+	m_timer(NULL),
+	m_tables(p_parent.m_tables)
+{
+	m_context.subtreeQueues = NULL;
+	m_ownSolution.minSolutionLength = InitialSolutionLength;
+	m_ownSolution.firstSolutionTime = -1;
+
+	// 親の探索のスレッド数を6つの探索で分け合う
+	// スレッド数が6未満でも，どの探索も1つ以上のスレッドを使う
+	// (パイプライン探索ではPhase 2のスレッドも1つ以上にして，パイプラインを止めない)
+	SetParallelSearch(GetPortfolioShare(p_parent.m_numberOfThreads, p_index), m_splitDepth);
+	if (p_parent.m_numberOfPhase2Threads > 0) {
+		SetPipelinedSearch(std::max(1, GetPortfolioShare(p_parent.m_numberOfPhase2Threads, p_index)));
+	}
+
+	// 別スレッドから親の探索のslotを直接呼び出して，親の探索のsignalとして通知する
+	connect(this, SIGNAL(notifySolverMessage(QString)), &p_parent, SLOT(onGetSolverMessage(QString)), Qt::DirectConnection);
 }
 
 CIDAstarSearch::~CIDAstarSearch()
 {
 }
 
-// MoveTable,PruningTableを初期化する
-void CIDAstarSearch::InitializeTables()
-{
-	// Phase 1のMoveTableを作成する
-    //std::cout << "Initializing TwistMoveTable" << std::endl;
-    emit notifySolverMessage("Initializing TwistMoveTable");
-	m_twistMoveTable.Initialize("TwistMoveTable.mt");
-    //std::cout << "Size = " << m_twistMoveTable.GetSize() << std::endl;
-    //emit notifySolverMessage("Size = " + QString::number(m_twistMoveTable.GetSize()));
-
-    //std::cout << "Initializing FlipMoveTable" << std::endl;
-    emit notifySolverMessage("Initializing FlipMoveTable");
-	m_flipMoveTable.Initialize("FlipMoveTable.mt");
-    //std::cout << "Size = " << m_flipMoveTable.GetSize() << std::endl;
-    //emit notifySolverMessage("Size = " + QString::number(m_flipMoveTable.GetSize()));
-
-    //std::cout << "Initializing ChoiceMoveTable" << std::endl;
-    emit notifySolverMessage("Initializing ChoiceMoveTable");
-	m_choiceMoveTable.Initialize("ChoiceMoveTable.mt");
-    //std::cout << "Size = " << m_choiceMoveTable.GetSize() << std::endl;
-    //emit notifySolverMessage("Size = " + QString::number(m_choiceMoveTable.GetSize()));
-
-	// Phase 2のMoveTableを作成する
-    //std::cout << "Initializing CornerPermutationMoveTable" << std::endl;
-    emit notifySolverMessage("Initializing CornerPermutationMoveTable");
-	m_cornerPermutationMoveTable.Initialize("CornerPermutationMoveTable.mt");
-    //std::cout << "Size = " << m_cornerPermutationMoveTable.GetSize() << std::endl;
-    //emit notifySolverMessage("Size = " + QString::number(m_cornerPermutationMoveTable.GetSize()));
-
-    //std::cout << "Initializing UpDownEdgePermutationMoveTable" << std::endl;
-    emit notifySolverMessage("Initializing UpDownEdgePermutationMoveTable");
-	m_upDownEdgePermutationMoveTable.Initialize("UpDownEdgePermutationMoveTable.mt");
-    //std::cout << "Size = " << m_upDownEdgePermutationMoveTable.GetSize() << std::endl;
-    //emit notifySolverMessage("Size = " + QString::number(m_upDownEdgePermutationMoveTable.GetSize()));
-
-    //std::cout << "Initializing MiddleEdgePermutationMoveTable" << std::endl;
-    emit notifySolverMessage("Initializing MiddleEdgePermutationMoveTable");
-	m_middleEdgePermutationMoveTable.Initialize("MiddleEdgePermutationMoveTable.mt");
-    //std::cout << "Size = " << m_middleEdgePermutationMoveTable.GetSize() << std::endl;
-    //emit notifySolverMessage("Size = " + QString::number(m_middleEdgePermutationMoveTable.GetSize()));
-
-	// Phase 1のPruningTableを作成する
-    //std::cout << "Initializing TwistAndFlipPruningTable" << std::endl;
-    emit notifySolverMessage("Initializing TwistAndFlipPruningTable");
-	m_twistAndFlipPruningTable.Initialize("TwistAndFlipPruningTable.pt");
-    //std::cout << "Size = " << m_twistAndFlipPruningTable.GetSize() << std::endl;
-    //emit notifySolverMessage("Size = " + QString::number(m_twistAndFlipPruningTable.GetSize()));
-
-    //std::cout << "Initializing TwistAndChoicePruningTable" << std::endl;
-    emit notifySolverMessage("Initializing TwistAndChoicePruningTable");
-	m_twistAndChoicePruningTable.Initialize("TwistAndChoicePruningTable.pt");
-    //std::cout << "Size = " << m_twistAndChoicePruningTable.GetSize() << std::endl;
-    //emit notifySolverMessage("Size = " + QString::number(m_twistAndChoicePruningTable.GetSize()));
-
-    //std::cout << "Initializing FlipAndChoicePruningTable" << std::endl;
-    emit notifySolverMessage("Initializing FlipAndChoicePruningTable");
-	m_flipAndChoicePruningTable.Initialize("FlipAndChoicePruningTable.pt");
-    //std::cout << "Size = " << m_flipAndChoicePruningTable.GetSize() << std::endl;
-    //emit notifySolverMessage("Size = " + QString::number(m_flipAndChoicePruningTable.GetSize()));
-
-	// Phase 2のPruningTableを作成する
-    //std::cout << "Initializing CornerAndUpDownPruningTable" << std::endl;
-    emit notifySolverMessage("Initializing CornerAndUpDownPruningTable");
-	m_cornerAndUpDownPruningTable.Initialize("CornerAndUpDownPruningTable.pt");
-    //std::cout << "Size = " << m_cornerAndUpDownPruningTable.GetSize() << std::endl;
-    //emit notifySolverMessage("Size = " + QString::number(m_cornerAndUpDownPruningTable.GetSize()));
-
-    //std::cout << "Initializing UpDownAndMiddlePruningTable" << std::endl;
-    emit notifySolverMessage("Initializing UpDownAndMiddlePruningTable");
-	m_upDownAndMiddlePruningTable.Initialize("UpDownAndMiddlePruningTable.pt");
-    //std::cout << "Size = " << m_upDownAndMiddlePruningTable.GetSize() << std::endl;
-    //emit notifySolverMessage("Size = " + QString::number(m_upDownAndMiddlePruningTable.GetSize()));
+// 6つの探索のうちp_index番目の探索に割り当てるスレッド数
+int CIDAstarSearch::GetPortfolioShare(const int p_numberOfThreads, const int p_index)
+{
+	return p_numberOfThreads / NumberOfPortfolioSearches + ((p_index < p_numberOfThreads % NumberOfPortfolioSearches) ? 1 : 0);
 }
 
 // Two Phase AlgorithmによるIDA*探索を開始する
 int CIDAstarSearch::Solve(const COrdinalCube &p_scrambledCube, int64_t p_timeOut)
+{
+	// 同じオブジェクトで何度でも解探索できるように，前回の探索結果を初期化する
+	m_solution.minSolutionLength = InitialSolutionLength;
+	m_solution.firstSolutionTime = -1;
+	m_solution.solutionStack.clear();
+
+	// 完成付近のデータベースにあれば，解探索を行わずに最短の解法を返す
+	const int distance = m_tables.m_nearSolvedDatabase.GetSolution(p_scrambledCube, m_context.nearSolvedMoves);
+	if (distance != CNearSolvedDatabase::NotFound) {
+		m_context.solutionLength1 = 0;
+		m_context.solutionLength2 = 0;
+		m_context.nearSolvedLength = distance;
+		PrintAndStackSolution(m_context);
+		return PHASE_2_FOUND;
+	}
+
+	if (m_isPortfolio) {
+		return SolvePortfolio(p_scrambledCube, p_timeOut);
+	}
+	return SolveCube(p_scrambledCube, p_timeOut);
+}
+
+// 6通りの探索を別スレッドで同時に行う
+int CIDAstarSearch::SolvePortfolio(const COrdinalCube &p_scrambledCube, int64_t p_timeOut)
+{
+	CSymmetry::Initialize();
+
+	std::vector<CIDAstarSearch*> searches;
+	std::vector<int> results(NumberOfPortfolioSearches, NOT_FOUND);
+	std::vector<std::thread> threads;
+
+	for (int axis = 0; axis < CSymmetry::NumberOfAxes; axis++) {
+		for (int inverse = 0; inverse < 2; inverse++) {
+			int symmetry = CSymmetry::GetAxisSymmetry(axis);
+
+			// 逆元を取ってから対称変換したCubeを探索する
+			COrdinalCube cube = p_scrambledCube;
+			if (inverse) {
+				cube.Invert();
+			}
+			CSymmetry::Conjugate(symmetry, cube);
+
+			int index = (int)searches.size();
+			CIDAstarSearch* search = new CIDAstarSearch(*this, index, symmetry, inverse != 0);
+			searches.push_back(search);
+			threads.push_back(std::thread([search, cube, p_timeOut, &results, index]() {
+				results[index] = search->SolveCube(cube, p_timeOut);
+			}));
+		}
+	}
+
+	int result = NOT_FOUND;
+	for (int i = 0; i < NumberOfPortfolioSearches; i++) {
+		threads[i].join();
+		result = std::max(result, results[i]);
+		delete searches[i];
+	}
+	return result;
+}
+
+// 解法を共有する探索として，1つのCubeの状態に対する解探索を行う
+int CIDAstarSearch::SolveCube(const COrdinalCube &p_cube, int64_t p_timeOut)
 {
 	int iteration = 1;	// 反復回数
 	int result = NOT_FOUND;
 
-	m_cube = p_scrambledCube;
+	m_cube = p_cube;
+	m_isStopped = false;
+
+	// 初期状態の序数
+	int twist = m_cube.GetTwistFromOrientations();
+	int flip = m_cube.GetFlipFromOrientations();
+	int choice = m_cube.GetChoiceFromEdgePermutation();
 
 	// http://piyajk.com/archives/162
 	// とりあえず，今の状態からPhase1の推定コストを計算する
 	// コストは大きめの値が計算されるようになっている(ヒューリスティック関数)
 	// 小さいほど完成状態に近い
-	m_threshold1 = Phase1Cost(
-		m_cube.GetTwistFromOrientations(),
-		m_cube.GetFlipFromOrientations(),
-		m_cube.GetChoiceFromEdgePermutation()
-		);
-
-	m_nodes1 = 1;		// ノードの場所
-	m_solutionLength1 = 0;
+	// (PruningTableがDepthの余りのみを格納しているときは，完成状態まで辿って正確なコストを求める)
+	const int cost = Phase1RootCost(twist, flip, choice);
+	m_context.threshold1 = cost;
+
+	m_context.nodes1 = 1;		// ノードの場所
+	m_context.solutionLength1 = 0;
+
+	// 根のPhase 2の座標(Phase 1の探索中はMoveTableで追跡する)
+	SPhase2Coordinates& coordinates = m_context.phase2Coordinates[0];
+	coordinates.cornerPermutation = m_cube.GetOrdinalFromCornerPermutation();
+	coordinates.upDownEdgeSplit1 = m_cube.GetOrdinalFromEdgeSubsetPositions(CCube::UF, COrdinalCube::UpDownEdgeSplitSize);
+	coordinates.upDownEdgeSplit2 = m_cube.GetOrdinalFromEdgeSubsetPositions(CCube::UR, COrdinalCube::UpDownEdgeSplitSize);
+	coordinates.middleEdgePositions = m_cube.GetOrdinalFromEdgeSubsetPositions(CCube::FirstMiddleEdgeSet, 4);
+	m_context.phase2CoordinatesDepth = 0;
+
+	// 根の追加のlookupの状態(Phase 1の探索中は移動に合わせて追跡する)
+	if (m_isMultiLookup) {
+		InitializePhase1Lookups(m_context.phase1Lookups[0]);
+	}
+	m_context.phase1LookupsDepth = 0;
+	for (int i = 0; i < NumberOfPhase1Lookups; i++) {
+		m_context.prunedNodes1[i] = 0;
+	}
 
 	// タイマーConstruct
     m_timer = new CTimer(p_timeOut);
 	// タイマーStart
 	m_timer->start();
 
+	// パイプライン探索ではPhase 2のスレッドを先に起動しておく
+	m_isPhase1Finished = false;
+	m_isPhase2TimedOut = false;
+	std::vector<std::thread> phase2Threads;
+	for (int i = 0; i < m_numberOfPhase2Threads; i++) {
+		phase2Threads.push_back(std::thread(&CIDAstarSearch::RunPhase2Worker, this));
+	}
+
 	do{
-        //std::cout << "threshold(" << iteration << ") = " << m_threshold1 << std::endl;
-        emit notifySolverMessage("[" + QString::number(iteration) + " : phase 1 threshold = " + QString::number(m_threshold1) + "]");
-		m_nextThreshold1 = InitialSolutionLength;	// コストを最大にする
+        //std::cout << "threshold(" << iteration << ") = " << m_context.threshold1 << std::endl;
+        emit notifySolverMessage("[" + QString::number(iteration) + " : phase 1 threshold = " + QString::number(m_context.threshold1) + "]");
+		m_context.nextThreshold1 = InitialSolutionLength;	// コストを最大にする
 
 		// 現在のCubeの状態に対して，深さ0のIDA*探索を開始する
-		result = Search1(
-			m_cube.GetTwistFromOrientations(),
-			m_cube.GetFlipFromOrientations(),
-			m_cube.GetChoiceFromEdgePermutation(),
-			0
-			);
+		if (m_numberOfThreads > 1) {
+			// 部分木に分割して複数のスレッドで探索する
+			result = ParallelSearch1(twist, flip, choice, cost);
+		}
+		else {
+			result = Search1(m_context, twist, flip, choice, 0, cost, CMoveSequenceAutomaton::InitialState, UnknownCost);
+		}
+
+		// 閾値を超えたノードが無ければ，全てのノードが今までの解法より短くならないので探索を終了する
+		// (追加のlookupで刈り込んだノードは閾値を更新しない)
+		if (result == NOT_FOUND && m_context.nextThreshold1 == InitialSolutionLength) {
+			result = PHASE_1_FOUND;
+		}
 
 		// 閾値をより浅くして探索する
-		m_threshold1 = m_nextThreshold1;
+		m_context.threshold1 = m_context.nextThreshold1;
 
 		// 反復回数を増やす
 		iteration++;
 
-        //std::cout << "Phase 1 nodes = " << m_nodes1 << std::endl;
-        emit notifySolverMessage("Phase 1 nodes = " + QString::number(m_nodes1));
+        //std::cout << "Phase 1 nodes = " << m_context.nodes1 << std::endl;
+        emit notifySolverMessage("Phase 1 nodes = " + QString::number(m_context.nodes1));
+        if (m_isMultiLookup) {
+            emit notifySolverMessage("Phase 1 pruned nodes (URF3 axis = " + QString::number(m_context.prunedNodes1[AxisLookup1])
+                                     + ", URF3^2 axis = " + QString::number(m_context.prunedNodes1[AxisLookup2])
+                                     + ", inverse = " + QString::number(m_context.prunedNodes1[InverseLookup]) + ")");
+        }
 
 		// タイマーCheck
 		if (m_timer->isTimeOut() || result == TIME_OUT) {
@@ -201,56 +236,105 @@ int CIDAstarSearch::Solve(const COrdinalCube &p_scrambledCube, int64_t p_timeOut
 		// 解法が見つかるまで続ける
 	} while (result == NOT_FOUND);
 
+	// キューに残ったPhase 1の解法を探索し終えるまで待つ
+	m_isPhase1Finished = true;
+	for (size_t i = 0; i < phase2Threads.size(); i++) {
+		phase2Threads[i].join();
+	}
+	if (m_isPhase2TimedOut) {
+		result = TIME_OUT;
+	}
+
 	delete m_timer;
+	m_timer = NULL;
 	return result;
 }
 
-// m_solutionStackの最新の解をreturnする
+// 解法のStackの最新の解をreturnする
 std::string CIDAstarSearch::GetSolution() const
 {
-	if (m_solutionStack.size() >= 1) {
-		return m_solutionStack.at(m_solutionStack.size() - 1);
+	if (m_solution.solutionStack.size() >= 1) {
+		return m_solution.solutionStack.at(m_solution.solutionStack.size() - 1);
 	}
 	else {
 		return "Solution was not found.";
 	}
 }
 
+// Phase 1の並列探索の設定
+void CIDAstarSearch::SetParallelSearch(const int p_numberOfThreads, const int p_splitDepth)
+{
+	m_numberOfThreads = (p_numberOfThreads > 1) ? p_numberOfThreads : 1;
+	// 部分木の根までの移動記号を保存できる深さに制限する
+	m_splitDepth = std::max(0, std::min(p_splitDepth, (int)MaxSolutionLength - 1));
+}
+
+// Phase 1とPhase 2のパイプライン探索の設定
+void CIDAstarSearch::SetPipelinedSearch(const int p_numberOfPhase2Threads)
+{
+	m_numberOfPhase2Threads = (p_numberOfPhase2Threads > 0) ? p_numberOfPhase2Threads : 0;
+}
+
+// 軸・逆元のポートフォリオ探索の設定
+void CIDAstarSearch::SetPortfolioSearch(const bool p_isPortfolio)
+{
+	m_isPortfolio = p_isPortfolio;
+}
+
+// Phase 1の複数lookupの設定
+void CIDAstarSearch::SetMultiLookupHeuristic(const bool p_isMultiLookup)
+{
+	m_isMultiLookup = p_isMultiLookup;
+}
+
+// 子ノードの並べ替えの設定
+void CIDAstarSearch::SetChildOrdering(const bool p_isChildOrdering)
+{
+	m_isChildOrdering = p_isChildOrdering;
+}
+
 // Phase 1の再帰的IDA*探索関数
 // 再起呼び出しはdepth+1で行う
-int CIDAstarSearch::Search1(const int p_twist, const int p_flip, const int p_choice, const int p_depth)
+int CIDAstarSearch::Search1(SSearchContext& p_context, const int p_twist, const int p_flip, const int p_choice, const int p_depth, const int p_parentCost, const int p_sequenceState, const int p_knownCost)
 {
 	int totalCost;
 
+	// 並列探索で他のスレッドが探索を終了させた
+	if (m_isStopped.load(std::memory_order_relaxed)) {
+		return ABORT;
+	}
+
+	// 部分木の列挙中は，分割する深さに達したら部分木としてキューに積む
+	// (部分木の根のコスト計算は，部分木を探索するスレッドで行う)
+	if (p_context.subtreeQueues && p_depth == m_splitDepth) {
+		SSubtree subtree;
+		for (int i = 0; i < p_depth; i++) {
+			subtree.solutionMoves1[i] = p_context.solutionMoves1[i];
+			subtree.solutionPowers1[i] = p_context.solutionPowers1[i];
+		}
+		subtree.twist = p_twist;
+		subtree.flip = p_flip;
+		subtree.choice = p_choice;
+		subtree.parentCost = p_parentCost;
+		subtree.sequenceState = p_sequenceState;
+
+		// 各スレッドのキューに順番に割り当てる
+		std::vector<SWorkQueue>& queues = *p_context.subtreeQueues;
+		queues[p_context.numberOfSubtrees++ % queues.size()].subtrees.push_back(subtree);
+		return NOT_FOUND;
+	}
+
 	// 現在のCubeの状態からPhase1完成までのコストを計算
-	int cost = Phase1Cost(p_twist, p_flip, p_choice);	
+	// (子ノードの並べ替えで親ノードが求めていれば，PruningTableを引き直さない)
+	int cost = (p_knownCost != UnknownCost) ? p_knownCost : Phase1Cost(p_twist, p_flip, p_choice, p_parentCost);
 
 	if (cost == 0){
 		// (twist, flip, choice)がPhase1の完成状態
-		// 解法が見つかったから探索深さを保存
-		m_solutionLength1 = p_depth;
-
-		// Phase2の解法探索を行う前に，CubeをPhase1へ初期化する
-		// (Cubeを最初の状態に戻す -> Phase1の解法の移動を行う)
-		COrdinalCube phase2Cube = m_cube;
-
-		// Cubeに対してPhase1の操作を加える
-		for (int i = 0; i < m_solutionLength1; i++){
-			// 各移動の回数分動かします
-			for (int power = 0; power < m_solutionPowers1[i]; power++) {
-				phase2Cube.ApplyMove(m_solutionMoves1[i]);
-			}
-		}
-		// ここでPhase1の完成状態
-
 		// Phase2探索を始める
-		// タイマーCheck
-		if (m_timer->isTimeOut() || Solve2(phase2Cube) == TIME_OUT) {
+		if (SearchPhase1Leaf(p_context, p_depth) == TIME_OUT) {
 			return TIME_OUT;
 		}
 
-		// このCubeに対するPhase2探索終わり
-
 		// 別のPhase1完成状態に対して，Phase2のもっと短い解がある可能性があるのでPhase1探索を続ける
 	}
 
@@ -268,17 +352,31 @@ int CIDAstarSearch::Search1(const int p_twist, const int p_flip, const int p_cho
 	// threshold1：
 	// 1回目の探索では，初めの状態よりヒューリスティック関数で計算
 	// n+1回目の探索以降では，n回目のtotalCostのうち最小のもの(newThreshold1)を用いる
-	if (totalCost <= m_threshold1){
+	if (totalCost <= p_context.threshold1){
 		// ノードの探索を行う
 		// minSolutionLength : 今まで見つかった解放のうち一番短いものの長さ
 		// 探索の深さがminSolutionLengthを超えてたら探索する意味がないのでreturn
-		if (p_depth >= m_minSolutionLength - 1) {
+		if (p_depth >= m_solution.minSolutionLength.load(std::memory_order_relaxed) - 1) {
 			return PHASE_1_FOUND;
 		}
+		// 他の軸・逆元のCubeの完成までの手数から，今までの解法より短くならない部分木を刈り込む
+		if (m_isMultiLookup && IsPrunedByPhase1Lookups(p_context, p_depth)) {
+			return NOT_FOUND;
+		}
+
+		// 子ノードをheuristicコストの小さい順に探索する
+		// (子ノードがすぐに探索を打ち切る深さでは，全ての子ノードのコストを求めても無駄になるので通常の順に探索する)
+		if (m_isChildOrdering && p_depth + 1 < m_solution.minSolutionLength.load(std::memory_order_relaxed) - 1) {
+			return SearchOrderedChildren1(p_context, p_twist, p_flip, p_choice, p_depth, cost, p_sequenceState);
+		}
+
+		// 冗長な移動列にならない移動(オートマトンの状態から1回の参照で求める)
+		const CMoveSequenceAutomaton& sequences = m_tables.m_phase1MoveSequences;
+		const uint32_t allowedMoves = sequences.GetAllowedMoves(p_sequenceState);
 
 		for (int move = CCube::Move::U; move <= CCube::Move::B; move++){
 			// 意味の無い動きは除外
-			if (IsNotAllowed(move, m_solutionMoves1, p_depth)) continue;
+			if (!(allowedMoves & CMoveSequenceAutomaton::GetFaceMoves(move))) continue;
 
 			// 現在の状態
 			int twist2 = p_twist;
@@ -286,24 +384,35 @@ int CIDAstarSearch::Search1(const int p_twist, const int p_flip, const int p_cho
 			int choice2 = p_choice;
 
 			// 移動指令を保存
-			m_solutionMoves1[p_depth] = move;
+			p_context.solutionMoves1[p_depth] = move;
 
 			// 状態遷移を行う
 			// powerは移動の反復回数
 			for (int power = 1; power < 4; power++){
+				// MoveTableは18種類の移動を持つので，反復回数によらず1回の参照で求められる
+				int move2 = CCube::GetMoveOfPower(move, power);
+				if (!(allowedMoves & (1u << move2))) continue;
+
 				// 移動指令の反復回数を保存
-				m_solutionPowers1[p_depth] = power;
+				p_context.solutionPowers1[p_depth] = power;
+				// これより深いPhase 2の座標は別の移動のものになる
+				if (p_context.phase2CoordinatesDepth > p_depth) {
+					p_context.phase2CoordinatesDepth = p_depth;
+				}
+				if (p_context.phase1LookupsDepth > p_depth) {
+					p_context.phase1LookupsDepth = p_depth;
+				}
 				// 状態遷移
-				// ex:twist2の状態に移動moveを行った時の新たな状態を取得する
-				twist2 = m_twistMoveTable[twist2][move];
-				flip2 = m_flipMoveTable[flip2][move];
-				choice2 = m_choiceMoveTable[choice2][move];
+				// ex:p_twistの状態に移動move(の反復power回)を行った時の新たな状態を取得する
+				twist2 = m_tables.m_twistMoveTable[p_twist][move2];
+				flip2 = m_tables.m_flipMoveTable[p_flip][move2];
+				choice2 = m_tables.m_choiceMoveTable[p_choice][move2];
 				// ノードを増やす
-				m_nodes1++;
+				p_context.nodes1++;
 				
 				// 今の状態を起点に，深さを増やして探索
 				int result;
-				if (result = Search1(twist2, flip2, choice2, p_depth + 1)) {
+				if (result = Search1(p_context, twist2, flip2, choice2, p_depth + 1, cost, sequences.GetNextState(p_sequenceState, move2), UnknownCost)) {
 					return result;	// 探索終了(PHASE_1_FOUND)ならreturn
 				}
 			}
@@ -313,16 +422,372 @@ int CIDAstarSearch::Search1(const int p_twist, const int p_flip, const int p_cho
 		// 今のコストで最小閾値を更新する
 		// ただし，threshold1は現在の閾値なので，現在の閾値を基準とした探索が終わるまでは
 		// 変更しないようにする -> newThreshold1に最小コストを保存しておく
-		if (totalCost < m_nextThreshold1) {
-			m_nextThreshold1 = totalCost;
+		if (totalCost < p_context.nextThreshold1) {
+			p_context.nextThreshold1 = totalCost;
 		}
 	}
 	
 	return NOT_FOUND;
 }
 
+// Phase 1の子ノードをheuristicコストの小さい順に探索する
+int CIDAstarSearch::SearchOrderedChildren1(SSearchContext& p_context, const int p_twist, const int p_flip, const int p_choice, const int p_depth, const int p_cost, const int p_sequenceState)
+{
+	const CMoveSequenceAutomaton& sequences = m_tables.m_phase1MoveSequences;
+	const uint32_t allowedMoves = sequences.GetAllowedMoves(p_sequenceState);
+
+	// 全ての子ノードの序数とコストを先に求める
+	SChild children[CCube::NumberOfMoves];
+	int numberOfChildren = 0;
+	for (int move = CCube::Move::U; move <= CCube::Move::B; move++) {
+		if (!(allowedMoves & CMoveSequenceAutomaton::GetFaceMoves(move))) continue;
+
+		for (int power = 1; power < 4; power++) {
+			SChild& child = children[numberOfChildren];
+			child.move = move;
+			child.power = power;
+			child.move2 = CCube::GetMoveOfPower(move, power);
+			if (!(allowedMoves & (1u << child.move2))) continue;
+
+			child.ordinals[0] = m_tables.m_twistMoveTable[p_twist][child.move2];
+			child.ordinals[1] = m_tables.m_flipMoveTable[p_flip][child.move2];
+			child.ordinals[2] = m_tables.m_choiceMoveTable[p_choice][child.move2];
+			child.cost = Phase1Cost(child.ordinals[0], child.ordinals[1], child.ordinals[2], p_cost);
+			p_context.nodes1++;
+
+			// 閾値を超える子ノードは，子ノードで閾値判定を行うのと同じく次の閾値だけ更新して探索しない
+			// (Phase 1の完成状態は閾値によらずPhase 2を探索するので除外しない)
+			const int totalCost = p_depth + 1 + child.cost;
+			if (child.cost > 0 && totalCost > p_context.threshold1) {
+				if (totalCost < p_context.nextThreshold1) {
+					p_context.nextThreshold1 = totalCost;
+				}
+				continue;
+			}
+			numberOfChildren++;
+		}
+	}
+
+	// 子ノードのコストは親ノードのコストと1以内しか違わないので，
+	// コストごとに3回走査すれば，並べ替えずに小さい順(同じコストは移動の順)に探索できる
+	for (int childCost = p_cost - 1; childCost <= p_cost + 1; childCost++) {
+		for (int i = 0; i < numberOfChildren; i++) {
+			const SChild& child = children[i];
+			if (child.cost != childCost) continue;
+
+			p_context.solutionMoves1[p_depth] = child.move;
+			p_context.solutionPowers1[p_depth] = child.power;
+			// これより深いPhase 2の座標と追加のlookupは別の移動のものになる
+			if (p_context.phase2CoordinatesDepth > p_depth) {
+				p_context.phase2CoordinatesDepth = p_depth;
+			}
+			if (p_context.phase1LookupsDepth > p_depth) {
+				p_context.phase1LookupsDepth = p_depth;
+			}
+
+			// 子ノードのコストは求め済みなので，PruningTableを引き直さない
+			const int result = Search1(p_context, child.ordinals[0], child.ordinals[1], child.ordinals[2], p_depth + 1, p_cost, sequences.GetNextState(p_sequenceState, child.move2), child.cost);
+			if (result != NOT_FOUND) {
+				return result;
+			}
+		}
+	}
+	return NOT_FOUND;
+}
+
+// 追加のlookupで，深さp_depthのノードから今までの解法より短い解法が見つからないか判定する
+// 他の軸の対称変換や逆元のCubeは元のCubeと同じ手数で完成するので，
+// それぞれのPhase 1の完成までの手数は完成までの手数の下限になる
+// (Phase 1の完成までの手数の下限ではないので，Phase 1の閾値には用いない)
+bool CIDAstarSearch::IsPrunedByPhase1Lookups(SSearchContext& p_context, const int p_depth)
+{
+	// 解法が見つかるまでは刈り込めない
+	const int minSolutionLength = m_solution.minSolutionLength.load(std::memory_order_relaxed);
+	if (minSolutionLength >= InitialSolutionLength) {
+		return false;
+	}
+
+	// Phase 1の解法の移動のうち，まだ追跡していない部分を進める
+	for (int depth = p_context.phase1LookupsDepth; depth < p_depth; depth++) {
+		const SPhase1Lookups& current = p_context.phase1Lookups[depth];
+		SPhase1Lookups& next = p_context.phase1Lookups[depth + 1];
+		const int move = CCube::GetMoveOfPower(p_context.solutionMoves1[depth], p_context.solutionPowers1[depth]);
+
+		// 対称変換のCubeには対称変換した移動を行う (S * cube * move * S^-1 = (S * cube * S^-1) * (S * move * S^-1))
+		for (int axis = 0; axis < NumberOfAxisLookups; axis++) {
+			const int move2 = CSymmetry::ConjugateMove(CSymmetry::GetAxisSymmetry(axis + 1), move);
+			next.twist[axis] = m_tables.m_twistMoveTable[current.twist[axis]][move2];
+			next.flip[axis] = m_tables.m_flipMoveTable[current.flip[axis]][move2];
+			next.choice[axis] = m_tables.m_choiceMoveTable[current.choice[axis]][move2];
+			next.costs[axis] = Phase1Cost(next.twist[axis], next.flip[axis], next.choice[axis], current.costs[axis]);
+		}
+
+		// 逆元のCubeには移動の逆を先に行う ((cube * move)^-1 = move^-1 * cube^-1)
+		next.inverseCube = current.inverseCube;
+		next.inverseCube.PremultiplyMove(CCube::GetInverseOfMove(move));
+		next.costs[InverseLookup] = InversePhase1Cost(next.inverseCube);
+	}
+	p_context.phase1LookupsDepth = p_depth;
+
+	// 刈り込めるlookupを全て数える
+	const SPhase1Lookups& lookups = p_context.phase1Lookups[p_depth];
+	bool isPruned = false;
+	for (int i = 0; i < NumberOfPhase1Lookups; i++) {
+		if (p_depth + lookups.costs[i] >= minSolutionLength) {
+			p_context.prunedNodes1[i]++;
+			isPruned = true;
+		}
+	}
+	return isPruned;
+}
+
+// 探索の根の追加のlookupの状態を求める
+void CIDAstarSearch::InitializePhase1Lookups(SPhase1Lookups& p_lookups) const
+{
+	CSymmetry::Initialize();
+
+	for (int axis = 0; axis < NumberOfAxisLookups; axis++) {
+		COrdinalCube cube = m_cube;
+		CSymmetry::Conjugate(CSymmetry::GetAxisSymmetry(axis + 1), cube);
+		p_lookups.twist[axis] = cube.GetTwistFromOrientations();
+		p_lookups.flip[axis] = cube.GetFlipFromOrientations();
+		p_lookups.choice[axis] = cube.GetChoiceFromEdgePermutation();
+		p_lookups.costs[axis] = Phase1RootCost(p_lookups.twist[axis], p_lookups.flip[axis], p_lookups.choice[axis]);
+	}
+
+	COrdinalCube inverse = m_cube;
+	inverse.Invert();
+	p_lookups.inverseCube.SetState(inverse);
+	p_lookups.costs[InverseLookup] = InversePhase1Cost(p_lookups.inverseCube);
+}
+
+// 逆元のCubeのPhase 1の完成までの手数
+// twistとchoice，flipとchoiceのPruningTableの大きい方(正確なDepthを格納しているので，親ノードのコストは不要)
+int CIDAstarSearch::InversePhase1Cost(const CPackedCube& p_cube) const
+{
+	const int choice = p_cube.GetChoice();
+	return std::max(
+		(int)m_tables.m_twistAndChoicePruningTable.GetValue(m_tables.m_twistAndChoicePruningTable.GetIndex(p_cube.GetTwist(), choice)),
+		(int)m_tables.m_flipAndChoicePruningTable.GetValue(m_tables.m_flipAndChoicePruningTable.GetIndex(p_cube.GetFlip(), choice)));
+}
+
+// Phase 1の完成状態からPhase 2の解探索を行う
+// パイプライン探索ではキューに積むだけでPhase 2は探索しない
+int CIDAstarSearch::SearchPhase1Leaf(SSearchContext& p_context, const int p_depth)
+{
+	// 解法が見つかったから探索深さを保存
+	p_context.solutionLength1 = p_depth;
+
+	// Phase 1の解法の移動のうち，まだ追跡していない部分をPhase 2の座標のMoveTableで進める
+	// (Cubeを最初の状態から動かし直さず，1手あたり4回の参照で求める)
+	for (int depth = p_context.phase2CoordinatesDepth; depth < p_depth; depth++) {
+		const SPhase2Coordinates& current = p_context.phase2Coordinates[depth];
+		SPhase2Coordinates& next = p_context.phase2Coordinates[depth + 1];
+		const int move = CCube::GetMoveOfPower(p_context.solutionMoves1[depth], p_context.solutionPowers1[depth]);
+		next.cornerPermutation = m_tables.m_cornerPermutationMoveTable[current.cornerPermutation][move];
+		next.upDownEdgeSplit1 = m_tables.m_upDownEdgeSplit1MoveTable[current.upDownEdgeSplit1][move];
+		next.upDownEdgeSplit2 = m_tables.m_upDownEdgeSplit2MoveTable[current.upDownEdgeSplit2][move];
+		next.middleEdgePositions = m_tables.m_middleEdgePositionsMoveTable[current.middleEdgePositions][move];
+	}
+	p_context.phase2CoordinatesDepth = p_depth;
+
+	// ここでPhase1の完成状態
+	const SPhase2Coordinates& coordinates = p_context.phase2Coordinates[p_depth];
+	int cornerPermutation = coordinates.cornerPermutation;
+	int middleEdgePermutation = m_tables.m_phase2EntryTable.GetMiddleEdgePermutation(coordinates.middleEdgePositions);
+	int upDownEdgePermutation = m_tables.m_phase2EntryTable.GetUpDownEdgePermutation(
+		coordinates.upDownEdgeSplit1, coordinates.upDownEdgeSplit2, cornerPermutation, middleEdgePermutation);
+
+	if (m_numberOfPhase2Threads > 0) {
+		// Phase 1の解法とPhase 2の序数をキューに積む
+		SPhase1Solution solution;
+		for (int i = 0; i < p_context.solutionLength1; i++) {
+			solution.solutionMoves1[i] = p_context.solutionMoves1[i];
+			solution.solutionPowers1[i] = p_context.solutionPowers1[i];
+		}
+		solution.solutionLength1 = p_context.solutionLength1;
+		solution.cornerPermutation = cornerPermutation;
+		solution.upDownEdgePermutation = upDownEdgePermutation;
+		solution.middleEdgePermutation = middleEdgePermutation;
+		if (m_phase1Solutions.TryPush(solution)) {
+			return NOT_FOUND;
+		}
+		// キューが一杯のときは，Phase 2のスレッドに追いつかれるまでこのスレッドで探索する
+	}
+
+	// Phase2探索を始める
+	// タイマーCheck
+	if (m_timer->isTimeOut() || Solve2(p_context, cornerPermutation, upDownEdgePermutation, middleEdgePermutation) == TIME_OUT) {
+		return TIME_OUT;
+	}
+
+	// このCubeに対するPhase2探索終わり
+	return NOT_FOUND;
+}
+
+// パイプライン探索のPhase 2のスレッドで実行する関数
+// Phase 1の探索が終了してキューが空になるまで，キューのPhase 1の解法に対してPhase 2を探索する
+void CIDAstarSearch::RunPhase2Worker()
+{
+	SSearchContext context;
+	context.subtreeQueues = NULL;
+	SPhase1Solution solution;
+
+	while (true) {
+		// Phase 1の終了を先に確認してからキューを確認する
+		// (終了後はキューに積まれないので，空なら全て探索し終えている)
+		bool isPhase1Finished = m_isPhase1Finished.load();
+		if (!m_phase1Solutions.TryPop(solution)) {
+			if (isPhase1Finished) {
+				break;
+			}
+			std::this_thread::yield();
+			continue;
+		}
+
+		// タイムアウトしたら残りは読み捨てる
+		if (m_isPhase2TimedOut.load(std::memory_order_relaxed)) {
+			continue;
+		}
+
+		// 今までに見つかった解法より短くならなければ探索しない
+		if (solution.solutionLength1 >= m_solution.minSolutionLength.load(std::memory_order_relaxed) - 1) {
+			continue;
+		}
+
+		// Phase 1の解法を設定してPhase 2を探索する
+		for (int i = 0; i < solution.solutionLength1; i++) {
+			context.solutionMoves1[i] = solution.solutionMoves1[i];
+			context.solutionPowers1[i] = solution.solutionPowers1[i];
+		}
+		context.solutionLength1 = solution.solutionLength1;
+		if (m_timer->isTimeOut() || Solve2(context, solution.cornerPermutation,
+			solution.upDownEdgePermutation, solution.middleEdgePermutation) == TIME_OUT) {
+			// Phase 1の探索も終了させる
+			m_isPhase2TimedOut = true;
+			m_isStopped = true;
+		}
+	}
+}
+
+// Phase 1の探索をm_context.threshold1の閾値で1回分並列に行う
+int CIDAstarSearch::ParallelSearch1(const int p_twist, const int p_flip, const int p_choice, const int p_cost)
+{
+	// splitDepthまでは逐次探索して，部分木を各スレッドのキューに積む
+	std::vector<SWorkQueue> queues(m_numberOfThreads);
+	m_context.subtreeQueues = &queues;
+	m_context.numberOfSubtrees = 0;
+	int result = Search1(m_context, p_twist, p_flip, p_choice, 0, p_cost, CMoveSequenceAutomaton::InitialState, UnknownCost);
+	m_context.subtreeQueues = NULL;
+
+	// 分割する深さより浅い位置で探索が終了した
+	if (result != NOT_FOUND || m_context.numberOfSubtrees == 0) {
+		return result;
+	}
+
+	// 各スレッドの探索状態は現在の閾値から開始する
+	std::vector<SSearchContext> contexts(m_numberOfThreads, m_context);
+	std::vector<int> results(m_numberOfThreads, NOT_FOUND);
+	std::vector<std::thread> threads;
+	for (int i = 0; i < m_numberOfThreads; i++) {
+		contexts[i].nodes1 = 0;
+		for (int j = 0; j < NumberOfPhase1Lookups; j++) {
+			contexts[i].prunedNodes1[j] = 0;
+		}
+		contexts[i].nextThreshold1 = InitialSolutionLength;
+		threads.push_back(std::thread([this, &contexts, &queues, &results, i]() {
+			results[i] = RunWorker(contexts[i], queues, i);
+		}));
+	}
+	for (int i = 0; i < m_numberOfThreads; i++) {
+		threads[i].join();
+	}
+
+	// 各スレッドの結果をまとめる
+	// TIME_OUT > PHASE_1_FOUND > NOT_FOUND の順に優先する
+	// (ABORTは他のスレッドが探索を終了させたときにしか返らない)
+	for (int i = 0; i < m_numberOfThreads; i++) {
+		m_context.nodes1 += contexts[i].nodes1;
+		for (int j = 0; j < NumberOfPhase1Lookups; j++) {
+			m_context.prunedNodes1[j] += contexts[i].prunedNodes1[j];
+		}
+		if (contexts[i].nextThreshold1 < m_context.nextThreshold1) {
+			m_context.nextThreshold1 = contexts[i].nextThreshold1;
+		}
+		if (results[i] == TIME_OUT) {
+			result = TIME_OUT;
+		}
+		else if (results[i] == PHASE_1_FOUND && result != TIME_OUT) {
+			result = PHASE_1_FOUND;
+		}
+	}
+	return result;
+}
+
+// 並列探索の各スレッドで実行する関数
+// キューが全て空になるか，探索が終了するまで部分木を探索する
+int CIDAstarSearch::RunWorker(SSearchContext& p_context, std::vector<SWorkQueue>& p_queues, const int p_index)
+{
+	int result = NOT_FOUND;
+	SSubtree subtree;
+
+	while (!m_isStopped.load(std::memory_order_relaxed) && PopSubtree(p_queues, p_index, subtree)) {
+		// タイマーCheck
+		if (m_timer->isTimeOut()) {
+			result = TIME_OUT;
+			m_isStopped = true;
+			break;
+		}
+
+		// 部分木の根までの移動記号を設定して，根から探索する
+		for (int i = 0; i < m_splitDepth; i++) {
+			p_context.solutionMoves1[i] = subtree.solutionMoves1[i];
+			p_context.solutionPowers1[i] = subtree.solutionPowers1[i];
+		}
+		// Phase 2の座標は根(深さ0)から追跡し直す
+		p_context.phase2CoordinatesDepth = 0;
+		p_context.phase1LookupsDepth = 0;
+		result = Search1(p_context, subtree.twist, subtree.flip, subtree.choice, m_splitDepth, subtree.parentCost, subtree.sequenceState, UnknownCost);
+
+		if (result != NOT_FOUND) {
+			// PHASE_1_FOUND,TIME_OUTなら他のスレッドも止める
+			if (result != ABORT) {
+				m_isStopped = true;
+			}
+			break;
+		}
+	}
+	return result;
+}
+
+// 部分木を1つ取り出す
+// 自分のキューが空なら，他のスレッドのキューの末尾から盗む
+bool CIDAstarSearch::PopSubtree(std::vector<SWorkQueue>& p_queues, const int p_index, SSubtree& subtree)
+{
+	int numberOfQueues = (int)p_queues.size();
+	for (int i = 0; i < numberOfQueues; i++) {
+		SWorkQueue& queue = p_queues[(p_index + i) % numberOfQueues];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.subtrees.empty()) {
+			continue;
+		}
+		if (i == 0) {
+			// 自分のキューは先頭から取り出す
+			subtree = queue.subtrees.front();
+			queue.subtrees.pop_front();
+		}
+		else {
+			// 他のスレッドのキューは末尾から盗む
+			subtree = queue.subtrees.back();
+			queue.subtrees.pop_back();
+		}
+		return true;
+	}
+	return false;
+}
+
 // Phase 2の解探索を開始する
-int CIDAstarSearch::Solve2(COrdinalCube& cube)
+int CIDAstarSearch::Solve2(SSearchContext& p_context, const int p_cornerPermutation, const int p_upDownEdgePermutation, const int p_middleEdgePermutation)
 {
 	int iteration = 1;	// 反復回数
 	int result = NOT_FOUND;
@@ -331,28 +796,30 @@ int CIDAstarSearch::Solve2(COrdinalCube& cube)
 	// とりあえず，今の状態からPhase2の推定コストを計算する
 	// コストは大きめの値が計算されるようになっている(ヒューリスティック関数)
 	// 小さいほど完成状態に近い
-	m_threshold2 = Phase2Cost(
-		cube.GetOrdinalFromCornerPermutation(),
-		cube.GetOrdinalFromUpDownEdgePermutation(),
-		cube.GetOrdinalFromMiddleEdgePermutation()
-		);
+	int costs[NumberOfPhase2PruningTables];
+	p_context.threshold2 = Phase2RootCost(p_cornerPermutation, p_upDownEdgePermutation, p_middleEdgePermutation, costs);
 
-	m_nodes2 = 1;		// 今のノード
-	m_solutionLength2 = 0;
+	p_context.nodes2 = 1;		// 今のノード
+	p_context.solutionLength2 = 0;
+	p_context.nearSolvedLength = 0;
 
 	do{
-		m_nextThreshold2 = InitialSolutionLength;	// コストを大きな値にする
+		p_context.nextThreshold2 = InitialSolutionLength;	// コストを大きな値にする
 
 		// 現在のCubeの状態に対して，深さ0のIDA*探索を開始する
 		result = Search2(
-			cube.GetOrdinalFromCornerPermutation(),
-			cube.GetOrdinalFromUpDownEdgePermutation(),
-			cube.GetOrdinalFromMiddleEdgePermutation(),
-			0
+			p_context,
+			p_cornerPermutation,
+			p_upDownEdgePermutation,
+			p_middleEdgePermutation,
+			0,
+			costs,
+			CMoveSequenceAutomaton::InitialState,
+			NULL
 			);
 
 		// 閾値をより浅くして探索する
-		m_threshold2 = m_nextThreshold2;
+		p_context.threshold2 = p_context.nextThreshold2;
 
 		// 反復回数を増やす
 		iteration++;
@@ -369,24 +836,33 @@ int CIDAstarSearch::Solve2(COrdinalCube& cube)
 	return result;
 }
 
-int CIDAstarSearch::Search2(const int p_cornerPermutation, const int p_upDownEdgePermutation, const int p_middleEdgePermutation, const int p_depth)
+int CIDAstarSearch::Search2(SSearchContext& p_context, const int p_cornerPermutation, const int p_upDownEdgePermutation, const int p_middleEdgePermutation, const int p_depth, const int* p_parentCosts, const int p_sequenceState, const int* p_knownCosts)
 {
 	// 合計コスト
 	int totalCost;
 
 	// 完成までのコストを計算
-	int cost = Phase2Cost(p_cornerPermutation, p_upDownEdgePermutation, p_middleEdgePermutation);
+	// 各PruningTableのコストは子ノードのコストを求めるために保存する
+	// (子ノードの並べ替えで親ノードが求めていれば，PruningTableを引き直さない)
+	int costs[NumberOfPhase2PruningTables];
+	int cost;
+	if (p_knownCosts != NULL) {
+		for (int i = 0; i < NumberOfPhase2PruningTables; i++) {
+			costs[i] = p_knownCosts[i];
+		}
+		cost = std::max(costs[0], std::max(costs[1], costs[2]));
+	}
+	else {
+		cost = Phase2Cost(p_cornerPermutation, p_upDownEdgePermutation, p_middleEdgePermutation, p_parentCosts, costs);
+	}
 
 	if (cost == 0){	// 解法が見つかりました
 		// 解法が見つかったから探索深さを保存
-		m_solutionLength2 = p_depth;
-		// 今までの解法より短かったら一番短い解法の長さ(minSolutionLength)を更新しておく
-		if (m_solutionLength1 + m_solutionLength2 < m_minSolutionLength) {
-			m_minSolutionLength = m_solutionLength1 + m_solutionLength2;
-		}
+		p_context.solutionLength2 = p_depth;
 		// Phase1とPhase2が完成したから表示
 		// スタックする
-		PrintAndStackSolution();
+		// 今までの解法より短かったら一番短い解法の長さ(minSolutionLength)も更新しておく
+		PrintAndStackSolution(p_context);
 
 		return PHASE_2_FOUND;
 	}
@@ -405,18 +881,50 @@ int CIDAstarSearch::Search2(const int p_cornerPermutation, const int p_upDownEdg
 	// threshold2：
 	// 1回目の探索では，初めの状態よりヒューリスティック関数で計算
 	// n+1回目の探索以降では，n回目のtotalCostのうち最小のもの(newThreshold2)を用いる
-	if (totalCost <= m_threshold2){
+	if (totalCost <= p_context.threshold2){
 		// ノードの探索を行う
 		// minSolutionLength : 今まで見つかった解放のうち一番短いものの長さ
 		// 探索の深さがminSolutionLengthを超えてたら探索する意味がないのでreturn
-		if (m_solutionLength1 + p_depth >= m_minSolutionLength - 1) {
+		if (p_context.solutionLength1 + p_depth >= m_solution.minSolutionLength.load(std::memory_order_relaxed) - 1) {
 			return ABORT;
 		}
 
+		// 残りの深さが完成付近のデータベースの手数N以下なら，再帰せずに表を引く
+		// 表に無ければ完成までN + 1手以上かかるので，この閾値では見つからない
+		const CNearSolvedDatabase& database = m_tables.m_nearSolvedDatabase;
+		if (p_context.threshold2 - p_depth <= database.GetDepth()) {
+			int distance = database.GetDistance(p_cornerPermutation, p_upDownEdgePermutation, p_middleEdgePermutation);
+			if (distance == CNearSolvedDatabase::NotFound) {
+				distance = database.GetDepth() + 1;
+			}
+			if (p_depth + distance <= p_context.threshold2) {
+				// 表の最短の解法を末尾に続けて出力する
+				p_context.solutionLength2 = p_depth;
+				p_context.nearSolvedLength = database.GetSolution(
+					p_cornerPermutation, p_upDownEdgePermutation, p_middleEdgePermutation, p_context.nearSolvedMoves);
+				PrintAndStackSolution(p_context);
+				return PHASE_2_FOUND;
+			}
+			if (p_depth + distance < p_context.nextThreshold2) {
+				p_context.nextThreshold2 = p_depth + distance;
+			}
+			return NOT_FOUND;
+		}
+
+		// 子ノードをheuristicコストの小さい順に探索する
+		// (子ノードがすぐに探索を打ち切る深さでは，全ての子ノードのコストを求めても無駄になるので通常の順に探索する)
+		if (m_isChildOrdering && p_context.solutionLength1 + p_depth + 1 < m_solution.minSolutionLength.load(std::memory_order_relaxed) - 1) {
+			return SearchOrderedChildren2(p_context, p_cornerPermutation, p_upDownEdgePermutation, p_middleEdgePermutation, p_depth, costs, p_sequenceState);
+		}
+
+		// 冗長な移動列にならない移動(Phase 2の移動以外は含まない)
+		const CMoveSequenceAutomaton& sequences = m_tables.m_phase2MoveSequences;
+		const uint32_t allowedMoves = sequences.GetAllowedMoves(p_sequenceState);
+
 		// 6種類の移動に対して
 		for (int move = CCube::Move::U; move <= CCube::Move::B; move++){
 			// 意味の無い動きは除外
-			if (IsNotAllowed(move, m_solutionMoves2, p_depth)) continue;
+			if (!(allowedMoves & CMoveSequenceAutomaton::GetFaceMoves(move))) continue;
 
 			// 現在の状態
 			int cornerPermutation2 = p_cornerPermutation;
@@ -424,7 +932,7 @@ int CIDAstarSearch::Search2(const int p_cornerPermutation, const int p_upDownEdg
 			int middleEdgePermutation2 = p_middleEdgePermutation;
 			
 			// 移動指令を保存
-			m_solutionMoves2[p_depth] = move;
+			p_context.solutionMoves2[p_depth] = move;
 
 			int powerLimit = 4;	// "FBLR"は反時計，時計周りの移動ができる
 			if (move != CCube::Move::U && move != CCube::Move::D) {
@@ -434,21 +942,25 @@ int CIDAstarSearch::Search2(const int p_cornerPermutation, const int p_upDownEdg
 			// 状態遷移を行う
 			// powerは移動の反復回数(FBLRは3回まで，UDは2回だけ)
 			for (int power = 1; power < powerLimit; power++){
+				// "FBLR"は180[deg]回転のみなので，power = 1をL2,R2,F2,B2の移動として扱う
+				int move2 = TranslateMove(move, power, true);
+				if (!(allowedMoves & (1u << move2))) continue;
+
 				// 移動指令の反復回数を保存
-				m_solutionPowers2[p_depth] = power;
+				p_context.solutionPowers2[p_depth] = power;
 				// 状態遷移
 				// ex:現在の状態(cornerPermutation2, nonMiddleSliceEdgePermutation2, middleSliceEdgePermutation2て表現)に移動moveを作用させるとどのような状態に遷移するかを取得する
-				cornerPermutation2 = m_cornerPermutationMoveTable[cornerPermutation2][move];
-				upDownEdgePermutation2 = m_upDownEdgePermutationMoveTable[upDownEdgePermutation2][move];
-				middleEdgePermutation2 = m_middleEdgePermutationMoveTable[middleEdgePermutation2][move];
+				cornerPermutation2 = m_tables.m_cornerPermutationMoveTable[p_cornerPermutation][move2];
+				upDownEdgePermutation2 = m_tables.m_upDownEdgePermutationMoveTable[p_upDownEdgePermutation][move2];
+				middleEdgePermutation2 = m_tables.m_middleEdgePermutationMoveTable[p_middleEdgePermutation][move2];
 				// ノードを増やす
-				m_nodes2++;
+				p_context.nodes2++;
 
 				// 今の状態を起点に，深さを増やして探索
 				// PHASE_2_FOUND,ABORTだったら探索終了
 				// NOT_FOUNDだったらさらに探索を続ける
 				int result;
-				if (result = Search2(cornerPermutation2, upDownEdgePermutation2, middleEdgePermutation2, p_depth + 1)) {
+				if (result = Search2(p_context, cornerPermutation2, upDownEdgePermutation2, middleEdgePermutation2, p_depth + 1, costs, sequences.GetNextState(p_sequenceState, move2), NULL)) {
 					return result;
 				}
 			}
@@ -458,96 +970,218 @@ int CIDAstarSearch::Search2(const int p_cornerPermutation, const int p_upDownEdg
 		// 今のコストで最小閾値を更新する
 		// ただし，threshold2は現在の閾値なので，現在の閾値を基準とした探索が終わるまでは
 		// 変更しないようにする -> newThreshold2に最小コストを保存しておく
-		if (totalCost < m_nextThreshold2) {
-			m_nextThreshold2 = totalCost;
+		if (totalCost < p_context.nextThreshold2) {
+			p_context.nextThreshold2 = totalCost;
 		}
 	}
 
 	return NOT_FOUND;
 }
 
+// Phase 2の子ノードをheuristicコストの小さい順に探索する
+int CIDAstarSearch::SearchOrderedChildren2(SSearchContext& p_context, const int p_cornerPermutation, const int p_upDownEdgePermutation, const int p_middleEdgePermutation, const int p_depth, const int* p_costs, const int p_sequenceState)
+{
+	const CMoveSequenceAutomaton& sequences = m_tables.m_phase2MoveSequences;
+	const uint32_t allowedMoves = sequences.GetAllowedMoves(p_sequenceState);
+
+	// 全ての子ノードの序数とコストを先に求める
+	SChild children[CCube::NumberOfMoves];
+	int numberOfChildren = 0;
+	for (int move = CCube::Move::U; move <= CCube::Move::B; move++) {
+		if (!(allowedMoves & CMoveSequenceAutomaton::GetFaceMoves(move))) continue;
+
+		// "UD"は3種類，"FBLR"は180[deg]回転のみ
+		const int powerLimit = (move == CCube::Move::U || move == CCube::Move::D) ? 4 : 2;
+		for (int power = 1; power < powerLimit; power++) {
+			SChild& child = children[numberOfChildren];
+			child.move = move;
+			child.power = power;
+			child.move2 = TranslateMove(move, power, true);
+			if (!(allowedMoves & (1u << child.move2))) continue;
+
+			child.ordinals[0] = m_tables.m_cornerPermutationMoveTable[p_cornerPermutation][child.move2];
+			child.ordinals[1] = m_tables.m_upDownEdgePermutationMoveTable[p_upDownEdgePermutation][child.move2];
+			child.ordinals[2] = m_tables.m_middleEdgePermutationMoveTable[p_middleEdgePermutation][child.move2];
+			child.cost = Phase2Cost(child.ordinals[0], child.ordinals[1], child.ordinals[2], p_costs, child.costs);
+			p_context.nodes2++;
+
+			// 閾値を超える子ノードは，子ノードで閾値判定を行うのと同じく次の閾値だけ更新して探索しない
+			const int totalCost = p_depth + 1 + child.cost;
+			if (child.cost > 0 && totalCost > p_context.threshold2) {
+				if (totalCost < p_context.nextThreshold2) {
+					p_context.nextThreshold2 = totalCost;
+				}
+				continue;
+			}
+			numberOfChildren++;
+		}
+	}
+
+	// 子ノードのコストは親ノードのコストと1以内しか違わないので(各PruningTableが1以内しか違わない)，
+	// コストごとに3回走査すれば，並べ替えずに小さい順(同じコストは移動の順)に探索できる
+	const int cost = std::max(p_costs[0], std::max(p_costs[1], p_costs[2]));
+	for (int childCost = cost - 1; childCost <= cost + 1; childCost++) {
+		for (int i = 0; i < numberOfChildren; i++) {
+			const SChild& child = children[i];
+			if (child.cost != childCost) continue;
+
+			p_context.solutionMoves2[p_depth] = child.move;
+			p_context.solutionPowers2[p_depth] = child.power;
+
+			// 子ノードのコストは求め済みなので，PruningTableを引き直さない
+			const int result = Search2(p_context, child.ordinals[0], child.ordinals[1], child.ordinals[2], p_depth + 1, p_costs, sequences.GetNextState(p_sequenceState, child.move2), child.costs);
+			if (result != NOT_FOUND) {
+				return result;
+			}
+		}
+	}
+	return NOT_FOUND;
+}
+
 // Phase 1のheuristicコスト関数
-int CIDAstarSearch::Phase1Cost(const int p_twist, const int p_flip, const int p_choice) const
+int CIDAstarSearch::Phase1Cost(const int p_twist, const int p_flip, const int p_choice, const int p_parentCost) const
 {
-	// 3つのうち一番大きな値をコスト関数として採用する
+	// twistとflipsliceの同値類のPruningTableはPhase 1の完成までの正確な手数になる
 	// 最適解を見つけるためにはヒューリスティック関数は「楽観的」でなければならない
-	int cost = m_twistAndFlipPruningTable.GetValue(p_twist * m_flipMoveTable.GetSize() + p_flip);
-	int cost2 = m_twistAndChoicePruningTable.GetValue(p_twist * m_choiceMoveTable.GetSize() + p_choice);
-	if (cost2 > cost) cost = cost2;
-	cost2 = m_flipAndChoicePruningTable.GetValue(p_flip * m_choiceMoveTable.GetSize() + p_choice);
-	if (cost2 > cost) cost = cost2;
-	return cost;
+	const CTwistAndFlipSlicePruningTable& table = m_tables.m_twistAndFlipSlicePruningTable;
+	return table.GetDepth(table.GetIndex(p_twist, p_flip, p_choice), p_parentCost);
+}
+
+// 探索の根のPhase 1のheuristicコスト関数
+int CIDAstarSearch::Phase1RootCost(const int p_twist, const int p_flip, const int p_choice) const
+{
+	typedef std::array<int, 3> State;	// twist, flip, choice
+	const CTwistAndFlipSlicePruningTable& table = m_tables.m_twistAndFlipSlicePruningTable;
+	State state = {{ p_twist, p_flip, p_choice }};
+	return table.GetRootDepth(state, false,
+		[&](const State& p_state) {
+			return table.GetIndex(p_state[0], p_state[1], p_state[2]);
+		},
+		[&](const State& p_state, const int p_move) {
+			State state2 = {{ m_tables.m_twistMoveTable[p_state[0]][p_move],
+				m_tables.m_flipMoveTable[p_state[1]][p_move], m_tables.m_choiceMoveTable[p_state[2]][p_move] }};
+			return state2;
+		});
 }
 
 // Phase 2のheuristicコスト関数
-int CIDAstarSearch::Phase2Cost(const int p_cornerPermutation, const int p_upDownEdgePermutation, const int p_middleEdgePermutation) const
+int CIDAstarSearch::Phase2Cost(const int p_cornerPermutation, const int p_upDownEdgePermutation, const int p_middleEdgePermutation, const int* p_parentCosts, int* p_costs) const
 {
-	// 2つのうち一番大きな値をコスト関数として採用する
+	// 3つのうち一番大きな値をコスト関数として採用する
 	// 最適解を見つけるためにはヒューリスティック関数は「楽観的」でなければならない
-	// middleはあまり使う意味がないので使わない
-	int cost = m_cornerAndUpDownPruningTable.GetValue(p_cornerPermutation * m_middleEdgePermutationMoveTable.GetSize() + p_middleEdgePermutation);
-	int cost2 = m_upDownAndMiddlePruningTable.GetValue(p_upDownEdgePermutation * m_middleEdgePermutationMoveTable.GetSize() + p_middleEdgePermutation);
-	if (cost2 > cost) cost = cost2;
-	return cost;
+	const CCornerAndUpDownPruningTable& table = m_tables.m_cornerAndUpDownPruningTable;
+	p_costs[0] = table.GetDepth(table.GetIndex(p_cornerPermutation, p_upDownEdgePermutation), p_parentCosts[0]);
+	p_costs[1] = m_tables.m_cornerAndMiddlePruningTable.GetDepth(
+		m_tables.m_cornerAndMiddlePruningTable.GetIndex(p_cornerPermutation, p_middleEdgePermutation), p_parentCosts[1]);
+	p_costs[2] = m_tables.m_upDownAndMiddlePruningTable.GetDepth(
+		m_tables.m_upDownAndMiddlePruningTable.GetIndex(p_upDownEdgePermutation, p_middleEdgePermutation), p_parentCosts[2]);
+	return std::max(p_costs[0], std::max(p_costs[1], p_costs[2]));
 }
 
-// 冗長な移動を除外する
-bool CIDAstarSearch::IsNotAllowed(const int p_move, const int* p_solutionMoves, const int p_depth) const
+// 2つの序数を組み合わせたPruningTableについて，探索の根のコストを求める
+template <class TPruningTable, class TMoveTable1, class TMoveTable2>
+static int GetPairRootCost(const TPruningTable& p_table, const TMoveTable1& p_moveTable1, const TMoveTable2& p_moveTable2, const int p_ordinal1, const int p_ordinal2)
 {
-	// 1つ前の移動を確認する
-	if (p_depth >= 1){
-		// 連続した移動はできない (ex. UU は U で power = 3 にしないといけない)
-		if (p_solutionMoves[p_depth - 1] == p_move) {
-			return true;
-		}
+	typedef std::array<int, 2> State;	// 2つの序数
+	State state = {{ p_ordinal1, p_ordinal2 }};
+	return p_table.GetRootDepth(state, true,
+		[&](const State& p_state) {
+			return p_table.GetIndex(p_state[0], p_state[1]);
+		},
+		[&](const State& p_state, const int p_move) {
+			State state2 = {{ p_moveTable1[p_state[0]][p_move], p_moveTable2[p_state[1]][p_move] }};
+			return state2;
+		});
+}
 
-		// "F B", "R L", "U D"だけできるようにしておく
-		// これと等価な"B F", "L R", "D U"の移動はできない
-		if ((p_move == CCube::Move::F) && p_solutionMoves[p_depth - 1] == CCube::Move::B) {
-			return true;
-		}
-		if ((p_move == CCube::Move::R) && p_solutionMoves[p_depth - 1] == CCube::Move::L) {
-			return true;
+// 探索の根のPhase 2のheuristicコスト関数
+int CIDAstarSearch::Phase2RootCost(const int p_cornerPermutation, const int p_upDownEdgePermutation, const int p_middleEdgePermutation, int* p_costs) const
+{
+	p_costs[0] = GetPairRootCost(m_tables.m_cornerAndUpDownPruningTable,
+		m_tables.m_cornerPermutationMoveTable, m_tables.m_upDownEdgePermutationMoveTable, p_cornerPermutation, p_upDownEdgePermutation);
+	p_costs[1] = GetPairRootCost(m_tables.m_cornerAndMiddlePruningTable,
+		m_tables.m_cornerPermutationMoveTable, m_tables.m_middleEdgePermutationMoveTable, p_cornerPermutation, p_middleEdgePermutation);
+	p_costs[2] = GetPairRootCost(m_tables.m_upDownAndMiddlePruningTable,
+		m_tables.m_upDownEdgePermutationMoveTable, m_tables.m_middleEdgePermutationMoveTable, p_upDownEdgePermutation, p_middleEdgePermutation);
+	return std::max(p_costs[0], std::max(p_costs[1], p_costs[2]));
+}
+
+void CIDAstarSearch::PrintAndStackSolution(const SSearchContext& p_context)
+{
+	std::lock_guard<std::mutex> lock(m_solution.mutex);
+
+	// 他のスレッドが既に同じ長さ以下の解法を見つけていたら何もしない
+	const int solutionLength = p_context.solutionLength1 + p_context.solutionLength2 + p_context.nearSolvedLength;
+	if (solutionLength >= m_solution.minSolutionLength) {
+		return;
+	}
+	m_solution.minSolutionLength = solutionLength;
+
+	// 最初の解法が見つかるまでの時間を記録する
+	// (完成付近のデータベースで探索せずに見つけたときは0)
+	if (m_solution.firstSolutionTime < 0) {
+		m_solution.firstSolutionTime = (m_timer != NULL) ? m_timer->getElapsedTime() : 0;
+        emit notifySolverMessage("Time to first solution = " + QString::number(m_solution.firstSolutionTime / 1000.0) + " ms");
+	}
+
+	// 無駄な移動を簡単にしてから表示する
+	std::vector<int> moves1, moves2;
+	for (int i = 0; i < p_context.solutionLength1; i++) {
+		moves1.push_back(TranslateMove(p_context.solutionMoves1[i], p_context.solutionPowers1[i], false));
+	}
+	for (int i = 0; i < p_context.solutionLength2; i++) {
+		moves2.push_back(TranslateMove(p_context.solutionMoves2[i], p_context.solutionPowers2[i], true));
+	}
+	for (int i = 0; i < p_context.nearSolvedLength; i++) {
+		moves2.push_back(p_context.nearSolvedMoves[i]);
+	}
+
+	// 逆元のCubeの解法は，逆順にして各移動を反対方向にすると元のCubeの解法になる
+	// (Phase 2の解法が先になる)
+	if (m_isInverse) {
+		std::vector<int> inverse1, inverse2;
+		for (int i = (int)moves2.size() - 1; i >= 0; i--) {
+			inverse1.push_back(CCube::GetInverseOfMove(moves2[i]));
 		}
-		if ((p_move == CCube::Move::U) && p_solutionMoves[p_depth - 1] == CCube::Move::D) {
-			return true;
+		for (int i = (int)moves1.size() - 1; i >= 0; i--) {
+			inverse2.push_back(CCube::GetInverseOfMove(moves1[i]));
 		}
+		moves1.swap(inverse1);
+		moves2.swap(inverse2);
+	}
 
-		// ある面の移動2回で，その反対側の面の移動を挟んだ移動はできない
-		// ex."F B F" -> "F2 B", "B F2"と同じ
-		//    "D U D" -> "D2 U", "U D2"と同じ
-		if ((p_depth >= 2) && p_solutionMoves[p_depth - 2] == p_move && p_solutionMoves[p_depth - 1] == CCube::GetOpposingFace(p_move)) {
-			return true;
+	// 対称変換したCubeの解法は，逆変換で元のCubeの解法になる
+	if (m_symmetry != 0) {
+		int inverseSymmetry = CSymmetry::GetInverseSymmetry(m_symmetry);
+		for (size_t i = 0; i < moves1.size(); i++) {
+			moves1[i] = CSymmetry::ConjugateMove(inverseSymmetry, moves1[i]);
+		}
+		for (size_t i = 0; i < moves2.size(); i++) {
+			moves2[i] = CSymmetry::ConjugateMove(inverseSymmetry, moves2[i]);
 		}
 	}
-	return false;	// 移動に問題なし
-}
 
-void CIDAstarSearch::PrintAndStackSolution()
-{
 	std::stringstream ss;
 	ss.clear();
 
-	ss << m_solutionLength1 + m_solutionLength2 << " ";
+	ss << solutionLength << " ";
 
-	for (int i = 0; i < m_solutionLength1; i++) {
-		// 無駄な移動を簡単にしてから表示する
+	for (size_t i = 0; i < moves1.size(); i++) {
 		//std::cout << CCube::NameOfMove(TranslateMove(solutionMoves1[i], solutionPowers1[i], false)) << " ";
-		ss << CCube::GetNameOfMove(TranslateMove(m_solutionMoves1[i], m_solutionPowers1[i], false)) << " ";
+		ss << CCube::GetNameOfMove(moves1[i]) << " ";
 	}
 
     //std::cout << ". ";
 	ss << ". ";
 
-	for (int i = 0; i < m_solutionLength2; i++) {
-		// 無駄な移動を簡単にしてから表示する
+	for (size_t i = 0; i < moves2.size(); i++) {
 		//std::cout << CCube::NameOfMove(TranslateMove(solutionMoves2[i], solutionPowers2[i], true)) << " ";
-		ss << CCube::GetNameOfMove(TranslateMove(m_solutionMoves2[i], m_solutionPowers2[i], true)) << " ";
+		ss << CCube::GetNameOfMove(moves2[i]) << " ";
 	}
     //std::cout << "(" << solutionLength1 + solutionLength2 << ")" << std::endl;
 
     emit notifySolverMessage(QString::fromStdString(ss.str()).trimmed());
-    m_solutionStack.push_back(QString::fromStdString(ss.str()).trimmed().toStdString());
+    m_solution.solutionStack.push_back(QString::fromStdString(ss.str()).trimmed().toStdString());
 }
 
 int CIDAstarSearch::TranslateMove(const int p_move, int p_power,  const bool p_phase2) const
@@ -42,12 +42,17 @@
 
 #include <vector>
 #include <string>
+#include <deque>
+#include <mutex>
+#include <atomic>
 #include <QObject>
 
 #include "ordinalcube.h"
-#include "submovetable.h"
-#include "pruningtable.h"
+#include "solvertables.h"
 #include "timer.h"
+#include "lockfreequeue.h"
+#include "symmetry.h"
+#include "packedcube.h"
 
 class CIDAstarSearch : public QObject
 {
@@ -61,7 +66,9 @@ signals:
     void notifySolverMessage(QString p_message);
 
 public:
-	CIDAstarSearch();
+	// 初期化済みのTableを共有して探索を行う
+	// Tableは探索オブジェクトより長く生存していなければならない
+	CIDAstarSearch(CSolverTables& p_tables);
 	~CIDAstarSearch();
 
 	enum 
@@ -73,63 +80,306 @@ public:
 		TIME_OUT	// タイムアウト
 	};
 
-	// MoveTable,PruningTableを初期化する
-	void InitializeTables();
-
 	// Two Phase Algorithmによる解探索を開始する
+	// 呼び出すたびに前回の解探索の結果は破棄される
 	int Solve(const COrdinalCube &p_scrambledCube, int64_t p_timeOut);
 
 	// m_solutionStackの最新の解をreturnする
 	std::string GetSolution() const;
 
+	// Phase 1の並列探索の設定
+	// p_numberOfThreads : 探索に用いるスレッド数(1以下なら逐次探索)
+	// p_splitDepth      : 探索木を部分木に分割する深さ
+	void SetParallelSearch(const int p_numberOfThreads, const int p_splitDepth);
+
+	// Phase 1とPhase 2のパイプライン探索の設定
+	// Phase 1の完成状態をキューに積み，p_numberOfPhase2Threads個のスレッドでPhase 2を探索する
+	// p_numberOfPhase2Threads : Phase 2の探索に用いるスレッド数(0ならPhase 1の探索中に同期してPhase 2を探索する)
+	void SetPipelinedSearch(const int p_numberOfPhase2Threads);
+
+	// 軸・逆元のポートフォリオ探索の設定
+	// U-D, F-B, R-Lの各軸を基準にしたCubeと，その逆元のCubeの6通りを同時に探索する
+	// 6つの探索は解法の最短長さを共有し，見つかった解法は元のCubeの解法に変換して保存する
+	// 並列探索・パイプライン探索のスレッド数は6つの探索で分け合う
+	void SetPortfolioSearch(const bool p_isPortfolio);
+
+	// Phase 1の複数lookupの設定
+	// Phase 1の探索中に，他の2軸を基準にした対称変換のCubeと逆元のCubeの状態も追跡し，
+	// それぞれのPhase 1の完成までの手数の最大値で，今までの解法より短くならない部分木を刈り込む
+	// (どれも完成までの手数の下限なので，解法の長さの上限に対してのみ用いる)
+	void SetMultiLookupHeuristic(const bool p_isMultiLookup);
+
+	// 子ノードの並べ替えの設定
+	// 各ノードで全ての子ノードの序数とheuristicコストを先に求め，コストの小さい順に探索する
+	// (閾値を超える子ノードは探索しない)
+	// 閾値ごとに探索するノードは変わらず，解法が見つかる順番だけが変わる
+	void SetChildOrdering(const bool p_isChildOrdering);
+
+	// 最初の解法が見つかるまでの時間[us] (見つかっていなければ-1)
+	int64_t GetFirstSolutionTime() const { return m_solution.firstSolutionTime; }
+
 private:
 	enum { InitialSolutionLength = 10000 };	// 解法長さの最大値
+	enum { MaxSolutionLength = 32 };	// 1つのPhaseの解法長さの最大値
+	enum { Phase1SolutionQueueSize = 1024 };	// パイプライン探索のキューの容量
+	enum { NumberOfPortfolioSearches = 2 * CSymmetry::NumberOfAxes };	// ポートフォリオ探索の探索数
+	enum { NumberOfPhase2PruningTables = 3 };	// Phase 2のheuristic関数に用いるPruningTableの数
+	enum { UnknownCost = -1 };	// 親ノードでコストを求めていない
+
+	// 子ノードの並べ替えで，先に求めた子ノードの移動と状態
+	struct SChild
+	{
+		int move, power;	// 移動記号と反復回数
+		int move2;	// MoveTableの移動(CCube::Move)
+		int ordinals[3];	// 子ノードの序数(Phase 1 : twist, flip, choice, Phase 2 : Cornerの順列, Up層・Down層のEdgeの順列, Middle層のEdgeの順列)
+		int cost;	// heuristicコスト
+		int costs[NumberOfPhase2PruningTables];	// 各PruningTableのコスト(Phase 2のみ)
+	};
+
+	// Phase 1の追加のlookupの種類
+	enum
+	{
+		AxisLookup1 = 0,	// U-D軸をURF3で1回移した対称変換のCube
+		AxisLookup2,	// U-D軸をURF3で2回移した対称変換のCube
+		InverseLookup,	// 逆元のCube
+		NumberOfPhase1Lookups,
+		NumberOfAxisLookups = InverseLookup
+	};
+
+	// 全スレッド(ポートフォリオ探索では全ての探索)で共有する解法
+	struct SSolution
+	{
+		std::atomic<int> minSolutionLength;	// 今まで見つかった解法のうち一番短いものの長さ
+		int64_t firstSolutionTime;	// 最初の解法が見つかるまでの時間[us]
+		std::mutex mutex;	// solutionStackとminSolutionLengthの更新を保護する
+		std::vector<std::string> solutionStack;	// Solutionを保存するStack
+	};
+
+	// 並列探索で各スレッドに割り当てるPhase 1の部分木
+	// 部分木の根までの移動記号と，根の状態を保存する
+	struct SSubtree
+	{
+		int solutionMoves1[MaxSolutionLength];	// 根までの移動記号
+		int solutionPowers1[MaxSolutionLength];	// 根までの移動記号の反復回数
+		int twist, flip, choice;	// 根の状態
+		int parentCost;	// 根の親ノードのPhase 1のコスト
+		int sequenceState;	// 根までの移動列のオートマトンの状態
+	};
+
+	// スレッドごとの部分木のキュー
+	// 自分のキューは先頭から取り出し，空になったら他のスレッドのキューの末尾から盗む
+	struct SWorkQueue
+	{
+		std::mutex mutex;
+		std::deque<SSubtree> subtrees;
+	};
+
+	// パイプライン探索でPhase 1からPhase 2に渡す解法
+	// Phase 1の移動記号と，Phase 1完成状態におけるPhase 2の序数を保存する
+	struct SPhase1Solution
+	{
+		int solutionMoves1[MaxSolutionLength];	// Phase 1の移動記号
+		int solutionPowers1[MaxSolutionLength];	// Phase 1の移動記号の反復回数
+		int solutionLength1;	// Phase 1の解法の長さ
+		int cornerPermutation, upDownEdgePermutation, middleEdgePermutation;	// Phase 2の序数
+	};
+
+	// Phase 1の探索中に追跡するPhase 2の座標
+	// (Phase 1の完成状態で，CPhase2EntryTableからPhase 2の序数を求める)
+	struct SPhase2Coordinates
+	{
+		int cornerPermutation;	// Cornerの順列の序数
+		int upDownEdgeSplit1, upDownEdgeSplit2;	// UF,UL,UBとUR,DF,DLの位置の序数
+		int middleEdgePositions;	// Middle層のEdgeの位置の序数
+	};
+
+	// Phase 1の探索中に追跡する，追加のlookupのCubeの状態
+	struct SPhase1Lookups
+	{
+		int twist[NumberOfAxisLookups], flip[NumberOfAxisLookups], choice[NumberOfAxisLookups];	// 対称変換のCubeの序数
+		CPackedCube inverseCube;	// 逆元のCube(移動を先に行うので，序数のMoveTableでは追跡できない)
+		int costs[NumberOfPhase1Lookups];	// 各lookupのPhase 1の完成までの手数
+	};
+
+	// 1スレッド分のIDA*探索で使用する変数
+	// 並列探索ではスレッドごとに1つずつ用意する
+	struct SSearchContext
+	{
+		int nodes1, nodes2;	// 現在のノード数
+		int threshold1, threshold2;	// 合計コストの足きり基準(cutoff)
+		int nextThreshold1, nextThreshold2;	// 次の探索で用いる足きり基準を保存する変数
+
+		int solutionMoves1[MaxSolutionLength], solutionMoves2[MaxSolutionLength];	// 移動記号
+		int solutionPowers1[MaxSolutionLength], solutionPowers2[MaxSolutionLength];	// 移動記号の反復回数
+		int solutionLength1, solutionLength2;	// 解法の長さ
+
+		// Phase 1の各深さのPhase 2の座標
+		// 深さdの座標はsolutionMoves1[0 ~ d - 1]の移動を行った状態で，phase2CoordinatesDepth以下の深さのみ有効
+		// (移動記号を書き換えたら有効な深さを下げ，Phase 1の完成状態に達したときだけMoveTableで先に進める)
+		SPhase2Coordinates phase2Coordinates[MaxSolutionLength + 1];
+		int phase2CoordinatesDepth;
+
+		// Phase 1の各深さの追加のlookupの状態(Phase 2の座標と同じく，phase1LookupsDepth以下の深さのみ有効)
+		SPhase1Lookups phase1Lookups[MaxSolutionLength + 1];
+		int phase1LookupsDepth;
+		int prunedNodes1[NumberOfPhase1Lookups];	// 各lookupで刈り込んだノード数
+
+		// Phase 2の末端で完成付近のデータベースから求めた残りの解法
+		// (Phase 2の移動記号の後に続ける，CCube::Moveの移動記号)
+		int nearSolvedMoves[CNearSolvedDatabase::MaxDepth];
+		int nearSolvedLength;
+
+		// 並列探索の部分木の列挙中のみ使用する
+		// NULLでなければsplitDepthの深さのノードを部分木として積む
+		std::vector<SWorkQueue>* subtreeQueues;
+		int numberOfSubtrees;	// 列挙した部分木の数
+	};
+
+	// ポートフォリオ探索の1つの探索を作成する
+	// p_parentと解法を共有し，p_symmetryで対称変換した(p_isInverseなら逆元の)Cubeを探索する
+	// p_indexは6つの探索の番号(親の探索のスレッドの割り当てに用いる)
+	CIDAstarSearch(CIDAstarSearch& p_parent, const int p_index, const int p_symmetry, const bool p_isInverse);
+
+	// 6つの探索のうちp_index番目の探索に割り当てるスレッド数
+	// 割り切れない分は先の探索から1つずつ加える
+	static int GetPortfolioShare(const int p_numberOfThreads, const int p_index);
+
+	// 解法を共有する探索として，1つのCubeの状態に対する解探索を行う
+	int SolveCube(const COrdinalCube &p_cube, int64_t p_timeOut);
+
+	// 6通りの探索を別スレッドで同時に行う
+	int SolvePortfolio(const COrdinalCube &p_scrambledCube, int64_t p_timeOut);
 
 	// Phase 1の再帰的IDA*探索関数
 	// 再起呼び出しはdepth+1で行う
+	// p_parentCost : 親ノードのコスト(根では根のコスト)
+	// p_sequenceState : 現在の移動列の冗長な移動を除外するオートマトンの状態
+	// p_knownCost : 親ノードで求めたこのノードのコスト(求めていなければUnknownCost)
 	int Search1(
+		SSearchContext& p_context,
 		const int p_twist, 
 		const int p_flip, 
 		const int p_choice,
-		const int p_depth
+		const int p_depth,
+		const int p_parentCost,
+		const int p_sequenceState,
+		const int p_knownCost
 		);
 
+	// 追加のlookupで，深さp_depthのノードから今までの解法より短い解法が見つからないか判定する
+	bool IsPrunedByPhase1Lookups(SSearchContext& p_context, const int p_depth);
+
+	// 探索の根の追加のlookupの状態を求める
+	void InitializePhase1Lookups(SPhase1Lookups& p_lookups) const;
+
+	// 逆元のCubeのPhase 1の完成までの手数
+	int InversePhase1Cost(const CPackedCube& p_cube) const;
+
+	// Phase 1の子ノードをheuristicコストの小さい順に探索する
+	// p_cost : 現在のノードのコスト
+	int SearchOrderedChildren1(
+		SSearchContext& p_context,
+		const int p_twist,
+		const int p_flip,
+		const int p_choice,
+		const int p_depth,
+		const int p_cost,
+		const int p_sequenceState
+		);
+
+	// Phase 1の完成状態からPhase 2の解探索を行う
+	int SearchPhase1Leaf(SSearchContext& p_context, const int p_depth);
+
+	// Phase 1の探索をm_context.threshold1の閾値で1回分並列に行う
+	int ParallelSearch1(const int p_twist, const int p_flip, const int p_choice, const int p_cost);
+
+	// 並列探索の各スレッドで実行する関数
+	// キューが全て空になるか，探索が終了するまで部分木を探索する
+	int RunWorker(SSearchContext& p_context, std::vector<SWorkQueue>& p_queues, const int p_index);
+
+	// 部分木を1つ取り出す
+	// 自分のキューが空なら，他のスレッドのキューの末尾から盗む
+	bool PopSubtree(std::vector<SWorkQueue>& p_queues, const int p_index, SSubtree& subtree);
+
+	// パイプライン探索のPhase 2のスレッドで実行する関数
+	// Phase 1の探索が終了してキューが空になるまで，キューのPhase 1の解法に対してPhase 2を探索する
+	void RunPhase2Worker();
+
 	// Phase 2の解探索を開始する
-	int Solve2(COrdinalCube& cube);
+	int Solve2(
+		SSearchContext& p_context,
+		const int p_cornerPermutation,
+		const int p_upDownEdgePermutation,
+		const int p_middleEdgePermutation
+		);
 
 	// Phase 2の再帰的IDA*探索関数
 	// 再起呼び出しはdepth+1で行う
+	// p_parentCosts : 親ノードの各PruningTableのコスト(根では根のコスト)
+	// p_sequenceState : 現在の移動列の冗長な移動を除外するオートマトンの状態
+	// p_knownCosts : 親ノードで求めたこのノードの各PruningTableのコスト(求めていなければNULL)
 	int Search2(
+		SSearchContext& p_context,
 		const int p_cornerPermutation, 
 		const int p_upDownEdgePermutation, 
 		const int p_middleEdgePermutation, 
-		const int p_depth
+		const int p_depth,
+		const int* p_parentCosts,
+		const int p_sequenceState,
+		const int* p_knownCosts
+		);
+
+	// Phase 2の子ノードをheuristicコストの小さい順に探索する
+	// p_costs : 現在のノードの各PruningTableのコスト
+	int SearchOrderedChildren2(
+		SSearchContext& p_context,
+		const int p_cornerPermutation,
+		const int p_upDownEdgePermutation,
+		const int p_middleEdgePermutation,
+		const int p_depth,
+		const int* p_costs,
+		const int p_sequenceState
 		);
 
 	// Phase 1のheuristicコスト関数
+	// PruningTableがDepthの余りのみを格納しているときは，親ノードのコスト(p_parentCost)から求める
 	int Phase1Cost(
 		const int p_twist, 
 		const int p_flip, 
+		const int p_choice,
+		const int p_parentCost
+		) const;
+
+	// 探索の根のPhase 1のheuristicコスト関数
+	int Phase1RootCost(
+		const int p_twist,
+		const int p_flip,
 		const int p_choice
 		) const;
 
 	// Phase 2のheuristicコスト関数
+	// 親ノードの各PruningTableのコスト(p_parentCosts)から，各PruningTableのコスト(p_costs)を求めて最大値を返す
 	int Phase2Cost(
 		const int p_cornerPermutation,
 		const int p_upDownEdgePermutation,
-		const int p_middleEdgePermutation
+		const int p_middleEdgePermutation,
+		const int* p_parentCosts,
+		int* p_costs
 		) const;
 
-
-	// 冗長な移動を除外する
-	inline bool IsNotAllowed(
-		const int p_move, 
-		const int* p_solutionMoves, 
-		const int p_depth
+	// 探索の根のPhase 2のheuristicコスト関数
+	int Phase2RootCost(
+		const int p_cornerPermutation,
+		const int p_upDownEdgePermutation,
+		const int p_middleEdgePermutation,
+		int* p_costs
 		) const;
 
+
 	// 現在得られている解法(一番短いはず)を出力する
-	void PrintAndStackSolution();
+	// 他のスレッドが既に短い解法を見つけていた場合は何もしない
+	// ポートフォリオ探索では，元のCubeの解法に変換してから出力する
+	void PrintAndStackSolution(const SSearchContext& p_context);
 
 	// 移動記号と反復回数(face, power)から回転記号を求める
 	// ex:(U, 2) -> U2, (R, 1) -> R, (D, 3) -> D'
@@ -138,39 +388,42 @@ private:
 	// として扱っているので，出力時に補正する必要がある
 	int TranslateMove(const int p_move, int p_power, const bool p_phase2) const;
 	
-	// IDA*探索で使用する変数
-	int m_nodes1, m_nodes2;	// 現在のノード数
-	int m_threshold1, m_threshold2;	// 合計コストの足きり基準(cutoff)
-	int m_nextThreshold1, m_nextThreshold2;	// 次の探索で用いる足きり基準を保存する変数
+	// 逐次探索(および並列探索の部分木の列挙)で使用する変数
+	SSearchContext m_context;
+
+	// 全スレッドで共有する変数
+	SSolution m_ownSolution;	// この探索の解法
+	SSolution& m_solution;	// 解法を保存する先(ポートフォリオ探索では親の探索のm_ownSolution)
+	std::atomic<bool> m_isStopped;	// 探索を終了するかどうか(並列探索で他のスレッドを止める)
+
+	// 並列探索の設定
+	int m_numberOfThreads;	// 探索に用いるスレッド数
+	int m_splitDepth;	// 部分木に分割する深さ
 
-	int m_solutionMoves1[32], m_solutionMoves2[32];	// 移動記号
-	int m_solutionPowers1[32], m_solutionPowers2[32];	// 移動記号の反復回数
-	int m_solutionLength1, m_solutionLength2;	// 解法の長さ
-	int m_minSolutionLength;	// 今まで見つかった解法のうち一番短いものの長さ
-	std::vector<std::string> m_solutionStack;	// Solutionを保存するStack
+	// パイプライン探索の設定と変数
+	int m_numberOfPhase2Threads;	// Phase 2の探索に用いるスレッド数
+	CLockFreeQueue<SPhase1Solution> m_phase1Solutions;	// Phase 1の解法のキュー
+	std::atomic<bool> m_isPhase1Finished;	// Phase 1の探索が終了したか(これ以降キューに積まれない)
+	std::atomic<bool> m_isPhase2TimedOut;	// Phase 2のスレッドでタイムアウトしたか
+
+	// ポートフォリオ探索の設定
+	bool m_isPortfolio;	// ポートフォリオ探索を行うか
+	int m_symmetry;	// 探索しているCubeの対称変換の番号
+	bool m_isInverse;	// 探索しているCubeが逆元か
+
+	// Phase 1の複数lookupの設定
+	bool m_isMultiLookup;	// 追加のlookupで刈り込むか
+
+	// 子ノードの並べ替えの設定
+	bool m_isChildOrdering;	// 子ノードをheuristicコストの小さい順に探索するか
 
     CTimer *m_timer;	// タイムアウトを計算するオブジェクト
 
-	// 1.MoveTableの初期化に使用するための変数
-	// 2.Solve関数で初期状態を保存するために用いる変数
+	// Solve関数で初期状態を保存するために用いる変数
 	COrdinalCube m_cube;
 
-	// Phase 1のMoveTable
-	CTwistMoveTable m_twistMoveTable;
-	CFlipMoveTable m_flipMoveTable;
-	CChoiceMoveTable m_choiceMoveTable;
-	// Phase 2のMoveTable
-	CCornerPermutationMoveTable m_cornerPermutationMoveTable;
-	CUpDownEdgePermutationMoveTable m_upDownEdgePermutationMoveTable;
-	CMiddleEdgePermutationMoveTable m_middleEdgePermutationMoveTable;
-	
-	// Phase 1のPruningTable
-	CPruningTable m_twistAndFlipPruningTable;
-	CPruningTable m_twistAndChoicePruningTable;
-	CPruningTable m_flipAndChoicePruningTable;
-	// Phase 2のPruningTable
-	CPruningTable m_cornerAndUpDownPruningTable;
-	CPruningTable m_upDownAndMiddlePruningTable;
+	// 探索で使用するMoveTable,PruningTable(読み出し専用)
+	CSolverTables& m_tables;
 };
 
 #endif	// _IDASTARSEARCH_H_
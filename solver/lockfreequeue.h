@@ -0,0 +1,125 @@
+﻿#ifndef	_LOCKFREEQUEUE_H_
+#define	_LOCKFREEQUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+
+// 複数のスレッドから同時にpush/popできる固定長のlock-freeなキュー
+// Dmitry Vyukovのbounded MPMC queueを元にしている
+// http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+// 各要素(Cell)が持つsequenceで，その要素が書き込み可能か読み出し可能かを判定する
+template <typename T>
+class CLockFreeQueue
+{
+public:
+	// 容量は2のべき乗に切り上げる
+	CLockFreeQueue(const size_t p_capacity)
+	{
+		size_t capacity = 2;
+		while (capacity < p_capacity) {
+			capacity *= 2;
+		}
+		m_mask = capacity - 1;
+		m_buffer = new SCell[capacity];
+		for (size_t i = 0; i < capacity; i++) {
+			m_buffer[i].sequence.store(i, std::memory_order_relaxed);
+		}
+		m_enqueuePosition.store(0, std::memory_order_relaxed);
+		m_dequeuePosition.store(0, std::memory_order_relaxed);
+	}
+
+	~CLockFreeQueue()
+	{
+		delete [] m_buffer;
+	}
+
+	// 要素を追加する
+	// キューが一杯ならfalseを返す
+	bool TryPush(const T& p_item)
+	{
+		SCell* cell;
+		size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+		while (true) {
+			cell = &m_buffer[position & m_mask];
+			size_t sequence = cell->sequence.load(std::memory_order_acquire);
+			std::ptrdiff_t difference = (std::ptrdiff_t)sequence - (std::ptrdiff_t)position;
+			if (difference == 0) {
+				// 書き込み可能なので，書き込み位置を進める
+				if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+					break;
+				}
+			}
+			else if (difference < 0) {
+				// まだ読み出されていない要素が残っている(一杯)
+				return false;
+			}
+			else {
+				// 他のスレッドが先に書き込んだ
+				position = m_enqueuePosition.load(std::memory_order_relaxed);
+			}
+		}
+		cell->data = p_item;
+		// 読み出し可能にする
+		cell->sequence.store(position + 1, std::memory_order_release);
+		return true;
+	}
+
+	// 要素を取り出す
+	// キューが空ならfalseを返す
+	bool TryPop(T& item)
+	{
+		SCell* cell;
+		size_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+		while (true) {
+			cell = &m_buffer[position & m_mask];
+			size_t sequence = cell->sequence.load(std::memory_order_acquire);
+			std::ptrdiff_t difference = (std::ptrdiff_t)sequence - (std::ptrdiff_t)(position + 1);
+			if (difference == 0) {
+				// 読み出し可能なので，読み出し位置を進める
+				if (m_dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+					break;
+				}
+			}
+			else if (difference < 0) {
+				// まだ書き込まれていない(空)
+				return false;
+			}
+			else {
+				// 他のスレッドが先に読み出した
+				position = m_dequeuePosition.load(std::memory_order_relaxed);
+			}
+		}
+		item = cell->data;
+		// 1周後の書き込みを可能にする
+		cell->sequence.store(position + m_mask + 1, std::memory_order_release);
+		return true;
+	}
+
+private:
+	// コピー禁止
+	CLockFreeQueue(const CLockFreeQueue&);
+	CLockFreeQueue& operator=(const CLockFreeQueue&);
+
+	struct SCell
+	{
+		std::atomic<size_t> sequence;
+		T data;
+	};
+
+	enum { CacheLineSize = 64 };
+
+	SCell* m_buffer;
+	size_t m_mask;
+
+	// 書き込み位置と読み出し位置は別のキャッシュラインに置く
+	// alignas(64)で境界を揃えると，C++14のnewは16byteを超える境界を保証しないので，
+	// このキューを含むオブジェクトをnewしたときに境界がずれる(未定義動作)
+	// 境界は揃えずに，前の変数から1キャッシュライン分以上離す
+	char m_enqueuePadding[CacheLineSize - sizeof(size_t)];
+	std::atomic<size_t> m_enqueuePosition;
+	char m_dequeuePadding[CacheLineSize - sizeof(std::atomic<size_t>)];
+	std::atomic<size_t> m_dequeuePosition;
+	char m_endPadding[CacheLineSize - sizeof(std::atomic<size_t>)];
+};
+
+#endif	// _LOCKFREEQUEUE_H_
@@ -0,0 +1,216 @@
+﻿#include "movesequenceautomaton.h"
+#include "packedcube.h"
+
+#include <map>
+#include <algorithm>
+
+namespace
+{
+	// Cubeの状態のキー(CNearSolvedDatabaseと同じく状態を詰めた128bitの値)
+	// 空の項目はedges = 0 (Edgeの順列は0以外の値を含むので，状態のキーは0にならない)
+	struct SKey
+	{
+		uint64_t corners;	// Cornerの順列(3bit * 8) + 方向(2bit * 8)
+		uint64_t edges;	// Edgeの順列(4bit * 12) + 方向(1bit * 12)
+	};
+
+	// Cubeの状態をキーにする
+	SKey PackKey(const CPackedCube& p_cube)
+	{
+		SKey key = { 0, 0 };
+		for (int corner = CCube::FirstCornerSet; corner <= CCube::LastCornerSet; corner++) {
+			key.corners |= (uint64_t)p_cube.GetCorner(corner) << (3 * corner);
+			key.corners |= (uint64_t)p_cube.GetCornerOrientation(corner) << (3 * CCube::NumberOfCornerSets + 2 * corner);
+		}
+		for (int edge = CCube::FirstEdgeSet; edge <= CCube::LastEdgeSet; edge++) {
+			key.edges |= (uint64_t)p_cube.GetEdge(edge) << (4 * edge);
+			key.edges |= (uint64_t)p_cube.GetEdgeOrientation(edge) << (4 * CCube::NumberOfEdgeSets + edge);
+		}
+		return key;
+	}
+
+	// キーのハッシュ値
+	uint64_t Hash(const SKey& p_key)
+	{
+		uint64_t hash = p_key.corners * 0x9e3779b97f4a7c15ULL ^ p_key.edges * 0xc2b2ae3d27d4eb4fULL;
+		return hash ^ (hash >> 32);
+	}
+
+	// 線形探索のハッシュ表にキーが無ければ追加する(追加したらtrue)
+	// 半分以上埋まったら容量を2倍にして格納し直す
+	bool InsertKey(std::vector<SKey>& p_keys, uint64_t& p_numberOfKeys, const SKey& p_key)
+	{
+		if (2 * (p_numberOfKeys + 1) > p_keys.size()) {
+			std::vector<SKey> keys(std::max<size_t>(2 * p_keys.size(), 1024), SKey());
+			for (size_t i = 0; i < p_keys.size(); i++) {
+				if (p_keys[i].edges != 0) {
+					uint64_t index = Hash(p_keys[i]) & (keys.size() - 1);
+					while (keys[index].edges != 0) {
+						index = (index + 1) & (keys.size() - 1);
+					}
+					keys[index] = p_keys[i];
+				}
+			}
+			p_keys.swap(keys);
+		}
+
+		const uint64_t indexMask = p_keys.size() - 1;
+		uint64_t index = Hash(p_key) & indexMask;
+		for (; p_keys[index].edges != 0; index = (index + 1) & indexMask) {
+			if (p_keys[index].edges == p_key.edges && p_keys[index].corners == p_key.corners) {
+				return false;
+			}
+		}
+		p_keys[index] = p_key;
+		p_numberOfKeys++;
+		return true;
+	}
+
+	// 禁止列を列挙するための，最小の移動列の木(Trie)のノード
+	// 最大の長さより短い最小の移動列だけをノードにする(禁止列の真の接頭辞は全てノードになる)
+	struct SNode
+	{
+		CPackedCube cube;	// 移動列を行った状態
+		int length;	// 移動列の長さ
+		int children[CCube::NumberOfMoves];	// 移動を続けた移動列のノード(Forbidden, Leafのときはノードを作らない)
+		int failure;	// 移動列の真の接尾辞のうち，木に含まれる最長のもののノード
+	};
+
+	enum
+	{
+		Forbidden = -1,	// 禁止列
+		Leaf = -2,	// 最大の長さの最小の移動列
+		AllMoves = (1 << CCube::NumberOfMoves) - 1
+	};
+}
+
+CMoveSequenceAutomaton::CMoveSequenceAutomaton()
+	: m_numberOfForbiddenSequences(0)
+{
+}
+
+CMoveSequenceAutomaton::~CMoveSequenceAutomaton()
+{
+}
+
+// オートマトンを作成する
+void CMoveSequenceAutomaton::Initialize(const bool p_isPhase2, const int p_maxLength)
+{
+	// 長さp_maxLength以下の移動列を(長さ, 辞書順)の順に幅優先探索し，
+	// 既に現れた状態になる移動列を禁止列とする
+	// (親のノードを辞書順に展開し，移動を番号の順に続けるので，キューの順番が(長さ, 辞書順)の順になる)
+	std::vector<SNode> nodes(1);
+	nodes[0].length = 0;
+	nodes[0].failure = 0;
+	std::vector<SKey> states;
+	uint64_t numberOfStates = 0;
+	InsertKey(states, numberOfStates, PackKey(nodes[0].cube));
+	m_numberOfForbiddenSequences = 0;
+
+	for (size_t node = 0; node < nodes.size(); node++) {
+		for (int move = CCube::U; move < CCube::NumberOfMoves; move++) {
+			// Phase 2の移動以外は常に除外する(禁止列には数えない)
+			if (p_isPhase2 && !CCube::IsPhase2Move(move)) {
+				nodes[node].children[move] = Forbidden;
+				continue;
+			}
+			CPackedCube cube = nodes[node].cube;
+			cube.ApplyMove(move);
+			if (!InsertKey(states, numberOfStates, PackKey(cube))) {
+				nodes[node].children[move] = Forbidden;
+				m_numberOfForbiddenSequences++;
+			}
+			else if (nodes[node].length + 1 >= p_maxLength) {
+				nodes[node].children[move] = Leaf;
+			}
+			else {
+				SNode child;
+				child.cube = cube;
+				child.length = nodes[node].length + 1;
+				child.failure = 0;
+				nodes[node].children[move] = (int)nodes.size();
+				nodes.push_back(child);
+			}
+		}
+	}
+
+	// 禁止列を検出するオートマトンを作成する(Aho-Corasick)
+	// 状態は木のノードで，今までの移動列の接尾辞のうち木に含まれる最長のものを表す
+	// 接尾辞のどれかに禁止列が続く移動は行えないので，行ってよい移動は接尾辞のリンク(failure)を辿った積になる
+	// 接尾辞のリンクは短い移動列を先に求めておく必要があるので，幅優先の順に求める
+	const int numberOfNodes = (int)nodes.size();
+	std::vector<uint32_t> allowedMoves(numberOfNodes);
+	std::vector<int> nextStates(numberOfNodes * CCube::NumberOfMoves, 0);
+	for (int node = 0; node < numberOfNodes; node++) {
+		const int failure = nodes[node].failure;
+		uint32_t allowed = (node == 0) ? (uint32_t)AllMoves : allowedMoves[failure];
+		for (int move = CCube::U; move < CCube::NumberOfMoves; move++) {
+			const int child = nodes[node].children[move];
+			if (child == Forbidden) {
+				allowed &= ~(1u << move);
+				continue;
+			}
+			// 木に続きが無ければ，接尾辞のリンクの遷移先と同じ
+			const int suffix = (node == 0) ? 0 : nextStates[failure * CCube::NumberOfMoves + move];
+			if (child == Leaf) {
+				nextStates[node * CCube::NumberOfMoves + move] = suffix;
+			}
+			else {
+				nextStates[node * CCube::NumberOfMoves + move] = child;
+				nodes[child].failure = suffix;
+			}
+		}
+		allowedMoves[node] = allowed;
+	}
+
+	// 状態を最小化する(Moore)
+	// 行ってよい移動が同じ状態を同じ類とし，行ってよい各移動の遷移先の類で類を分けることを，類の数が変わらなくなるまで繰り返す
+	// 類の番号は最初に現れた状態の順に付けるので，最初の状態(根)は常に類0になる
+	std::vector<int> classes(numberOfNodes);
+	int numberOfClasses = 0;
+	{
+		std::map<uint32_t, int> masks;
+		for (int node = 0; node < numberOfNodes; node++) {
+			std::map<uint32_t, int>::iterator it = masks.insert(std::make_pair(allowedMoves[node], (int)masks.size())).first;
+			classes[node] = it->second;
+		}
+		numberOfClasses = (int)masks.size();
+	}
+	for (;;) {
+		std::map<std::vector<int>, int> signatures;
+		std::vector<int> nextClasses(numberOfNodes);
+		for (int node = 0; node < numberOfNodes; node++) {
+			std::vector<int> signature(1, classes[node]);
+			for (int move = CCube::U; move < CCube::NumberOfMoves; move++) {
+				if (allowedMoves[node] & (1u << move)) {
+					signature.push_back(classes[nextStates[node * CCube::NumberOfMoves + move]]);
+				}
+			}
+			nextClasses[node] = signatures.insert(std::make_pair(signature, (int)signatures.size())).first->second;
+		}
+		classes.swap(nextClasses);
+		if ((int)signatures.size() == numberOfClasses) {
+			break;
+		}
+		numberOfClasses = (int)signatures.size();
+	}
+
+	// 各類の代表の状態から，最小化したオートマトンを作成する
+	// (行えない移動の遷移先は使用しないので最初の状態にしておく)
+	m_allowedMoves.assign(numberOfClasses, 0);
+	m_nextStates.assign(numberOfClasses * CCube::NumberOfMoves, InitialState);
+	std::vector<bool> isCreated(numberOfClasses, false);
+	for (int node = 0; node < numberOfNodes; node++) {
+		const int state = classes[node];
+		if (isCreated[state]) {
+			continue;
+		}
+		isCreated[state] = true;
+		m_allowedMoves[state] = allowedMoves[node];
+		for (int move = CCube::U; move < CCube::NumberOfMoves; move++) {
+			if (allowedMoves[node] & (1u << move)) {
+				m_nextStates[state * CCube::NumberOfMoves + move] = (uint16_t)classes[nextStates[node * CCube::NumberOfMoves + move]];
+			}
+		}
+	}
+}
@@ -0,0 +1,68 @@
+﻿#ifndef	_MOVESEQUENCEAUTOMATON_H_
+#define	_MOVESEQUENCEAUTOMATON_H_
+
+#include <vector>
+#include <cstdint>
+
+#include "cube.h"
+
+// 冗長な移動列を除外する有限状態オートマトン
+// 同じ長さ以下の移動列の中で，同じ状態になる移動列のうち(長さ, 移動記号の番号の辞書順)が最小のものだけを残す
+// - 同じ面の連続した移動 (ex. "U U'" -> "", "U U" -> "U2")
+// - 反対の面の交換できる移動 (ex. "D U" -> "U D", "U D U" -> "U2 D")
+// - より長い移動列の冗長性 (ex. 同じ状態になる移動列が複数あるときは1つだけ)
+// 最小の移動列に含まれる部分列も最小なので，最小でない移動列(禁止列)を部分列に含む移動列を全て除外してよい
+// 起動時に長さp_maxLength以下の禁止列を幅優先探索で列挙し，禁止列を検出するオートマトン(Aho-Corasick)を作成して最小化する
+// 各状態は次に行ってよい移動のbitmaskと，各移動の後の状態を持つので，探索では冗長な移動の判定が1回の参照で済む
+// 作成後は書き換えないので，複数のスレッドから同時に参照してよい
+class CMoveSequenceAutomaton
+{
+public:
+	enum
+	{
+		InitialState = 0,	// 移動を行う前の状態
+		// 禁止列の最大の長さ(長くすると除外できる移動列が増えるが，作成時間と状態の数が約13倍(Phase 2は約7倍)になる)
+		Phase1MaxLength = 5,	// 状態の数は1928個
+		Phase2MaxLength = 6	// 状態の数は3737個
+	};
+
+	CMoveSequenceAutomaton();
+	~CMoveSequenceAutomaton();
+
+	// オートマトンを作成する
+	// p_isPhase2 : Phase 2の移動<U,D,R2,L2,F2,B2>だけの移動列(他の移動は常に除外する)
+	// p_maxLength : 列挙する禁止列の最大の長さ
+	void Initialize(const bool p_isPhase2, const int p_maxLength);
+
+	// 状態p_stateの次に行ってよい移動(CCube::Moveのbit)
+	uint32_t GetAllowedMoves(const int p_state) const
+	{
+		return m_allowedMoves[p_state];
+	}
+
+	// 状態p_stateで移動p_moveを行った後の状態(p_moveは行ってよい移動のみ)
+	int GetNextState(const int p_state, const int p_move) const
+	{
+		return m_nextStates[p_state * CCube::NumberOfMoves + p_move];
+	}
+
+	// 面p_faceの3種類の移動のbit
+	static uint32_t GetFaceMoves(const int p_face)
+	{
+		return (1u << p_face) | (1u << (p_face + CCube::Ui)) | (1u << (p_face + CCube::U2));
+	}
+
+	// オートマトンの状態の数
+	int GetNumberOfStates() const { return (int)m_allowedMoves.size(); }
+	// 列挙した禁止列の数
+	int GetNumberOfForbiddenSequences() const { return m_numberOfForbiddenSequences; }
+
+private:
+	// 状態 -> 行ってよい移動のbit
+	std::vector<uint32_t> m_allowedMoves;
+	// [状態][移動] -> 次の状態
+	std::vector<uint16_t> m_nextStates;
+	int m_numberOfForbiddenSequences;
+};
+
+#endif	// _MOVESEQUENCEAUTOMATON_H_
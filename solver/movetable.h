@@ -2,62 +2,141 @@
 #define	_MOVETABLE_H_
 
 #include "cube.h"
+#include "tablefile.h"
 
 #include <string>
+#include <cstdint>
 #include <QObject>
 
-// CMoveTable
-// (状態Sに対して6種類の移動を行ったときの状態S'を列挙するTableを作成するための基底クラス)
-class CMoveTable : public QObject
+// CMoveTableBase
+// (状態Sに対して18種類の移動を行ったときの状態S'を列挙するTableを作成するための基底クラス)
+// Tableの読み込み(メモリマップ)・保存を行う
+// Tableの要素の型とサイズ，Tableの作成はCBasicMoveTableで決める
+class CMoveTableBase : public QObject
 {
     Q_OBJECT
 signals:
     void notifySolverMessage(QString p_message);
 
 public:
-	// CubeへのReference,MoveTableのサイズ,Phase2かどうかを設定してメモリを確保
+	// CubeへのReference,MoveTableのサイズ,Phase2かどうかを設定する
 	// CubeはReferenceなのでMoveTableのメンバ関数によって操作される
-	CMoveTable(CCube& cube, const int p_tableSize, const bool p_isPhase2);
-	// MoveTableを解放
-	virtual ~CMoveTable();
+	CMoveTableBase(CCube& cube, const int p_tableSize, const int p_entrySize, const bool p_isPhase2);
+	virtual ~CMoveTableBase();
 
-	// MoveTableを読み込む
-	// MoveTableが無ければ作成する
-	virtual void Initialize(const std::string p_fileName);
+	// MoveTableのファイルをメモリマップする
+	// ファイルが無いとき，ヘッダかチェックサムが一致しないときは作成して保存する
+	// p_bundleを指定したときはバンドルの中のTableを使い，見つからなければfalseを返す
+	bool Initialize(const std::string p_fileName, const CTableBundle* p_bundle = NULL);
 
-	// privateなTableに対して，オブジェクトの添え字でアクセスするための演算子
-	virtual int* operator[](const int p_index);
-	
 	// MoveTableを出力する
-	virtual void PrintMoveTable() const;
+	void PrintMoveTable() const;
+
+	// Tableのサイズ(序数の数)を取得
+	int GetSize() const { return m_tableSize; }
 
-	// Tableのサイズ(int単位)を取得
-	virtual int GetSize() const { return m_tableSize; }
+	// Phase 2の移動<U,D,R2,L2,F2,B2>のみを格納したTableか
+	bool IsPhase2() const { return m_isPhase2; }
 
 protected:
-	// 継承したクラスで実体を作成する
-	virtual int GetOrdinalFromCubeState() const = 0;
-	virtual void SetCubeStateFromOrdinal(const int p_ordinal) = 0;
+	// Tableの作成と要素の読み書き(CBasicMoveTableで実体を作成する)
+	// 探索では使用しないので仮想関数にしておく
+	virtual void GenerateMoveTable() = 0;
+	virtual int GetEntry(const int p_ordinal, const int p_move) const = 0;
 
-private:
-	// MoveTableを作成する
-	void GenerateMoveTable();
+	// Tableの先頭アドレスを設定する(マップしたファイルまたは作成用のヒープ)
+	virtual void AttachTable(unsigned char* p_data) = 0;
 
 	// Cubeへのreference
 	// 処理の高速化のためにReferenceを用いる
 	CCube &m_cubeRef;
 
+private:
 	// MoveTableのサイズ
 	int m_tableSize;
 	// Phase1:false, Phase2:true
 	bool m_isPhase2;
+	// Tableのファイル
+	CTableFile m_tableFile;
+};
 
-	// 配列 int[6] へのポインタ
-	// int m_table[m_tableSize][6]を確保して使用する
+// 要素の型をTEntry，序数の数をTSizeとするMoveTable
+// TDerivedはGetOrdinalFromCubeState,SetCubeStateFromOrdinalを実装した継承先のクラス(CRTP)
+// Tableの寸法がコンパイル時に決まり，探索では m_table[ordinal][move] を仮想関数を経由せずに参照する
+template <class TDerived, typename TEntry, int TSize, bool TIsPhase2>
+class CBasicMoveTable : public CMoveTableBase
+{
+public:
+	enum
+	{
+		Size = TSize,	// 序数の数
+		IsPhase2Table = TIsPhase2	// Phase 2の移動のみを格納するか
+	};
+
+	// メモリはInitializeでCMoveTableBaseが確保(またはファイルをマップ)する
+	CBasicMoveTable(CCube& cube)
+		: CMoveTableBase(cube, TSize, sizeof(TEntry), TIsPhase2),
+		m_table(NULL)
+	{
+	}
+	virtual ~CBasicMoveTable()
+	{
+	}
+
+	// privateなTableに対して，オブジェクトの添え字でアクセスするための演算子
 	// m_table[ordinal][move]は序数ordinalの状態のときにmoveの状態遷移をした後の序数を表す
-	// http://www.nurs.or.jp/~sug/soft/tora/tora10.htm
+	inline const TEntry* operator[](const int p_index) const
+	{
+		return m_table[p_index];
+	}
+
+protected:
+	// MoveTableを作成する
+	void GenerateMoveTable()
+	{
+		TDerived& derived = static_cast<TDerived&>(*this);
+
+		// 移動テーブルを作成するためにclear cubeを取得する
+		m_cubeRef.SetCleanCube();
+
+		// 移動テーブルを初期化
+		for (int ordinal = 0; ordinal < TSize; ordinal++) {
+			// ordinalの値に応じたuniqueなcubeの状態を設定する
+			derived.SetCubeStateFromOrdinal(ordinal);
+
+			// それぞれの状態に対しての移動を設定する
+			// 90[deg]回転，-90[deg]回転，180[deg]回転をそれぞれ1回の参照で求められるように，18種類の移動を全て格納する
+			for (int move = CCube::Move::U; move < CCube::Move::NumberOfMoves; move++) {
+				// Phase 2 では <U,D,R2,L2,F2,B2> の移動のみ
+				// Phase 2の座標はそれ以外の移動で定義されないので，0を格納しておく
+				if (TIsPhase2 && !CCube::IsPhase2Move(move)) {
+					m_table[ordinal][move] = 0;
+					continue;
+				}
+
+				// cubeを動かす(後で戻す)
+				// ここでCornerSetOrientations, EdgeSetOrientations等が変化する
+				m_cubeRef.ApplyMove(move);
+
+				// cubeを動かしたときの状態遷移後の序数を格納する
+				m_table[ordinal][move] = (TEntry)derived.GetOrdinalFromCubeState();
+
+				// cubeを戻しておく
+				m_cubeRef.ApplyMove(CCube::GetInverseOfMove(move));
+			}
+		}
+	}
+
+	int GetEntry(const int p_ordinal, const int p_move) const
+		{ return (int)m_table[p_ordinal][p_move]; }
+	void AttachTable(unsigned char* p_data)
+		{ m_table = (TEntry (*)[CCube::Move::NumberOfMoves])p_data; }
+
+private:
+	// 配列 TEntry[18] へのポインタ
+	// TEntry m_table[TSize][18]の領域を指す
 	// http://d.hatena.ne.jp/Guernsey/20090924/1253775843
-	int (*m_table)[CCube::Move::NumberOfClockwiseQuarterTurnMoves];
+	TEntry (*m_table)[CCube::Move::NumberOfMoves];
 };
 
 #endif	// _MOVETABLE_H_
@@ -0,0 +1,242 @@
+﻿#include "nearsolveddatabase.h"
+#include "ordinalcube.h"
+
+namespace
+{
+	// 完成状態からN手以内の状態の数(N = 0 ~ MaxDepth)
+	// 各手数の状態の数は 1, 18, 243, 3240, 43239, 574908, 7618438, 100803036
+	const uint64_t NumberOfStatesWithinDepth[CNearSolvedDatabase::MaxDepth + 1] =
+	{
+		1ULL, 19ULL, 262ULL, 3502ULL, 46741ULL, 621649ULL, 8240087ULL, 109043123ULL
+	};
+
+	// Phase 2の序数の数
+	const int NumberOfCornerPermutations = 40320;	// 8!
+	const int NumberOfUpDownEdgePermutations = 40320;	// 8!
+	const int NumberOfMiddleEdgePermutations = 24;	// 4!
+}
+
+CNearSolvedDatabase::CNearSolvedDatabase()
+	: m_indexMask(0),
+	m_numberOfStates(0),
+	m_depth(0)
+{
+}
+
+CNearSolvedDatabase::~CNearSolvedDatabase()
+{
+}
+
+// p_memoryBudget(byte)に収まる最大の手数Nを選び，N手以内の全ての状態を格納する
+void CNearSolvedDatabase::Initialize(const uint64_t p_memoryBudget)
+{
+	m_entries.clear();
+	m_numberOfStates = 0;
+	m_depth = 0;
+
+	int depth = 0;
+	while (depth < MaxDepth && GetMemorySize(depth + 1) <= p_memoryBudget) {
+		depth++;
+	}
+	if (depth == 0) {
+		return;
+	}
+
+	// Phase 2の序数からキーを作成するためのTable
+	COrdinalCube cube;
+	m_cornerPermutationKeys.resize(NumberOfCornerPermutations);
+	for (int ordinal = 0; ordinal < NumberOfCornerPermutations; ordinal++) {
+		cube.SetCleanCube();
+		cube.SetCornerPermutationFromOrdinal(ordinal);
+		m_cornerPermutationKeys[ordinal] = PackKey(CPackedCube(cube)).corners;
+	}
+	m_upDownEdgePermutationKeys.resize(NumberOfUpDownEdgePermutations);
+	for (int ordinal = 0; ordinal < NumberOfUpDownEdgePermutations; ordinal++) {
+		cube.SetCleanCube();
+		cube.SetUpDownEdgePermutationFromOrdinal(ordinal);
+		m_upDownEdgePermutationKeys[ordinal] = PackKey(CPackedCube(cube)).edges & 0xffffffffULL;
+	}
+	m_middleEdgePermutationKeys.resize(NumberOfMiddleEdgePermutations);
+	for (int ordinal = 0; ordinal < NumberOfMiddleEdgePermutations; ordinal++) {
+		cube.SetCleanCube();
+		cube.SetMiddleEdgePermutationFromOrdinal(ordinal);
+		m_middleEdgePermutationKeys[ordinal] = PackKey(CPackedCube(cube)).edges & 0xffff00000000ULL;
+	}
+
+	// 完成状態から幅優先探索を行う
+	// 手数distance - 1の項目を表の中から探して展開するので，探索のキューは不要
+	// (展開中に追加した項目は手数がdistanceなので，同じ走査では展開しない)
+	const uint64_t capacity = GetCapacity(depth);
+	SEntry empty = { 0, 0 };
+	m_entries.assign(capacity, empty);
+	m_indexMask = capacity - 1;
+
+	CPackedCube packedCube;
+	Insert(PackKey(packedCube), 0, 0);
+	for (int distance = 1; distance <= depth; distance++) {
+		for (uint64_t i = 0; i < capacity; i++) {
+			const SEntry entry = m_entries[i];
+			if (entry.edges == 0 || (int)((entry.corners >> DistanceShift) & DistanceMask) != distance - 1) {
+				continue;
+			}
+			UnpackKey(entry, packedCube);
+			for (int move = CCube::U; move < CCube::NumberOfMoves; move++) {
+				CPackedCube next = packedCube;
+				next.ApplyMove(move);
+				// 反対方向の移動で1手前の状態(完成に1手近い状態)に戻る
+				Insert(PackKey(next), distance, CCube::GetInverseOfMove(move));
+			}
+		}
+	}
+	m_depth = depth;
+}
+
+// 手数Nのデータベースに必要なメモリ(byte)
+uint64_t CNearSolvedDatabase::GetMemorySize(const int p_depth)
+{
+	if (p_depth <= 0 || p_depth > MaxDepth) {
+		return 0;
+	}
+	return GetCapacity(p_depth) * sizeof(SEntry)
+		+ (NumberOfCornerPermutations + NumberOfUpDownEdgePermutations + NumberOfMiddleEdgePermutations) * sizeof(uint64_t);
+}
+
+// 手数Nのハッシュ表の容量
+// 状態の数の2倍以上の2の累乗にする(線形探索が短くなるように半分以上を空ける)
+uint64_t CNearSolvedDatabase::GetCapacity(const int p_depth)
+{
+	uint64_t capacity = 1;
+	while (capacity < 2 * NumberOfStatesWithinDepth[p_depth]) {
+		capacity <<= 1;
+	}
+	return capacity;
+}
+
+// Cubeの完成までの最短手数を求める
+int CNearSolvedDatabase::GetDistance(const CCube& p_cube) const
+{
+	const SEntry* entry = Find(PackKey(CPackedCube(p_cube)));
+	if (entry == NULL) {
+		return NotFound;
+	}
+	return (int)((entry->corners >> DistanceShift) & DistanceMask);
+}
+
+// Phase 1の完成状態のCubeをPhase 2の序数で指定して，完成までの最短手数を求める
+int CNearSolvedDatabase::GetDistance(const int p_cornerPermutation, const int p_upDownEdgePermutation, const int p_middleEdgePermutation) const
+{
+	if (m_depth == 0) {
+		return NotFound;
+	}
+
+	SEntry key;
+	key.corners = m_cornerPermutationKeys[p_cornerPermutation];
+	key.edges = m_upDownEdgePermutationKeys[p_upDownEdgePermutation] | m_middleEdgePermutationKeys[p_middleEdgePermutation];
+	const SEntry* entry = Find(key);
+	if (entry == NULL) {
+		return NotFound;
+	}
+	return (int)((entry->corners >> DistanceShift) & DistanceMask);
+}
+
+// Cubeの完成までの最短の解法をp_movesに求めて，手数を返す
+int CNearSolvedDatabase::GetSolution(const CCube& p_cube, int* p_moves) const
+{
+	CPackedCube cube(p_cube);
+	const SEntry* entry = Find(PackKey(cube));
+	if (entry == NULL) {
+		return NotFound;
+	}
+
+	// 完成に1手近づく移動を辿る(幅優先探索で作成したので，途中の状態も必ず格納されている)
+	const int distance = (int)((entry->corners >> DistanceShift) & DistanceMask);
+	for (int i = 0; i < distance; i++) {
+		p_moves[i] = (int)((entry->corners >> MoveShift) & MoveMask);
+		cube.ApplyMove(p_moves[i]);
+		entry = Find(PackKey(cube));
+	}
+	return distance;
+}
+
+// Phase 1の完成状態のCubeをPhase 2の序数で指定して，最短の解法を求める
+int CNearSolvedDatabase::GetSolution(const int p_cornerPermutation, const int p_upDownEdgePermutation, const int p_middleEdgePermutation, int* p_moves) const
+{
+	COrdinalCube cube;
+	cube.SetCornerPermutationFromOrdinal(p_cornerPermutation);
+	cube.SetUpDownEdgePermutationFromOrdinal(p_upDownEdgePermutation);
+	cube.SetMiddleEdgePermutationFromOrdinal(p_middleEdgePermutation);
+	return GetSolution(cube, p_moves);
+}
+
+// Cubeの状態をキーにする
+CNearSolvedDatabase::SEntry CNearSolvedDatabase::PackKey(const CPackedCube& p_cube)
+{
+	SEntry key = { 0, 0 };
+	for (int corner = CCube::FirstCornerSet; corner <= CCube::LastCornerSet; corner++) {
+		key.corners |= (uint64_t)p_cube.GetCorner(corner) << (3 * corner);
+		key.corners |= (uint64_t)p_cube.GetCornerOrientation(corner) << (3 * CCube::NumberOfCornerSets + 2 * corner);
+	}
+	for (int edge = CCube::FirstEdgeSet; edge <= CCube::LastEdgeSet; edge++) {
+		key.edges |= (uint64_t)p_cube.GetEdge(edge) << (4 * edge);
+		key.edges |= (uint64_t)p_cube.GetEdgeOrientation(edge) << (4 * CCube::NumberOfEdgeSets + edge);
+	}
+	return key;
+}
+
+// キーからCubeの状態を復元する
+void CNearSolvedDatabase::UnpackKey(const SEntry& p_key, CPackedCube& p_cube)
+{
+	for (int corner = CCube::FirstCornerSet; corner <= CCube::LastCornerSet; corner++) {
+		p_cube.SetCorner(corner, (int)((p_key.corners >> (3 * corner)) & 0x7),
+			(int)((p_key.corners >> (3 * CCube::NumberOfCornerSets + 2 * corner)) & 0x3));
+	}
+	for (int edge = CCube::FirstEdgeSet; edge <= CCube::LastEdgeSet; edge++) {
+		p_cube.SetEdge(edge, (int)((p_key.edges >> (4 * edge)) & 0xf),
+			(int)((p_key.edges >> (4 * CCube::NumberOfEdgeSets + edge)) & 0x1));
+	}
+}
+
+// キーのハッシュ値
+uint64_t CNearSolvedDatabase::Hash(const SEntry& p_key)
+{
+	uint64_t hash = p_key.corners * 0x9e3779b97f4a7c15ULL ^ p_key.edges * 0xc2b2ae3d27d4eb4fULL;
+	// 乗算は上位bitにしか伝わらないので，上位bitを下位bitに混ぜる
+	return hash ^ (hash >> 32);
+}
+
+// キーの項目を探す(無ければNULL)
+const CNearSolvedDatabase::SEntry* CNearSolvedDatabase::Find(const SEntry& p_key) const
+{
+	if (m_entries.empty()) {
+		return NULL;
+	}
+
+	const uint64_t keyMask = (1ULL << MoveShift) - 1;
+	for (uint64_t index = Hash(p_key) & m_indexMask; ; index = (index + 1) & m_indexMask) {
+		const SEntry& entry = m_entries[index];
+		if (entry.edges == 0) {
+			return NULL;
+		}
+		if (entry.edges == p_key.edges && (entry.corners & keyMask) == p_key.corners) {
+			return &entry;
+		}
+	}
+}
+
+// キーの項目が無ければ追加する(追加したらtrue)
+bool CNearSolvedDatabase::Insert(const SEntry& p_key, const int p_distance, const int p_move)
+{
+	const uint64_t keyMask = (1ULL << MoveShift) - 1;
+	uint64_t index = Hash(p_key) & m_indexMask;
+	for (; m_entries[index].edges != 0; index = (index + 1) & m_indexMask) {
+		if (m_entries[index].edges == p_key.edges && (m_entries[index].corners & keyMask) == p_key.corners) {
+			return false;
+		}
+	}
+
+	m_entries[index].corners = p_key.corners
+		| ((uint64_t)p_move << MoveShift) | ((uint64_t)p_distance << DistanceShift);
+	m_entries[index].edges = p_key.edges;
+	m_numberOfStates++;
+	return true;
+}
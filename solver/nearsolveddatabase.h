@@ -0,0 +1,100 @@
+﻿#ifndef	_NEARSOLVEDDATABASE_H_
+#define	_NEARSOLVEDDATABASE_H_
+
+#include <vector>
+#include <cstdint>
+
+#include "cube.h"
+#include "packedcube.h"
+
+// 完成状態からN手以内の全ての状態を格納したハッシュ表(完成付近のデータベース)
+// 起動時に完成状態から幅優先探索で作成し(移動はCPackedCubeで行う)，各状態に完成までの最短手数と，完成に1手近づく移動を格納する
+// - N手以内のCubeは，解探索を行わずに最短の解法を返す
+// - Phase 2の探索の末端では，残りの深さがN手以下になったら再帰せずに表を引く
+//   (表に無ければ完成までN + 1手以上かかるので，その枝を刈り込む)
+// Nはメモリの上限に収まる最大の手数を選ぶ(1手増やすとおよそ13倍になる)
+// 作成後は書き換えないので，複数のスレッドから同時に参照してよい
+class CNearSolvedDatabase
+{
+public:
+	enum
+	{
+		MaxDepth = 7,	// 格納できる最大の手数(手数は3bitで格納する)
+		DefaultMemoryBudget = 64,	// 標準のメモリの上限(MB)
+		NotFound = -1	// N手以内に完成しない
+	};
+
+	CNearSolvedDatabase();
+	~CNearSolvedDatabase();
+
+	// p_memoryBudget(byte)に収まる最大の手数Nを選び，N手以内の全ての状態を格納する
+	// 収まらなければ(N = 0)何も格納しない
+	void Initialize(const uint64_t p_memoryBudget);
+
+	// 格納した手数N(0なら使用しない)
+	int GetDepth() const { return m_depth; }
+	// 格納した状態の数
+	uint64_t GetNumberOfStates() const { return m_numberOfStates; }
+
+	// 手数Nのデータベースに必要なメモリ(byte)
+	static uint64_t GetMemorySize(const int p_depth);
+
+	// Cubeの完成までの最短手数を求める(N手以内に完成しなければNotFound)
+	int GetDistance(const CCube& p_cube) const;
+	// Phase 1の完成状態のCubeをPhase 2の序数で指定して，完成までの最短手数を求める
+	int GetDistance(const int p_cornerPermutation, const int p_upDownEdgePermutation, const int p_middleEdgePermutation) const;
+
+	// Cubeの完成までの最短の解法(CCube::Moveの移動記号)をp_movesに求めて，手数を返す
+	// N手以内に完成しなければNotFound
+	int GetSolution(const CCube& p_cube, int* p_moves) const;
+	// Phase 1の完成状態のCubeをPhase 2の序数で指定して，最短の解法を求める
+	int GetSolution(const int p_cornerPermutation, const int p_upDownEdgePermutation, const int p_middleEdgePermutation, int* p_moves) const;
+
+private:
+	// ハッシュ表の1項目
+	// キーはCSolutionCacheと同じくCubeの状態を詰めた128bitの値
+	// cornersの上位8bitに，完成に1手近づく移動(5bit)と完成までの手数(3bit)を格納する
+	// 空の項目はedges = 0 (Edgeの順列は0以外の値を含むので，状態のキーは0にならない)
+	struct SEntry
+	{
+		uint64_t corners;	// Cornerの順列(3bit * 8) + 方向(2bit * 8) + 移動 + 手数
+		uint64_t edges;	// Edgeの順列(4bit * 12) + 方向(1bit * 12)
+	};
+
+	enum
+	{
+		MoveShift = 56,	// cornersの中の移動の位置
+		DistanceShift = 61,	// cornersの中の手数の位置
+		MoveMask = 0x1f,
+		DistanceMask = 0x7
+	};
+
+	// 手数Nのハッシュ表の容量
+	static uint64_t GetCapacity(const int p_depth);
+
+	// Cubeの状態をキーにする
+	static SEntry PackKey(const CPackedCube& p_cube);
+	// キーからCubeの状態を復元する
+	static void UnpackKey(const SEntry& p_key, CPackedCube& p_cube);
+
+	// キーのハッシュ値
+	static uint64_t Hash(const SEntry& p_key);
+	// キーの項目を探す(無ければNULL)
+	const SEntry* Find(const SEntry& p_key) const;
+	// キーの項目が無ければ追加する(追加したらtrue)
+	bool Insert(const SEntry& p_key, const int p_distance, const int p_move);
+
+	// ハッシュ表(容量は2の累乗で，格納する状態の数の2倍以上)
+	std::vector<SEntry> m_entries;
+	uint64_t m_indexMask;
+	uint64_t m_numberOfStates;
+	int m_depth;
+
+	// Phase 2の序数からキーを作成するためのTable
+	// Phase 1の完成状態では方向が全て0なので，キーは各序数の部分の論理和になる
+	std::vector<uint64_t> m_cornerPermutationKeys;	// Cornerの順列の序数 -> corners
+	std::vector<uint64_t> m_upDownEdgePermutationKeys;	// Up層・Down層のEdgeの順列の序数 -> edgesの下位32bit
+	std::vector<uint64_t> m_middleEdgePermutationKeys;	// Middle層のEdgeの順列の序数 -> edgesの32~47bit
+};
+
+#endif	// _NEARSOLVEDDATABASE_H_
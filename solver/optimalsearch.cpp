@@ -0,0 +1,181 @@
+﻿#include "optimalsearch.h"
+#include "../solverthread.h"
+
+#include <string>
+#include <sstream>
+#include <algorithm>
+
+COptimalSearch::COptimalSearch(COptimalSolverTables& p_tables)
+	: m_nodes(0),
+	m_threshold(0),
+	m_nextThreshold(0),
+	m_timer(NULL),
+	m_tables(p_tables)
+{
+}
+
+COptimalSearch::~COptimalSearch()
+{
+}
+
+// 最適解探索を開始する
+int COptimalSearch::Solve(const COrdinalCube &p_scrambledCube, int64_t p_timeOut)
+{
+	int iteration = 1;	// 反復回数
+	int result = NOT_FOUND;
+
+	// 同じオブジェクトで何度でも解探索できるように，前回の探索結果を初期化する
+	m_solutionStack.clear();
+
+	// 初期状態の序数
+	int cornerPermutation = p_scrambledCube.GetOrdinalFromCornerPermutation();
+	int twist = p_scrambledCube.GetTwistFromOrientations();
+	int edgeSubset1 = (p_scrambledCube.GetOrdinalFromEdgeSubsetPositions(CCube::UF) << COrdinalCube::EdgeSubsetSize)
+		| p_scrambledCube.GetEdgeSubsetOrientations(CCube::UF);
+	int edgeSubset2 = (p_scrambledCube.GetOrdinalFromEdgeSubsetPositions(CCube::DB) << COrdinalCube::EdgeSubsetSize)
+		| p_scrambledCube.GetEdgeSubsetOrientations(CCube::DB);
+
+	m_threshold = Cost(cornerPermutation, twist, edgeSubset1, edgeSubset2);
+	m_nodes = 1;
+
+	// タイマーConstruct
+    m_timer = new CTimer(p_timeOut);
+	// タイマーStart
+	m_timer->start();
+
+	do{
+        emit notifySolverMessage("[" + QString::number(iteration) + " : optimal threshold = " + QString::number(m_threshold) + "]");
+		m_nextThreshold = InitialSolutionLength;	// コストを最大にする
+
+		// 現在のCubeの状態に対して，深さ0のIDA*探索を開始する
+		result = Search(cornerPermutation, twist, edgeSubset1, edgeSubset2, 0, CMoveSequenceAutomaton::InitialState);
+
+		// 閾値を深くして探索する
+		m_threshold = m_nextThreshold;
+
+		// 反復回数を増やす
+		iteration++;
+
+        emit notifySolverMessage("Optimal nodes = " + QString::number(m_nodes));
+
+		// 解法が見つかるまで続ける
+	} while (result == NOT_FOUND && m_threshold < MaxSolutionLength);
+
+	delete m_timer;
+	m_timer = NULL;
+	return result;
+}
+
+// 見つかった解をreturnする
+std::string COptimalSearch::GetSolution() const
+{
+	if (m_solutionStack.size() >= 1) {
+		return m_solutionStack.at(m_solutionStack.size() - 1);
+	}
+	else {
+		return "Solution was not found.";
+	}
+}
+
+// 再帰的IDA*探索関数
+int COptimalSearch::Search(const int p_cornerPermutation, const int p_twist, const int p_edgeSubset1, const int p_edgeSubset2, const int p_depth, const int p_sequenceState)
+{
+	// 現在のCubeの状態から完成までのコストを計算
+	int cost = Cost(p_cornerPermutation, p_twist, p_edgeSubset1, p_edgeSubset2);
+
+	if (cost == 0) {
+		// 全てのパターンデータベースが0なら完成状態
+		// 閾値を1ずつ深くしているので，最初に見つかった解法が最適解になる
+		PrintAndStackSolution(p_depth);
+		return FOUND;
+	}
+
+	// f = g + h
+	int totalCost = p_depth + cost;
+	if (totalCost > m_threshold) {
+		// 次の探索で用いる閾値を保存する
+		if (totalCost < m_nextThreshold) {
+			m_nextThreshold = totalCost;
+		}
+		return NOT_FOUND;
+	}
+
+	// 一定のノード数ごとにタイマーCheck
+	if ((m_nodes & (TimerCheckInterval - 1)) == 0 && m_timer->isTimeOut()) {
+		return TIME_OUT;
+	}
+
+	// 冗長な移動列にならない移動(オートマトンの状態から1回の参照で求める)
+	// 最小の移動列だけを残すので，最適解は除外されない
+	const CMoveSequenceAutomaton& sequences = m_tables.m_moveSequences;
+	const uint32_t allowedMoves = sequences.GetAllowedMoves(p_sequenceState);
+
+	for (int move = CCube::Move::U; move <= CCube::Move::B; move++) {
+		// 意味の無い動きは除外
+		if (!(allowedMoves & CMoveSequenceAutomaton::GetFaceMoves(move))) continue;
+
+		// 移動指令を保存
+		m_solutionMoves[p_depth] = move;
+
+		// 状態遷移を行う
+		// powerは移動の反復回数
+		for (int power = 1; power < 4; power++) {
+			// MoveTableは18種類の移動を持つので，反復回数によらず1回の参照で求められる
+			int move2 = CCube::GetMoveOfPower(move, power);
+			if (!(allowedMoves & (1u << move2))) continue;
+
+			// 移動指令の反復回数を保存
+			m_solutionPowers[p_depth] = power;
+			// 状態遷移
+			int cornerPermutation2 = m_tables.m_cornerPermutationMoveTable[p_cornerPermutation][move2];
+			int twist2 = m_tables.m_twistMoveTable[p_twist][move2];
+			int edgeSubset1 = CEdgeSubsetPruningTable::ApplyMove(m_tables.m_edgeSubset1MoveTable, p_edgeSubset1, move2);
+			int edgeSubset2 = CEdgeSubsetPruningTable::ApplyMove(m_tables.m_edgeSubset2MoveTable, p_edgeSubset2, move2);
+			// ノードを増やす
+			m_nodes++;
+
+			// 今の状態を起点に，深さを増やして探索
+			int result;
+			if (result = Search(cornerPermutation2, twist2, edgeSubset1, edgeSubset2, p_depth + 1, sequences.GetNextState(p_sequenceState, move2))) {
+				// FOUND,TIME_OUTだったら探索終了
+				return result;
+			}
+		}
+	}
+	return NOT_FOUND;
+}
+
+// heuristicコスト関数
+// 3つのパターンデータベースの最大値を返す
+int COptimalSearch::Cost(const int p_cornerPermutation, const int p_twist, const int p_edgeSubset1, const int p_edgeSubset2) const
+{
+	int cost = m_tables.m_cornerPruningTable.GetValue(
+		m_tables.m_cornerPruningTable.GetIndex(p_cornerPermutation, p_twist));
+	int cost2 = m_tables.m_edgeSubset1PruningTable.GetValue(p_edgeSubset1);
+	if (cost2 > cost) cost = cost2;
+	cost2 = m_tables.m_edgeSubset2PruningTable.GetValue(p_edgeSubset2);
+	if (cost2 > cost) cost = cost2;
+	return cost;
+}
+
+// 見つかった解法を保存する
+void COptimalSearch::PrintAndStackSolution(const int p_length)
+{
+	std::stringstream ss;
+
+	ss << p_length << " ";
+	for (int i = 0; i < p_length; i++) {
+		int move = m_solutionMoves[i];
+		// 90[deg]回転を2回やるなら180[deg]回転，3回やるなら-90[deg]回転に変換する
+		if (m_solutionPowers[i] == 2) {
+			move = CCube::ConvertQuarterTurnToHalfTurnMove(move);
+		}
+		else if (m_solutionPowers[i] == 3) {
+			move = CCube::GetInverseOfMove(move);
+		}
+		ss << CCube::GetNameOfMove(move) << " ";
+	}
+
+    emit notifySolverMessage(QString::fromStdString(ss.str()).trimmed());
+	m_solutionStack.push_back(QString::fromStdString(ss.str()).trimmed().toStdString());
+}
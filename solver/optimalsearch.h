@@ -0,0 +1,96 @@
+﻿// このアルゴリズムでは，Richard E. Korfによる最適解探索を
+// IDA*探索で実行する。
+
+// Two Phase Algorithmと異なり，移動記号<U,D,R,L,F,B>の群を1つのPhaseで探索する。
+// heuristic関数には次の3つのパターンデータベースの最大値を用いる。
+//   Cornerの順列とTwist (8! * 3^7 = 88179840)
+//   UF, UL, UB, UR, DF, DLの6個のEdgeの位置とFlip (12P6 * 2^6 = 42577920)
+//   DB, DR, RF, FL, LB, BRの6個のEdgeの位置とFlip (12P6 * 2^6 = 42577920)
+// どのパターンデータベースも実際のコスト以下の値になる(admissible)ので，
+// 最初に見つかった解法が最適解(もっとも短い解法)になる。
+// ただし，探索には数分から数時間かかることがある。
+
+// Korfの論文はこちら
+// http://www.cs.princeton.edu/courses/archive/fall06/cos402/papers/korfrubik.pdf
+
+#ifndef	_OPTIMALSEARCH_H_
+#define	_OPTIMALSEARCH_H_
+
+#include <vector>
+#include <string>
+#include <QObject>
+
+#include "ordinalcube.h"
+#include "optimalsolvertables.h"
+#include "timer.h"
+
+class COptimalSearch : public QObject
+{
+    Q_OBJECT
+signals:
+    void notifySolverMessage(QString p_message);
+
+public:
+	// 初期化済みのTableを共有して探索を行う
+	// Tableは探索オブジェクトより長く生存していなければならない
+	COptimalSearch(COptimalSolverTables& p_tables);
+	~COptimalSearch();
+
+	enum
+	{
+		NOT_FOUND = 0,	// 現在のノードで解が見つからない
+		FOUND,		// 解が見つかった
+		TIME_OUT	// タイムアウト
+	};
+
+	// 最適解探索を開始する
+	// 呼び出すたびに前回の解探索の結果は破棄される
+	int Solve(const COrdinalCube &p_scrambledCube, int64_t p_timeOut);
+
+	// 見つかった解をreturnする
+	std::string GetSolution() const;
+
+private:
+	enum { InitialSolutionLength = 10000 };	// 解法長さの最大値
+	enum { MaxSolutionLength = 32 };	// 解法長さの最大値(God's numberは20)
+	enum { TimerCheckInterval = 0x10000 };	// タイマーを確認するノード数の間隔
+
+	// 再帰的IDA*探索関数
+	// 再起呼び出しはdepth+1で行う
+	// p_sequenceState : 現在の移動列の冗長な移動を除外するオートマトンの状態
+	int Search(
+		const int p_cornerPermutation,
+		const int p_twist,
+		const int p_edgeSubset1,
+		const int p_edgeSubset2,
+		const int p_depth,
+		const int p_sequenceState
+		);
+
+	// heuristicコスト関数
+	int Cost(
+		const int p_cornerPermutation,
+		const int p_twist,
+		const int p_edgeSubset1,
+		const int p_edgeSubset2
+		) const;
+
+	// 見つかった解法を保存する
+	void PrintAndStackSolution(const int p_length);
+
+	long long m_nodes;	// 現在のノード数
+	int m_threshold;	// 合計コストの足きり基準(cutoff)
+	int m_nextThreshold;	// 次の探索で用いる足きり基準を保存する変数
+
+	int m_solutionMoves[MaxSolutionLength];	// 移動記号
+	int m_solutionPowers[MaxSolutionLength];	// 移動記号の反復回数
+
+	std::vector<std::string> m_solutionStack;	// Solutionを保存するStack
+
+    CTimer *m_timer;	// タイムアウトを計算するオブジェクト
+
+	// 探索で使用するMoveTable,PruningTable(読み出し専用)
+	COptimalSolverTables& m_tables;
+};
+
+#endif	// _OPTIMALSEARCH_H_
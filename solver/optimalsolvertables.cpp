@@ -0,0 +1,75 @@
+﻿#include "optimalsolvertables.h"
+
+COptimalSolverTables::COptimalSolverTables()
+	: m_isInitialized(false),
+	// Clean Cubeを渡してconstructする
+	m_cornerPermutationMoveTable(m_cube),
+	m_edgeSubset1MoveTable(m_cube, CCube::UF),
+	m_edgeSubset2MoveTable(m_cube, CCube::DB),
+
+	// パターンデータベース
+	m_cornerPruningTable(
+		m_cornerPermutationMoveTable, m_twistMoveTable,
+		m_cube.GetOrdinalFromCornerPermutation(), m_cube.GetTwistFromOrientations()),
+	m_edgeSubset1PruningTable(m_edgeSubset1MoveTable,
+		(m_cube.GetOrdinalFromEdgeSubsetPositions(CCube::UF) << COrdinalCube::EdgeSubsetSize)
+		| m_cube.GetEdgeSubsetOrientations(CCube::UF)),
+	m_edgeSubset2PruningTable(m_edgeSubset2MoveTable,
+		(m_cube.GetOrdinalFromEdgeSubsetPositions(CCube::DB) << COrdinalCube::EdgeSubsetSize)
+		| m_cube.GetEdgeSubsetOrientations(CCube::DB))
+{
+    // MoveTable connection
+    connect(&m_cornerPermutationMoveTable, SIGNAL(notifySolverMessage(QString)),
+            this, SLOT(onGetSolverMessage(QString)));
+    connect(&m_edgeSubset1MoveTable, SIGNAL(notifySolverMessage(QString)),
+            this, SLOT(onGetSolverMessage(QString)));
+    connect(&m_edgeSubset2MoveTable, SIGNAL(notifySolverMessage(QString)),
+            this, SLOT(onGetSolverMessage(QString)));
+
+    // PruningTable connection
+    connect(&m_cornerPruningTable, SIGNAL(notifySolverMessage(QString)),
+            this, SLOT(onGetSolverMessage(QString)));
+    connect(&m_edgeSubset1PruningTable, SIGNAL(notifySolverMessage(QString)),
+            this, SLOT(onGetSolverMessage(QString)));
+    connect(&m_edgeSubset2PruningTable, SIGNAL(notifySolverMessage(QString)),
+            this, SLOT(onGetSolverMessage(QString)));
+}
+
+COptimalSolverTables::~COptimalSolverTables()
+{
+}
+
+// MoveTable,PruningTableを初期化する
+bool COptimalSolverTables::Initialize(const CTableBundle* p_bundle)
+{
+	// 既に読み込み済みであれば何もしない
+	if (m_isInitialized) {
+		return true;
+	}
+	bool isLoaded = true;
+	m_fileNames.clear();
+
+	// MoveTableを作成する
+    emit notifySolverMessage("Initializing CornerPermutationMoveTable");
+	isLoaded &= InitializeTable(m_cornerPermutationMoveTable, "CornerPermutationMoveTable.mt", p_bundle);
+    emit notifySolverMessage("Initializing EdgeSubset1MoveTable");
+	isLoaded &= InitializeTable(m_edgeSubset1MoveTable, "EdgeSubset1MoveTable.mt", p_bundle);
+    emit notifySolverMessage("Initializing EdgeSubset2MoveTable");
+	isLoaded &= InitializeTable(m_edgeSubset2MoveTable, "EdgeSubset2MoveTable.mt", p_bundle);
+
+	// パターンデータベースをメモリマップする
+    emit notifySolverMessage("Initializing CornerPatternDatabase");
+	isLoaded &= InitializeTable(m_cornerPruningTable, "CornerPatternDatabase.pt", p_bundle);
+    emit notifySolverMessage("Initializing EdgeSubset1PatternDatabase");
+	isLoaded &= InitializeTable(m_edgeSubset1PruningTable, "EdgeSubset1PatternDatabase.pt", p_bundle);
+    emit notifySolverMessage("Initializing EdgeSubset2PatternDatabase");
+	isLoaded &= InitializeTable(m_edgeSubset2PruningTable, "EdgeSubset2PatternDatabase.pt", p_bundle);
+
+	// 冗長な移動列を除外するオートマトンを作成する
+    emit notifySolverMessage("Initializing MoveSequenceAutomaton");
+	m_moveSequences.Initialize(false, CMoveSequenceAutomaton::Phase1MaxLength);
+    emit notifySolverMessage("States = " + QString::number(m_moveSequences.GetNumberOfStates()));
+
+	m_isInitialized = isLoaded;
+	return isLoaded;
+}
@@ -0,0 +1,80 @@
+﻿#ifndef	_OPTIMALSOLVERTABLES_H_
+#define	_OPTIMALSOLVERTABLES_H_
+
+#include <QObject>
+#include <string>
+#include <vector>
+
+#include "ordinalcube.h"
+#include "tablebundle.h"
+#include "submovetable.h"
+#include "pairpruningtable.h"
+#include "edgesubsetpruningtable.h"
+#include "movesequenceautomaton.h"
+
+// 最適解探索(COptimalSearch)で使用するMoveTable,PruningTableをまとめて保持するクラス
+// Korfの方法と同様に，Corner全体と，Edgeを6個ずつに分けた2つの部分集合のパターンデータベースを用いる
+// パターンデータベースは合計で約86MBになるので，ヒープに読み込まずにメモリマップする
+class COptimalSolverTables : public QObject
+{
+    Q_OBJECT
+public slots:
+    void onGetSolverMessage(QString p_message)
+    {
+        emit notifySolverMessage(p_message);
+    }
+signals:
+    void notifySolverMessage(QString p_message);
+
+public:
+	COptimalSolverTables();
+	~COptimalSolverTables();
+
+	// MoveTable,PruningTableを初期化する
+	// p_bundleを指定したときはバンドルの中のTableだけを使い，1つでも無ければfalseを返す
+	// 指定しないときは，ファイルが存在すればメモリマップし，無ければ作成して保存する
+	bool Initialize(const CTableBundle* p_bundle = NULL);
+
+	// Initializeで使用したTableのファイル名(バンドルの作成に使用する)
+	const std::vector<std::string>& GetFileNames() const { return m_fileNames; }
+
+	// Tableの初期化が完了しているか
+	bool IsInitialized() const { return m_isInitialized; }
+
+private:
+	// Tableを初期化して，ファイル名を記録する
+	template <class TTable>
+	bool InitializeTable(TTable& p_table, const std::string p_fileName, const CTableBundle* p_bundle)
+	{
+		m_fileNames.push_back(p_fileName);
+		return p_table.Initialize(p_fileName, p_bundle);
+	}
+
+	// 探索クラスからTableを直接参照する
+	friend class COptimalSearch;
+
+	// Tableの初期化が完了しているか
+	bool m_isInitialized;
+	// Tableのファイル名
+	std::vector<std::string> m_fileNames;
+
+	// MoveTableの初期化に使用するための変数
+	COrdinalCube m_cube;
+
+	// MoveTable
+	CCornerPermutationMoveTable m_cornerPermutationMoveTable;
+	CTwistMoveTable m_twistMoveTable;	// コンパイル時に作成済み
+	CEdgeSubsetMoveTable m_edgeSubset1MoveTable;	// UF, UL, UB, UR, DF, DL
+	CEdgeSubsetMoveTable m_edgeSubset2MoveTable;	// DB, DR, RF, FL, LB, BR
+
+	// PruningTable(パターンデータベース)
+	CPairPruningTable<CCornerPermutationMoveTable, CTwistMoveTable> m_cornerPruningTable;	// Cornerの順列 * twist = 88179840
+	CEdgeSubsetPruningTable m_edgeSubset1PruningTable;	// 12P6 * 2^6 = 42577920
+	CEdgeSubsetPruningTable m_edgeSubset2PruningTable;	// 12P6 * 2^6 = 42577920
+
+	// 冗長な移動列を除外するオートマトン(ファイルには保存せず，起動時に作成する)
+	// 18種類の移動を1つのPhaseで探索するので，Two Phase AlgorithmのPhase 1と同じものを用いる
+	CMoveSequenceAutomaton m_moveSequences;
+};
+
+#endif	// _OPTIMALSOLVERTABLES_H_
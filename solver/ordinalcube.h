@@ -2,6 +2,7 @@
 #define	_ORDINALCUBE_H_
 
 #include "cube.h"
+#include "calculateordinal.h"
 
 // 各種Ordinalを求めるためのクラス
 class COrdinalCube : public CCube
@@ -18,7 +19,15 @@ public:
 		Choices = 495, // 12 choose 4 = 495
 		CornerPermutations = (8 * 7 * 6 * 5 * 4 * 3 * 2 * 1), // 8! = 40320
 		UpDownEdgePermutations = (8 * 7 * 6 * 5 * 4 * 3 * 2 * 1), // 8! = 40320
-		MiddleEdgePermutations = (4 * 3 * 2 * 1) // 4! = 24
+		MiddleEdgePermutations = (4 * 3 * 2 * 1), // 4! = 24
+		// Phase 1の探索中に追跡するPhase 2の座標
+		UpDownEdgeSplitSize = 3,	// Up層・Down層のEdgeを分割した1つの組に含まれるEdgeの数
+		UpDownEdgeSplitPositions = (12 * 11 * 10), // 12P3 = 1320
+		MiddleEdgePositions = (12 * 11 * 10 * 9), // 12P4 = 11880
+		// 最適解探索
+		EdgeSubsetSize = 6,	// 1つのEdgeの部分集合に含まれるEdgeの数
+		EdgeSubsetPositions = (12 * 11 * 10 * 9 * 8 * 7), // 12P6 = 665280
+		EdgeSubsetOrientations = (2 * 2 * 2 * 2 * 2 * 2) // 2^6 = 64
 	};
 
 	// Phase 1
@@ -62,16 +71,243 @@ public:
 	// この関数はclean cubeに対してのみ有効
 	void SetMiddleEdgePermutationFromOrdinal(const int p_ordinal);
 
-private:
-	// Middle層のEdgeか判断する
-	static int IsMiddleEdgeCubie(const int p_cubie);
+	// 状態の配列と序数の変換
+	// コンパイル時にMoveTableを作成するときにも使用するので，constexprの静的関数にする
+
+	// 8個のCornerの方向の配列からtwistを計算する
+	static constexpr int GetTwistFromOrientations(const int* p_cornerOrientations);
+	// twistから8個のCornerの方向の配列を設定する
+	static constexpr void SetOrientationsFromTwist(int p_twist, int* p_cornerOrientations);
+
+	// 12個のEdgeの方向の配列からflipを計算する
+	static constexpr int GetFlipFromOrientations(const int* p_edgeOrientations);
+	// flipから12個のEdgeの方向の配列を設定する
+	static constexpr void SetOrientationsFromFlip(int p_flip, int* p_edgeOrientations);
 
-	// Middle層のEdgeの順列から，Middle層のEdgeの順列を表現するuniqueな序数を計算する
-	static int ChoiceOrdinal(int* p_choicePermutation);
+	// Edgeの順列からchoiceを計算する
+	static constexpr int GetChoiceFromEdgePermutation(const int* p_edgePermutation);
 
 	// 序数から，それに対してuniqueなMidlle層のEdgeの順列を求める
 	// 割り当てられないEdge(Up層・Down層)はInvalidSetとして返される
-	static void ChoicePermutation(int p_choiceOrdinal, int* choicePermutation);
+	static constexpr void ChoicePermutation(int p_choiceOrdinal, int* choicePermutation);
+
+	// 最適解探索
+
+	// p_firstEdgeから連続するp_numberOfEdges個(標準は6個)のEdgeの位置を表現するuniqueな序数を計算する
+	// (Phase 1の探索中に追跡するPhase 2の座標にも使用する)
+	int GetOrdinalFromEdgeSubsetPositions(const int p_firstEdge, const int p_numberOfEdges = EdgeSubsetSize) const;
+	// 序数から，p_firstEdgeから連続するp_numberOfEdges個のEdgeの位置を設定する
+	// 残りのEdgeは空いている位置に順番に配置し，全てのEdgeのOrientationは0にする
+	void SetEdgeSubsetPositionsFromOrdinal(const int p_ordinal, const int p_firstEdge, const int p_numberOfEdges = EdgeSubsetSize);
+	// p_firstEdgeから連続する6個のEdgeのOrientationを6ビットで表現する
+	// (p_firstEdge + i)番目のEdgeのOrientationがiビット目になる
+	int GetEdgeSubsetOrientations(const int p_firstEdge) const;
+
+private:
+	// Middle層のEdgeか判断する
+	static constexpr int IsMiddleEdgeCubie(const int p_cubie);
+
+	// Middle層のEdgeの位置のbit(12bit)から，Middle層のEdgeの順列を表現するuniqueな序数を計算する
+	static constexpr int ChoiceOrdinal(const int p_choiceMask);
 };
 
+// 状態の配列と序数の変換(constexpr)
+
+// 8個のCornerの方向の配列から
+// Cornerの方向の組み合わせを0~2186のuniqueな序数(twist)で表現する
+constexpr int COrdinalCube::GetTwistFromOrientations(const int* p_cornerOrientations)
+{
+	// ex. CornerSetOrientations = 0 0 0 0 0 0 1 2 のとき twist = 5
+	//     CornerSetOrientations = 0 0 0 0 0 1 1 1 のとき twist = 13
+	//     CornerSetOrientations = 0 0 0 0 0 1 1 2 のとき twist = 14
+	//     CornerSetOrientations = 0 0 0 0 0 1 2 0 のとき twist = 15
+
+	int twist = 0;
+	for (int corner = FirstCornerSet; corner < LastCornerSet; corner++) {
+		twist = twist * 3 + p_cornerOrientations[corner];
+	}
+
+	return twist;
+}
+
+// 8個のCornerの方向の配列を設定
+// Cornerにtwistで設定される回転状態を設定する
+constexpr void COrdinalCube::SetOrientationsFromTwist(int p_twist, int* p_cornerOrientations)
+{
+	int paritySum = 0;	// Cornerの回転(なし:0，時計回り:1，反時計回り2)を加算する
+
+	// CornerSetOrientationsを設定
+	// 最後以外の7個のCornerにtwistで設定される3種類の回転を設定する
+	// 10進数の3進数表記と同等
+	// ex. twist = 0 のとき 0 0 0 0 0 0 0
+	//     twist = 1 のとき 0 0 0 0 0 0 1
+	//     twist = 2 のとき 0 0 0 0 0 0 2
+	//     ...
+	//     twist = 5 のとき 0 0 0 0 0 1 2
+	//     twist = 6 のとき 0 0 0 0 0 2 0
+	//     twist = 7 のとき 0 0 0 0 0 2 1
+	//     twist = 8 のとき 0 0 0 0 0 2 2
+	//     twist = 9 のとき 0 0 0 0 1 0 0
+	//     ...
+	//     この操作で，twistに対応したuniqueなCornerの状態を作成することが出来る
+
+	for (int corner =  LastCornerSet - 1; corner >= FirstCornerSet; corner--){
+		paritySum += (p_cornerOrientations[corner] = p_twist % 3);
+		p_twist /= 3;
+	}
+
+	// 最後のCornerを設定する
+	// CornerSetOrientationsの和は3の倍数でなければならないので
+	// そうなるように最後のCornerを設定する
+	// (8個の和 % 3 == 0 にならなければならない)
+
+	p_cornerOrientations[LastCornerSet] = (3 - paritySum % 3) % 3;
+}
+
+// 12個のEdgeの方向の配列から
+// Edgeの方向の組み合わせを0~2047のuniqueな序数(flip)で表現する
+constexpr int COrdinalCube::GetFlipFromOrientations(const int* p_edgeOrientations)
+{
+	// ex. EdgeSetOrientations = 0 0 0 0 0 0 0 0 0 0 0 0 のとき flip = 0
+	//     EdgeSetOrientations = 0 0 0 0 0 0 0 0 0 0 1 1 のとき flip = 3
+	//     EdgeSetOrientations = 0 0 0 0 0 0 0 0 0 1 0 1 のとき flip = 5
+
+	int flip = 0;
+	for (int edge = FirstEdgeSet; edge < LastEdgeSet; edge++) {
+		flip = flip * 2 + p_edgeOrientations[edge];
+	}
+	return flip;
+}
+
+// 12個のEdgeの方向の配列を設定
+// 12個のEdgeにflipで設定される2種類の反転を設定する
+constexpr void COrdinalCube::SetOrientationsFromFlip(int p_flip, int* p_edgeOrientations)
+{
+	int paritySum = 0;	// Edgeの反転(0:なし，1:反転)を加算する
+
+	// EdgeSetOrientationsを設定
+	// 最後以外の11個のEdgeにflipで設定される2種類の反転を設定する
+	// 10進数の2進数表記と同等
+	// ex. flip = 0 のとき 0 0 0 0 0 0 0 0 0 0 0
+	//     flip = 1 のとき 0 0 0 0 0 0 0 0 0 0 1
+	//     flip = 2 のとき 0 0 0 0 0 0 0 0 0 1 0
+	//     ...
+	//     この操作で，flipに対応したuniqueなCornerの状態を作成することが出来る
+
+	for (int edge = LastEdgeSet - 1; edge >= FirstEdgeSet; edge--) {
+		paritySum += (p_edgeOrientations[edge] = p_flip % 2);
+		p_flip /= 2;
+	}
+
+	// 最後のEdgeを設定する
+	// EdgeSetOrientationsの和は2の倍数でなければならないので
+	// そうなるように最後のEdgeを設定する
+	// (12個の和 % 2 == 0 にならなければならない)
+
+	p_edgeOrientations[LastEdgeSet] = paritySum % 2;
+}
+
+// Edgeの順列から，Middle層のEdgeの順列を表現するuniqueな序数を計算する
+constexpr int COrdinalCube::GetChoiceFromEdgePermutation(const int* p_edgePermutation)
+{
+	int choiceMask = 0;	// Middle層のEdgeがある位置のbit
+
+	// Edgeの順列から，Middle層の4つのEdgeの位置を求める
+	for (int edge = FirstEdgeSet; edge <= LastEdgeSet; edge++) {
+		// edgeの位置にある要素がMiddle層ならedgeの位置のbitを立てる
+		choiceMask |= IsMiddleEdgeCubie(p_edgePermutation[edge]) << edge;
+	}
+	return ChoiceOrdinal(choiceMask);
+}
+
+// Middle層のEdgeかどうかを判別する
+constexpr int COrdinalCube::IsMiddleEdgeCubie(const int p_cubie)
+{
+	return p_cubie >= FirstMiddleEdgeSet && p_cubie <= LastMiddleEdgeSet;
+}
+
+// Middle位置のEdgeのPermutationからuniqueなoridinal(0 - 494)を求めるために
+// 以下のアルゴリズムを用いる
+// アルゴリズムはコンパイル時にCreateChoiceTable(calculateordinal.h)で全ての組み合わせに対して評価し，
+// 実行時にはMiddle層のEdgeの位置のbitでTableを引く
+
+// <参照しているedgeがMiddleEdge位置のとき>
+// 未チェックのEdge数を減らす(3個 -> 2個 -> 1個)
+//
+// <参照しているedgeがMiddleEdge位置ではないとき>
+// 一番大きなMiddleEdge以外(3個)のうち，未チェックのもの(k個:3個 -> 2個 -> 1個)を
+// 現在参照しているedgeより右側(n要素)への格納する場合の組み合わせの数C(n, k)を加算する
+// ex.[2 1 3 5] のとき edgeMarkVector = [0 1 1 1 0 1 ... 0], C(11, 3) + C(7, 0) = 166
+//    edge = 0 : 残りのMiddleEdge数が4個のとき，4-1=3個(最後の分を引く)の値を11箇所に当てはめる場合の数はC(11, 3) : 加算する
+//    edge = 1 : 残りのMiddleEdge数が3個になる
+//    edge = 2 : 残りのMiddleEdge数が2個になる
+//    edge = 3 : 残りのMiddleEdge数が1個になる
+// 未チェックのEdge数が1個になったら，3番目と4番目のEdgeの要素の間にMiddleEdge以外の要素がいくつあるかを加算する
+//    edge = 4 : 残りのMiddleEdge数が1個のとき，1-1=0個の値を7箇所に当てはめる場合の数はC(7, 0) : 加算する
+// 以上のアルゴリズムで，(0 - 11)の数字から4つを選んだ時の組み合わせをuniqueな数字で表現することが出来る
+// 行っている操作は，C(n, k)の加算なので1つのループで実現することが出来る
+
+// ex.全体で6個のEdgeのうち，3個のEdgeがchoiceされる場合の例
+
+// 0,2,4 のとき edgeMarkVector = [1 0 1 0 1 0]
+//		edge = 0 : 残りのChoicedEdge数が2個になる
+//		edge = 1 : 2-1=1個の値を4箇所に当てはめる場合の数はC(4, 1) = 4
+//		edge = 2 : 残りのChoicedEdge数が1個になる
+//		edge = 3 : 1-1=0個の値を2箇所に当てはめる場合の数はC(2, 0) = 1
+//		edge = 4 : 残りのChoicedEdge数が0個になる
+//		加算すると 5
+
+// 1,2,5 のとき edgeMarkVector = [0 1 1 0 0 1]
+//		edge = 0 : 3-1=2個の値を5箇所に当てはめる場合の数はC(5, 2) = 10
+//		edge = 1 : 残りのChoicedEdge数が2個になる
+//		edge = 2 : 残りのChoicedEdge数が1個になる
+//		edge = 3 : 1-1=0個の値を2箇所に当てはめる場合の数はC(2, 0) = 1
+//		edge = 4 : 1-1=0個の値を1箇所に当てはめる場合の数はC(1, 0) = 1
+//		edge = 5 : 残りのChoicedEdge数が0個になる
+//		加算すると 12
+
+// 1,3,4 のとき edgeMarkVector = [0 1 0 1 1 0]
+//		edge = 0 : 3-1=2個の値を5箇所に当てはめる場合の数はC(5, 2) = 10
+//		edge = 1 : 残りのChoicedEdge数が2個になる
+//		edge = 2 : 2-1=1個の値を3箇所に当てはめる場合の数はC(3, 1) = 3
+//		edge = 3 : 残りのChoicedEdge数が1個になる
+//		edge = 4 : 残りのChoicedEdge数が0個になる
+//		加算すると 13
+
+// 245 のとき edgeMarkVector = [0 0 1 0 1 1]
+//		edge = 0 : 3-1=2個の値を5箇所に当てはめる場合の数はC(5, 2) = 10
+//		edge = 1 : 3-1=2個の値を4箇所に当てはめる場合の数はC(4, 2) = 6
+//		edge = 2 : 残りのChoicedEdge数が2個になる
+//		edge = 3 : 2-1=1個の値を2箇所に当てはめる場合の数はC(2, 1) = 2
+//		edge = 4 : 残りのChoicedEdge数が1個になる
+//		edge = 4 : 残りのChoicedEdge数が0個になる
+//		加算すると 18
+
+// Middle層のEdgeの位置のbitから，Middle層のEdgeの順列を表現するuniqueな序数を計算する
+// ex.[0 1 2 4] のとき choiceMask = 0b000000010111, C(8, 0) = 1
+// ex.[2 1 3 5] のとき choiceMask = 0b000000101110, C(11, 3) + C(7, 0) = 166
+constexpr int COrdinalCube::ChoiceOrdinal(const int p_choiceMask)
+{
+	return COrdinalTables::Choices.maskToOrdinal[p_choiceMask];
+}
+
+// 序数から，それに対してuniqueなMidlle層のEdgeの順列を求める
+// 割り当てられないEdge(Up層・Down層)はInvalidSetとして返される
+// 序数からMiddle層のEdgeの位置のbitをTableで求め，位置の小さいものから順にMiddle層のEdgeを割り当てる
+// (Tableは，C(n, k)のkを一定としてnを減らしながら序数から引いていく逆演算と同じ結果になる)
+constexpr void COrdinalCube::ChoicePermutation(int p_choiceOrdinal, int* choicePermutation)
+{
+	const int choiceMask = COrdinalTables::Choices.ordinalToMask[p_choiceOrdinal];
+	int edgeOfMiddleEdges = 0;
+
+	for (int edge = 0; edge < NumberOfEdgeSets; edge++) {
+		if ((choiceMask >> edge) & 1) {
+			choicePermutation[edge] = FirstMiddleEdgeSet + edgeOfMiddleEdges++;
+		}
+		else {
+			choicePermutation[edge] = InvalidSet;
+		}
+	}
+}
+
 #endif // _ORDINALCUBE_H_
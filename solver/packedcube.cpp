@@ -0,0 +1,98 @@
+﻿#include "packedcube.h"
+
+#if defined(PACKEDCUBE_SSSE3_DISPATCH)
+#include <intrin.h>	// __cpuid
+#endif
+
+// 18種類の移動の並べ替えと方向の加算
+const CPackedCube::SMoveTable CPackedCube::MoveTable = CPackedCube::CreateMoveTable();
+
+#if defined(PACKEDCUBE_SSSE3_DISPATCH)
+// 実行しているCPUがSSSE3を使えるか
+const bool CPackedCube::HasSsse3 = CPackedCube::IsSsse3Supported();
+
+// CPUID(EAX = 1)のECXのbit 9がSSSE3
+bool CPackedCube::IsSsse3Supported()
+{
+	int info[4];
+	__cpuid(info, 1);
+	return (info[2] & (1 << 9)) != 0;
+}
+#endif
+
+// Clean Cubeで初期化する
+CPackedCube::CPackedCube()
+{
+	SetCleanCube();
+}
+
+// CCubeの状態で初期化する
+CPackedCube::CPackedCube(const CCube& p_cube)
+{
+	SetState(p_cube);
+}
+
+// Clean Cubeに戻す
+void CPackedCube::SetCleanCube()
+{
+	for (int i = 0; i < RegisterSize; i++) {
+		m_corners[i] = (uint8_t)i;
+		m_edges[i] = (uint8_t)i;
+	}
+}
+
+// CCubeの状態を設定する
+void CPackedCube::SetState(const CCube& p_cube)
+{
+	SetCleanCube();
+	for (int corner = CCube::FirstCornerSet; corner <= CCube::LastCornerSet; corner++) {
+		SetCorner(corner, p_cube.GetCornerPermutation()[corner], p_cube.GetCornerOrientations()[corner]);
+	}
+	for (int edge = CCube::FirstEdgeSet; edge <= CCube::LastEdgeSet; edge++) {
+		SetEdge(edge, p_cube.GetEdgePermutation()[edge], p_cube.GetEdgeOrientations()[edge]);
+	}
+}
+
+// CCubeの状態を取得する
+void CPackedCube::GetState(CCube& p_cube) const
+{
+	int cornerPermutation[CCube::NumberOfCornerSets];
+	int cornerOrientations[CCube::NumberOfCornerSets];
+	int edgePermutation[CCube::NumberOfEdgeSets];
+	int edgeOrientations[CCube::NumberOfEdgeSets];
+
+	for (int corner = CCube::FirstCornerSet; corner <= CCube::LastCornerSet; corner++) {
+		cornerPermutation[corner] = GetCorner(corner);
+		cornerOrientations[corner] = GetCornerOrientation(corner);
+	}
+	for (int edge = CCube::FirstEdgeSet; edge <= CCube::LastEdgeSet; edge++) {
+		edgePermutation[edge] = GetEdge(edge);
+		edgeOrientations[edge] = GetEdgeOrientation(edge);
+	}
+	p_cube.SetState(cornerPermutation, cornerOrientations, edgePermutation, edgeOrientations);
+}
+
+// CCube::CubieMovesから18種類の移動の並べ替えと方向の加算を作成する
+CPackedCube::SMoveTable CPackedCube::CreateMoveTable()
+{
+	SMoveTable table;
+	for (int move = CCube::U; move < CCube::NumberOfMoves; move++) {
+		const CCube::SCubieMove& cubieMove = CCube::CubieMoves[move];
+		SMove& packedMove = table.moves[move];
+		for (int i = 0; i < RegisterSize; i++) {
+			packedMove.cornerShuffles[i] = (uint8_t)i;
+			packedMove.cornerTwists[i] = 0;
+			packedMove.edgeShuffles[i] = (uint8_t)i;
+			packedMove.edgeFlips[i] = 0;
+		}
+		for (int corner = CCube::FirstCornerSet; corner <= CCube::LastCornerSet; corner++) {
+			packedMove.cornerShuffles[corner] = (uint8_t)cubieMove.cornerPermutation[corner];
+			packedMove.cornerTwists[corner] = (uint8_t)(cubieMove.cornerTwists[corner] << OrientationShift);
+		}
+		for (int edge = CCube::FirstEdgeSet; edge <= CCube::LastEdgeSet; edge++) {
+			packedMove.edgeShuffles[edge] = (uint8_t)cubieMove.edgePermutation[edge];
+			packedMove.edgeFlips[edge] = (uint8_t)(cubieMove.edgeFlips[edge] << OrientationShift);
+		}
+	}
+	return table;
+}
@@ -0,0 +1,268 @@
+﻿#ifndef	_PACKEDCUBE_H_
+#define	_PACKEDCUBE_H_
+
+#include <cstdint>
+#include <cstring>
+
+// SSSE3の命令(pshufb)を使うか
+// - GCC/Clang : -mssse3(または/arch相当のオプション)で__SSSE3__が定義されたときに常に使う
+// - MSVC : __SSSE3__を定義しないが，オプション無しでintrinsicを使えるので，
+//   /arch:AVX以上なら常に使い，それ以外のx86/x64では起動時にCPUIDで確認してから使う
+#if defined(__SSSE3__) || (defined(_MSC_VER) && defined(__AVX__))
+#define PACKEDCUBE_SSSE3
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define PACKEDCUBE_SSSE3
+#define PACKEDCUBE_SSSE3_DISPATCH
+#endif
+
+#if defined(PACKEDCUBE_SSSE3)
+#include <tmmintrin.h>	// pshufb
+#endif
+
+#include "cube.h"
+#include "calculateordinal.h"
+
+// 1つのCubieを1byte(下位4bit:Cubie，上位4bit:方向)で表したCube
+// Cornerの8byteとEdgeの12byteをそれぞれ16byte境界に揃えた配列に格納し，
+// 18種類のどの移動も，byteの並べ替え1回と方向の加算だけで行う
+// SSSE3が使えるときは並べ替えをpshufb，方向の加算をpaddb/pxorの1命令ずつで行う
+// (使えないときは通常の配列の操作で行う)
+// CCubeより状態が小さく移動が速いので，Cubieの状態を直接扱う大量の移動(データベースの作成など)に使用する
+// 鏡映された回転状態(CornerのOrientationが3以上)は扱わない
+class CPackedCube
+{
+public:
+	// Clean Cubeで初期化する
+	CPackedCube();
+	// CCubeの状態で初期化する
+	explicit CPackedCube(const CCube& p_cube);
+
+	// Clean Cubeに戻す
+	void SetCleanCube();
+
+	// CCubeの状態を設定・取得する
+	void SetState(const CCube& p_cube);
+	void GetState(CCube& p_cube) const;
+
+	// 同じ状態かを判別する演算子
+	bool operator==(const CPackedCube& p_cube) const
+	{
+		return !std::memcmp(m_corners, p_cube.m_corners, sizeof(m_corners))
+			&& !std::memcmp(m_edges, p_cube.m_edges, sizeof(m_edges));
+	}
+	bool operator!=(const CPackedCube& p_cube) const
+	{
+		return !(*this == p_cube);
+	}
+
+	// cubeの移動を行う
+	inline void ApplyMove(const int p_move);
+	// 移動を先に行った状態にする(移動 * cube)
+	// cubeの逆元に移動の逆を行うと，cubeに移動を行った状態の逆元になる
+	inline void PremultiplyMove(const int p_move);
+
+	// COrdinalCubeと同じPhase 1の序数(twist, flip, choice)
+	inline int GetTwist() const;
+	inline int GetFlip() const;
+	inline int GetChoice() const;
+
+	// 位置cornerのCornerと方向
+	int GetCorner(const int p_corner) const { return m_corners[p_corner] & CubieMask; }
+	int GetCornerOrientation(const int p_corner) const { return m_corners[p_corner] >> OrientationShift; }
+	// 位置edgeのEdgeと方向
+	int GetEdge(const int p_edge) const { return m_edges[p_edge] & CubieMask; }
+	int GetEdgeOrientation(const int p_edge) const { return m_edges[p_edge] >> OrientationShift; }
+
+	// 位置cornerのCornerと方向を設定する
+	void SetCorner(const int p_corner, const int p_cubie, const int p_orientation)
+	{
+		m_corners[p_corner] = (uint8_t)(p_cubie | (p_orientation << OrientationShift));
+	}
+	// 位置edgeのEdgeと方向を設定する
+	void SetEdge(const int p_edge, const int p_cubie, const int p_orientation)
+	{
+		m_edges[p_edge] = (uint8_t)(p_cubie | (p_orientation << OrientationShift));
+	}
+
+private:
+	enum
+	{
+		OrientationShift = 4,	// 1byteの中の方向の位置
+		CubieMask = 0x0f,
+		RegisterSize = 16	// 1回の並べ替えで扱うbyte数
+	};
+
+	// 1つの移動の並べ替えと方向の加算
+	// shuffles[i]は移動後の位置iに来るCubieの移動前の位置(CCube::SCubieMoveと同じ)
+	// orientations[i]は位置iで加える方向(上位4bit)
+	// 使わないbyte(Cornerの8~15，Edgeの12~15)はそのままの位置に置き，方向を加えない
+	struct SMove
+	{
+		alignas(RegisterSize) uint8_t cornerShuffles[RegisterSize];
+		alignas(RegisterSize) uint8_t cornerTwists[RegisterSize];
+		alignas(RegisterSize) uint8_t edgeShuffles[RegisterSize];
+		alignas(RegisterSize) uint8_t edgeFlips[RegisterSize];
+	};
+
+	// 18種類の移動の並べ替えと方向の加算
+	struct SMoveTable
+	{
+		SMove moves[CCube::NumberOfMoves];
+	};
+	// CCube::CubieMovesから作成する
+	static SMoveTable CreateMoveTable();
+	// 起動時に1回だけ作成する(静的変数の初期化中には移動を行わない)
+	static const SMoveTable MoveTable;
+
+	// SSSE3の命令と通常の配列の操作による移動
+#if defined(PACKEDCUBE_SSSE3)
+	inline void ApplyMoveSsse3(const SMove& p_move);
+	inline void PremultiplyMoveSsse3(const SMove& p_move);
+#endif
+	inline void ApplyMoveScalar(const SMove& p_move);
+	inline void PremultiplyMoveScalar(const SMove& p_move);
+
+#if defined(PACKEDCUBE_SSSE3_DISPATCH)
+	// 実行しているCPUがSSSE3を使えるか(起動時に1回だけCPUIDで確認する)
+	static bool IsSsse3Supported();
+	static const bool HasSsse3;
+#endif
+
+	alignas(RegisterSize) uint8_t m_corners[RegisterSize];
+	alignas(RegisterSize) uint8_t m_edges[RegisterSize];
+};
+
+// cubeの移動を行う
+inline void CPackedCube::ApplyMove(const int p_move)
+{
+#if defined(PACKEDCUBE_SSSE3_DISPATCH)
+	if (HasSsse3) {
+		ApplyMoveSsse3(MoveTable.moves[p_move]);
+	}
+	else {
+		ApplyMoveScalar(MoveTable.moves[p_move]);
+	}
+#elif defined(PACKEDCUBE_SSSE3)
+	ApplyMoveSsse3(MoveTable.moves[p_move]);
+#else
+	ApplyMoveScalar(MoveTable.moves[p_move]);
+#endif
+}
+
+// 移動を先に行った状態にする(移動 * cube)
+inline void CPackedCube::PremultiplyMove(const int p_move)
+{
+#if defined(PACKEDCUBE_SSSE3_DISPATCH)
+	if (HasSsse3) {
+		PremultiplyMoveSsse3(MoveTable.moves[p_move]);
+	}
+	else {
+		PremultiplyMoveScalar(MoveTable.moves[p_move]);
+	}
+#elif defined(PACKEDCUBE_SSSE3)
+	PremultiplyMoveSsse3(MoveTable.moves[p_move]);
+#else
+	PremultiplyMoveScalar(MoveTable.moves[p_move]);
+#endif
+}
+
+#if defined(PACKEDCUBE_SSSE3)
+// cubeの移動をSSSE3の命令で行う
+inline void CPackedCube::ApplyMoveSsse3(const SMove& p_move)
+{
+	const __m128i corners = _mm_shuffle_epi8(_mm_load_si128((const __m128i*)m_corners), _mm_load_si128((const __m128i*)p_move.cornerShuffles));
+	const __m128i edges = _mm_shuffle_epi8(_mm_load_si128((const __m128i*)m_edges), _mm_load_si128((const __m128i*)p_move.edgeShuffles));
+
+	// Cornerの方向は3以上になったら3を引く
+	// (方向が3未満のbyteは3を引くと桁あふれして大きな値になるので，小さい方を選べばよい)
+	const __m128i twisted = _mm_add_epi8(corners, _mm_load_si128((const __m128i*)p_move.cornerTwists));
+	const __m128i wrapped = _mm_sub_epi8(twisted, _mm_set1_epi8(CCube::NumberOfTwists << OrientationShift));
+	_mm_store_si128((__m128i*)m_corners, _mm_min_epu8(twisted, wrapped));
+	// Edgeの方向は排他的論理和で反転する
+	_mm_store_si128((__m128i*)m_edges, _mm_xor_si128(edges, _mm_load_si128((const __m128i*)p_move.edgeFlips)));
+}
+
+// 移動を先に行った状態にする(移動 * cube)
+// 位置iのCubieを，移動後の状態でそのCubieの位置にあるCubieに置き換えて，そのCubieの方向を加える
+inline void CPackedCube::PremultiplyMoveSsse3(const SMove& p_move)
+{
+	const __m128i cubieMask = _mm_set1_epi8(CubieMask);
+	const __m128i corners = _mm_load_si128((const __m128i*)m_corners);
+	const __m128i edges = _mm_load_si128((const __m128i*)m_edges);
+	// Clean Cubeに移動を行った状態(Cubie + 方向)をcubeのCubieで並べ替える
+	const __m128i moveCorners = _mm_or_si128(_mm_load_si128((const __m128i*)p_move.cornerShuffles), _mm_load_si128((const __m128i*)p_move.cornerTwists));
+	const __m128i moveEdges = _mm_or_si128(_mm_load_si128((const __m128i*)p_move.edgeShuffles), _mm_load_si128((const __m128i*)p_move.edgeFlips));
+	const __m128i shuffledCorners = _mm_shuffle_epi8(moveCorners, _mm_and_si128(corners, cubieMask));
+	const __m128i shuffledEdges = _mm_shuffle_epi8(moveEdges, _mm_and_si128(edges, cubieMask));
+
+	// cubeの方向を加える(ApplyMoveと同じく，Cornerは3以上なら3を引き，Edgeは排他的論理和)
+	const __m128i twisted = _mm_add_epi8(shuffledCorners, _mm_andnot_si128(cubieMask, corners));
+	const __m128i wrapped = _mm_sub_epi8(twisted, _mm_set1_epi8(CCube::NumberOfTwists << OrientationShift));
+	_mm_store_si128((__m128i*)m_corners, _mm_min_epu8(twisted, wrapped));
+	_mm_store_si128((__m128i*)m_edges, _mm_xor_si128(shuffledEdges, _mm_andnot_si128(cubieMask, edges)));
+}
+#endif
+
+// cubeの移動を通常の配列の操作で行う
+inline void CPackedCube::ApplyMoveScalar(const SMove& p_move)
+{
+	// 使わないbyteはそのままなので，Cornerの8byteとEdgeの12byteだけを並べ替える
+	uint8_t corners[CCube::NumberOfCornerSets];
+	uint8_t edges[CCube::NumberOfEdgeSets];
+	for (int corner = CCube::FirstCornerSet; corner <= CCube::LastCornerSet; corner++) {
+		int twisted = m_corners[p_move.cornerShuffles[corner]] + p_move.cornerTwists[corner];
+		corners[corner] = (uint8_t)((twisted >= (CCube::NumberOfTwists << OrientationShift)) ? twisted - (CCube::NumberOfTwists << OrientationShift) : twisted);
+	}
+	for (int edge = CCube::FirstEdgeSet; edge <= CCube::LastEdgeSet; edge++) {
+		edges[edge] = m_edges[p_move.edgeShuffles[edge]] ^ p_move.edgeFlips[edge];
+	}
+	std::memcpy(m_corners, corners, sizeof(corners));
+	std::memcpy(m_edges, edges, sizeof(edges));
+}
+
+// 移動を先に行った状態にする(移動 * cube)
+inline void CPackedCube::PremultiplyMoveScalar(const SMove& p_move)
+{
+	// 各byteは自分自身のCubieだけで決まるので，そのまま書き換えてよい
+	for (int corner = CCube::FirstCornerSet; corner <= CCube::LastCornerSet; corner++) {
+		const int cubie = m_corners[corner] & CubieMask;
+		int twisted = (p_move.cornerShuffles[cubie] | p_move.cornerTwists[cubie]) + (m_corners[corner] & ~CubieMask);
+		m_corners[corner] = (uint8_t)((twisted >= (CCube::NumberOfTwists << OrientationShift)) ? twisted - (CCube::NumberOfTwists << OrientationShift) : twisted);
+	}
+	for (int edge = CCube::FirstEdgeSet; edge <= CCube::LastEdgeSet; edge++) {
+		const int cubie = m_edges[edge] & CubieMask;
+		m_edges[edge] = (uint8_t)((p_move.edgeShuffles[cubie] | p_move.edgeFlips[cubie]) ^ (m_edges[edge] & ~CubieMask));
+	}
+}
+
+// 最後以外の7個のCornerの方向を3進数で表す(COrdinalCube::GetTwistFromOrientationsと同じ)
+inline int CPackedCube::GetTwist() const
+{
+	int twist = 0;
+	for (int corner = CCube::FirstCornerSet; corner < CCube::LastCornerSet; corner++) {
+		twist = twist * CCube::NumberOfTwists + GetCornerOrientation(corner);
+	}
+	return twist;
+}
+
+// 最後以外の11個のEdgeの方向を2進数で表す(COrdinalCube::GetFlipFromOrientationsと同じ)
+inline int CPackedCube::GetFlip() const
+{
+	int flip = 0;
+	for (int edge = CCube::FirstEdgeSet; edge < CCube::LastEdgeSet; edge++) {
+		flip = flip * 2 + GetEdgeOrientation(edge);
+	}
+	return flip;
+}
+
+// Middle層のEdgeがある位置のbitから求める(COrdinalCube::GetChoiceFromEdgePermutationと同じ)
+inline int CPackedCube::GetChoice() const
+{
+	int choiceMask = 0;
+	for (int edge = CCube::FirstEdgeSet; edge <= CCube::LastEdgeSet; edge++) {
+		choiceMask |= (GetEdge(edge) >= CCube::FirstMiddleEdgeSet) << edge;
+	}
+	return COrdinalTables::Choices.maskToOrdinal[choiceMask];
+}
+
+#endif	// _PACKEDCUBE_H_
@@ -0,0 +1,137 @@
+﻿#ifndef	_PAIRPRUNINGTABLE_H_
+#define	_PAIRPRUNINGTABLE_H_
+
+#include "pruningtable.h"
+
+// 2種類のMoveTableを組み合わせたPruningTable
+// ある状態遷移を行った時の2種類のMoveTableの序数をIndexとして初期状態からのコスト(Depth)を格納する
+// Index = 序数1 * TMoveTable2::Size + 序数2
+// MoveTableの型をテンプレート引数にするので，Tableのサイズはコンパイル時に決まり，
+// Indexの計算とMoveTableの参照はインライン展開される
+template <class TMoveTable1, class TMoveTable2>
+class CPairPruningTable : public CPruningTable
+{
+public:
+	// 組み合わせる2つのMoveTableへのReferenceとCleanCubeにおける各序数を格納する
+	CPairPruningTable(
+		TMoveTable1& moveTable1, TMoveTable2& moveTable2,
+		const int p_homeOrdinal1, const int p_homeOrdinal2,
+		const Encoding p_encoding = FourBitDepth
+		) :
+		CPruningTable(TMoveTable1::Size * TMoveTable2::Size, p_encoding),
+		m_moveTable1(moveTable1),
+		m_moveTable2(moveTable2),
+		m_homeOrdinal1(p_homeOrdinal1),
+		m_homeOrdinal2(p_homeOrdinal2)
+	{
+	}
+
+	// MoveTableの序数からPruningTableのIndexを取得
+	static inline int GetIndex(const int p_ordinal1, const int p_ordinal2)
+	{
+		// 序数を組み合わせる
+		return p_ordinal1 * TMoveTable2::Size + p_ordinal2;
+	}
+
+protected:
+	// 幅優先探索のためのPruningTableを作成
+	// 各depthの全探索を複数のスレッドで分担する
+	void GeneratePruningTable()
+	{
+		unsigned int depth = 0;
+		int numberOfNodes;
+		int numberOfNodesAtDepth;
+
+		Clear();	// Empty = 0x0F
+
+		// 探索木のスタート地点を設定する
+		SetValue(GetIndex(m_homeOrdinal1, m_homeOrdinal2), depth);
+		numberOfNodes = numberOfNodesAtDepth = 1;	// ノードの数
+
+		// テーブルサイズいっぱいまで繰り返す
+		while (numberOfNodes < GetSize()) {
+			// 空のIndexの方が少なくなったら，空のIndexから逆向きに探索する
+			const bool isBackward = IsBackwardSearchEfficient(numberOfNodesAtDepth, numberOfNodes);
+			numberOfNodesAtDepth = ParallelFor(GetSize(), ChunkSize, [&](const int p_begin, const int p_end) {
+				return isBackward ? ExpandIndicesBackward(p_begin, p_end, depth) : ExpandIndices(p_begin, p_end, depth);
+			});
+			numberOfNodes += numberOfNodesAtDepth;
+			// 探索が終了したらdepthを深くする
+			depth++;
+			NotifyDepthCompleted(depth, numberOfNodes);
+		}
+	}
+
+private:
+	// 1つのスレッドが一度に探索するIndexの数
+	enum { ChunkSize = 1 << 14 };
+
+	// Phase 2のMoveTableを含むときは，Phase 2の移動のみ
+	enum { IsPhase2Table = TMoveTable1::IsPhase2Table || TMoveTable2::IsPhase2Table };
+
+	// [p_begin, p_end)のうち，depthがp_depthのIndexから枝を伸ばす
+	// 新たに格納したIndexの数をreturnする
+	int ExpandIndices(const int p_begin, const int p_end, const unsigned int p_depth)
+	{
+		int numberOfNodes = 0;
+
+		// 現在のdepthと一致したら，そこから枝を伸ばす
+		for (int index = FindValue(p_begin, p_end, p_depth); index < p_end; index = FindValue(index + 1, p_end, p_depth)) {
+			// PruningTableのIndexからMoveTableの序数を取得
+			int ordinal1 = index / TMoveTable2::Size;
+			int ordinal2 = index % TMoveTable2::Size;
+			for (int move = CCube::Move::U; move < CCube::Move::NumberOfMoves; move++) {
+				if (IsPhase2Table && !CCube::IsPhase2Move(move)) {
+					continue;
+				}
+				// MoveTableを用いて，ある移動に対する状態遷移後の序数を取得し，
+				// 2つの序数からPruningTableのインデックスを取得
+				int index2 = GetIndex(m_moveTable1[ordinal1][move], m_moveTable2[ordinal2][move]);
+
+				// 既にindex2の場所に状態が設定されていたら飛ばす
+				if (SetValueIfEmpty(index2, p_depth + 1)) {
+					numberOfNodes++;
+				}
+			}
+		}
+		return numberOfNodes;
+	}
+
+	// [p_begin, p_end)のうち，空のIndexから逆向きに枝を伸ばし，
+	// depthがp_depthのIndexに隣接していればp_depth + 1を格納する
+	// (逆の移動も移動の集合に含まれるので，移動後の状態から戻ることができる)
+	// 新たに格納したIndexの数をreturnする
+	int ExpandIndicesBackward(const int p_begin, const int p_end, const unsigned int p_depth)
+	{
+		int numberOfNodes = 0;
+
+		for (int index = FindValue(p_begin, p_end, Empty); index < p_end; index = FindValue(index + 1, p_end, Empty)) {
+			int ordinal1 = index / TMoveTable2::Size;
+			int ordinal2 = index % TMoveTable2::Size;
+			for (int move = CCube::Move::U; move < CCube::Move::NumberOfMoves; move++) {
+				if (IsPhase2Table && !CCube::IsPhase2Move(move)) {
+					continue;
+				}
+				int index2 = GetIndex(m_moveTable1[ordinal1][move], m_moveTable2[ordinal2][move]);
+
+				// 1つでも見つかれば残りの移動は調べない
+				if (GetValueAtomic(index2) == p_depth) {
+					if (SetValueIfEmpty(index, p_depth + 1)) {
+						numberOfNodes++;
+					}
+					break;
+				}
+			}
+		}
+		return numberOfNodes;
+	}
+
+	// MoveTableへのReference
+	TMoveTable1& m_moveTable1;
+	TMoveTable2& m_moveTable2;
+	// PruningTable作成の初期位置
+	int m_homeOrdinal1;
+	int m_homeOrdinal2;
+};
+
+#endif	// _PAIRPRUNINGTABLE_H_
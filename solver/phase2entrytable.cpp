@@ -0,0 +1,115 @@
+﻿#include "phase2entrytable.h"
+
+CPhase2EntryTable::CPhase2EntryTable()
+{
+}
+
+CPhase2EntryTable::~CPhase2EntryTable()
+{
+}
+
+// Tableを作成する
+void CPhase2EntryTable::Initialize()
+{
+	COrdinalCube cube;
+
+	// Up層・Down層の位置にある3個のEdgeの位置に番号を付ける
+	// (位置の序数はEdgeの番号によらないので，2つの組で共通のTableを使う)
+	std::vector<int> splitPositions;	// 番号 -> 3個のEdgeの位置
+	m_splitIndices.assign(COrdinalCube::UpDownEdgeSplitPositions, -1);
+	for (int ordinal = 0; ordinal < COrdinalCube::UpDownEdgeSplitPositions; ordinal++) {
+		cube.SetEdgeSubsetPositionsFromOrdinal(ordinal, CCube::UF, COrdinalCube::UpDownEdgeSplitSize);
+		int positions[COrdinalCube::UpDownEdgeSplitSize];
+		bool isUpDown = true;
+		for (int position = CCube::FirstEdgeSet; position <= CCube::LastEdgeSet; position++) {
+			const int edge = cube.GetEdgePermutation()[position];
+			if (edge < CCube::UF + COrdinalCube::UpDownEdgeSplitSize) {
+				positions[edge - CCube::UF] = position;
+				isUpDown &= (position < CCube::FirstMiddleEdgeSet);
+			}
+		}
+		if (isUpDown) {
+			m_splitIndices[ordinal] = (int16_t)(splitPositions.size() / COrdinalCube::UpDownEdgeSplitSize);
+			splitPositions.insert(splitPositions.end(), positions, positions + COrdinalCube::UpDownEdgeSplitSize);
+		}
+	}
+
+	// 2つの組の位置から，Up層・Down層のEdgeの順列を作成する
+	// 残りの2つの位置には，偶奇に応じてDB,DRを順番通りまたは逆に置く
+	m_upDownEdgePermutations.assign(2 * UpDownSplitPositions * UpDownSplitPositions, 0);
+	for (int split1 = 0; split1 < UpDownSplitPositions; split1++) {
+		for (int split2 = 0; split2 < UpDownSplitPositions; split2++) {
+			int permutation[CCube::FirstMiddleEdgeSet];
+			for (int position = 0; position < CCube::FirstMiddleEdgeSet; position++) {
+				permutation[position] = CCube::InvalidSet;
+			}
+			for (int i = 0; i < COrdinalCube::UpDownEdgeSplitSize; i++) {
+				permutation[splitPositions[split1 * COrdinalCube::UpDownEdgeSplitSize + i]] = CCube::UF + i;
+			}
+			bool isOverlapped = false;
+			for (int i = 0; i < COrdinalCube::UpDownEdgeSplitSize; i++) {
+				int& position = permutation[splitPositions[split2 * COrdinalCube::UpDownEdgeSplitSize + i]];
+				isOverlapped |= (position != CCube::InvalidSet);
+				position = CCube::UR + i;
+			}
+			if (isOverlapped) {
+				continue;
+			}
+
+			int remainingEdge = CCube::DB;
+			int lastPositions[2];
+			for (int position = 0; position < CCube::FirstMiddleEdgeSet; position++) {
+				if (permutation[position] == CCube::InvalidSet) {
+					lastPositions[remainingEdge - CCube::DB] = position;
+					permutation[position] = remainingEdge++;
+				}
+			}
+
+			for (int i = 0; i < 2; i++) {
+				const int ordinal = PermutationToOrdinal(permutation, CCube::FirstMiddleEdgeSet);
+				const int parity = GetPermutationParity(ordinal, CCube::FirstMiddleEdgeSet);
+				m_upDownEdgePermutations[(parity * UpDownSplitPositions + split1) * UpDownSplitPositions + split2] = (uint16_t)ordinal;
+
+				// DB,DRを入れ替えると偶奇が逆になる
+				permutation[lastPositions[0]] = CCube::DR;
+				permutation[lastPositions[1]] = CCube::DB;
+			}
+		}
+	}
+
+	// Middle層の4個のEdgeがMiddle層の位置にあるときの順列
+	m_middleEdgePermutations.assign(COrdinalCube::MiddleEdgePositions, -1);
+	for (int ordinal = 0; ordinal < COrdinalCube::MiddleEdgePositions; ordinal++) {
+		cube.SetEdgeSubsetPositionsFromOrdinal(ordinal, CCube::FirstMiddleEdgeSet, 4);
+		bool isMiddle = true;
+		for (int position = CCube::FirstMiddleEdgeSet; position <= CCube::LastMiddleEdgeSet; position++) {
+			isMiddle &= (cube.GetEdgePermutation()[position] >= CCube::FirstMiddleEdgeSet);
+		}
+		if (isMiddle) {
+			m_middleEdgePermutations[ordinal] = (int8_t)cube.GetOrdinalFromMiddleEdgePermutation();
+		}
+	}
+
+	// 順列の偶奇
+	m_cornerParities.resize(COrdinalCube::CornerPermutations);
+	for (int ordinal = 0; ordinal < COrdinalCube::CornerPermutations; ordinal++) {
+		m_cornerParities[ordinal] = (uint8_t)GetPermutationParity(ordinal, CCube::NumberOfCornerSets);
+	}
+	m_middleEdgeParities.resize(COrdinalCube::MiddleEdgePermutations);
+	for (int ordinal = 0; ordinal < COrdinalCube::MiddleEdgePermutations; ordinal++) {
+		m_middleEdgeParities[ordinal] = (uint8_t)GetPermutationParity(ordinal, 4);
+	}
+}
+
+// 順列の序数から，順列の偶奇を求める
+// OrdinalToPermutationはi = 1 ~ n - 1の位置の要素を，序数のi桁目の位置の要素と交換して順列を作るので，
+// 桁の値がiと異なる(実際に交換する)回数の偶奇が順列の偶奇になる
+int CPhase2EntryTable::GetPermutationParity(int p_ordinal, const int p_n)
+{
+	int parity = 0;
+	for (int i = 1; i < p_n; i++) {
+		parity ^= (p_ordinal % (i + 1) != i);
+		p_ordinal /= (i + 1);
+	}
+	return parity;
+}
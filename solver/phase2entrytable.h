@@ -0,0 +1,64 @@
+﻿#ifndef	_PHASE2ENTRYTABLE_H_
+#define	_PHASE2ENTRYTABLE_H_
+
+#include <vector>
+#include <cstdint>
+
+#include "ordinalcube.h"
+
+// Phase 1の探索中にMoveTableで追跡した座標から，Phase 1の完成状態におけるPhase 2の序数を求めるTable
+// - Up層・Down層のEdgeの順列 : 2組の3個のEdgeの位置と順列の偶奇を結合Tableで組み合わせる
+// - Middle層のEdgeの順列 : Middle層の4個のEdgeの位置から求める
+// - Cornerの順列 : 全ての移動で定義されるので，CCornerPermutationMoveTableでそのまま追跡する
+// Phase 1の完成状態ではMiddle層のEdgeはMiddle層の位置にあるので，
+// Up層・Down層の3個のEdgeの位置はUp層・Down層の8個の位置の中の8 * 7 * 6通りになる
+// 起動時に作成し(ファイルには保存しない)，作成後は書き換えないので複数のスレッドから同時に参照してよい
+class CPhase2EntryTable
+{
+public:
+	CPhase2EntryTable();
+	~CPhase2EntryTable();
+
+	// Tableを作成する
+	void Initialize();
+
+	// Phase 1の完成状態のUp層・Down層のEdgeの順列の序数を求める
+	// p_split1, p_split2 : UF,UL,UBの組とUR,DF,DLの組の位置の序数(CUpDownEdgeSplitMoveTable)
+	// 残りのDB,DRの順番は，Edge全体の順列の偶奇がCornerの順列の偶奇と一致するように決める
+	int GetUpDownEdgePermutation(const int p_split1, const int p_split2, const int p_cornerPermutation, const int p_middleEdgePermutation) const
+	{
+		const int parity = m_cornerParities[p_cornerPermutation] ^ m_middleEdgeParities[p_middleEdgePermutation];
+		return m_upDownEdgePermutations[(parity * UpDownSplitPositions + m_splitIndices[p_split1]) * UpDownSplitPositions + m_splitIndices[p_split2]];
+	}
+
+	// Phase 1の完成状態のMiddle層のEdgeの順列の序数を求める
+	// p_middleEdgePositions : Middle層の4個のEdgeの位置の序数(CMiddleEdgePositionsMoveTable)
+	int GetMiddleEdgePermutation(const int p_middleEdgePositions) const
+	{
+		return m_middleEdgePermutations[p_middleEdgePositions];
+	}
+
+	// 順列の序数(PermutationToOrdinal)から，順列の偶奇(偶置換:0，奇置換:1)を求める
+	static int GetPermutationParity(int p_ordinal, const int p_n);
+
+private:
+	enum
+	{
+		UpDownSplitPositions = 8 * 7 * 6	// Up層・Down層の位置にある3個のEdgeの位置の数
+	};
+
+	// 3個のEdgeの位置の序数 -> Up層・Down層の位置の中での番号
+	// (2つの組で共通，Middle層の位置を含むときは-1)
+	std::vector<int16_t> m_splitIndices;
+	// 結合Table [偶奇][組1の番号][組2の番号] -> Up層・Down層のEdgeの順列の序数
+	// (2つの組の位置が重なるときは0)
+	std::vector<uint16_t> m_upDownEdgePermutations;
+	// Middle層の4個のEdgeの位置の序数 -> Middle層のEdgeの順列の序数
+	// (Up層・Down層の位置を含むときは-1)
+	std::vector<int8_t> m_middleEdgePermutations;
+	// 順列の序数 -> 偶奇
+	std::vector<uint8_t> m_cornerParities;
+	std::vector<uint8_t> m_middleEdgeParities;
+};
+
+#endif	// _PHASE2ENTRYTABLE_H_
@@ -1,164 +1,112 @@
 ﻿#include "pruningtable.h"
-#include "movetable.h"
 #include "./solverthread.h"
 
 #include <iomanip>
+#include <cstring>
 
-// 組み合わせる2つのMoveTableへのReferenceとCleanCubeにおける各序数を格納する
-CPruningTable::CPruningTable(CMoveTable& moveTable1, CMoveTable& moveTable2, const int p_homeOrdinal1, const int p_homeOrdinal2) :
-	m_moveTableRef1(moveTable1),
-	m_moveTableRef2(moveTable2),
-	m_homeOrdinal1(p_homeOrdinal1),
-	m_homeOrdinal2(p_homeOrdinal2)
+// PruningTableのサイズと格納形式を設定する
+// テーブルのために確保するメモリのサイズを決定する(単位:byte)
+// (intに丸める処理を行う:Table1要素あたり2[byte])
+// TableSize:1 - 8 のとき AllocationSize = 4
+// TableSize:9 - 16 のとき AllocationSize = 8
+// TableSize:17 - 24 のとき AllocationSize = 12
+// ...
+// TwoBitModulo3のファイルは1要素あたり2bitで，64bit単位に丸める
+CPruningTable::CPruningTable(const int p_tableSize, const Encoding p_encoding) :
+	m_tableSize(p_tableSize),
+	m_encoding(p_encoding),
+	m_numberOfThreads(std::max(1, (int)std::thread::hardware_concurrency())),
+	m_allocationSize(((p_tableSize + 7) / 8) * 4),
+	m_table(NULL),	// テーブルはInitializeで確保(またはマップ)する
+	m_tableFile(p_tableSize, 1, (p_encoding == FourBitDepth) ? 4 : 2,
+		(p_encoding == FourBitDepth) ? ((p_tableSize + 7) / 8) * 4 : ((p_tableSize + 31) / 32) * 8)
 {
-	// テーブルのサイズを格納
-	m_moveTable1Size = m_moveTableRef1.GetSize();
-	m_moveTable2Size = m_moveTableRef2.GetSize();
-	m_tableSize = m_moveTable1Size * m_moveTable2Size;
-
-	// テーブルのために確保するメモリのサイズを決定する(単位:byte)
-	// (intに丸める処理を行う:Table1要素あたり2[byte])
-	// TableSize:1 - 8 のとき AllocationSize = 4
-	// TableSize:9 - 16 のとき AllocationSize = 8
-	// TableSize:17 - 24 のとき AllocationSize = 12
-	// ...
-	m_allocationSize = ((m_tableSize + 7) / 8) * 4;
-	// テーブルをAllocationSize[byte]確保する
-	m_table = new unsigned char[m_allocationSize];
 }
 
-void CPruningTable::Initialize(const std::string p_fileName)
+// ファイルをメモリマップしてPruningTableとして使用する
+bool CPruningTable::Initialize(const std::string p_fileName, const CTableBundle* p_bundle)
 {
-	std::ifstream input(p_fileName, std::ios::in| std::ios::binary);
-	if (!input){
-		// ファイルが無いときはファイルを作る
+	// バンドルがあれば，バンドルの中のTableだけを使う(作成し直さない)
+	if (p_bundle) {
+		if (m_tableFile.Open(*p_bundle, p_fileName) != CTableFile::Loaded) {
+            emit notifySolverMessage("Invalid table in bundle: " + QString::fromStdString(p_fileName));
+			return false;
+		}
+		m_table = m_tableFile.GetData();
+		return true;
+	}
+
+	CTableFile::Status status = m_tableFile.Open(p_fileName);
+	if (status != CTableFile::Loaded) {
+		// 古い形式のファイルや壊れたファイルは作成し直す
+		if (status == CTableFile::Invalid) {
+            emit notifySolverMessage("Invalid table file: " + QString::fromStdString(p_fileName));
+		}
         //std::cout << "Generating..." << std::endl;
         emit notifySolverMessage("Generating...");
-		GeneratePruningTable();
+		if (m_encoding == FourBitDepth) {
+			m_table = m_tableFile.Allocate();
+			GeneratePruningTable();
+		}
+		else {
+			// 4bitのDepthで作成してから，余りの2bitに詰め直す
+			std::vector<uint64_t> table((m_allocationSize + 7) / 8);
+			m_table = (unsigned char*)table.data();
+			GeneratePruningTable();
+			PackModulo3(m_table, m_tableFile.Allocate());
+		}
         //std::cout << "Saving..." << std::endl;
         emit notifySolverMessage("Saving...");
-		std::ofstream output(p_fileName, std::ios::out | std::ios::binary);
-		output.write((const char*)m_table, m_allocationSize);
+		// 作成したヒープのTableはそのまま使う(次回の起動からマップする)
+		if (!m_tableFile.Save(p_fileName)) {
+            emit notifySolverMessage("Failed to save " + QString::fromStdString(p_fileName));
+		}
         //std::cout << "Done" << std::endl;
         emit notifySolverMessage("Done");
 	}
-	else{
-		// ファイルが存在したら読み込む
-        //std::cout << "Loading..." << std::endl;
-        //emit notifySolverMessage("Loading...");
-		input.read((char*)m_table, m_allocationSize);
-        //std::cout << "Done" << std::endl;
-        //emit notifySolverMessage("Done");
-	}
+	m_table = m_tableFile.GetData();
+	return true;
 }
 
 CPruningTable::~CPruningTable()
 {
-	delete [] m_table;
-}
-
-// 幅優先探索のためのPruningTableを作成
-void CPruningTable::GeneratePruningTable()
-{
-	unsigned int depth = 0;
-	int numberOfNodes;
-
-	for (int index = 0; index < m_tableSize; index++) {
-		SetValue(index, Empty);	// Empty = 0x0F
-	}
-
-	// 探索木のスタート地点を設定する
-	SetValue(MoveTableIndicesToPruningTableIndex(m_homeOrdinal1, m_homeOrdinal2), depth);
-	numberOfNodes = 1;	// ノードの数
-
-	// テーブルサイズいっぱいまで繰り返す
-	while (numberOfNodes < m_tableSize) {
-		// PruningTableを全探索する -> 現在のdepthと一致するものを参照する
-		for (int index = 0; index < m_tableSize; index++) {
-			// 現在のdepthと一致したら，そこから枝を伸ばす
-			if (GetValue(index) == depth) {
-				// MoveTableを用いて，ある移動に対する状態遷移を取得する
-				int ordinal1, ordinal2;
-				for (int move = CCube::Move::U; move <= CCube::Move::B; move++) {
-					// 最初の状態の序数を取得
-					PruningTableIndexToMoveTableIndices(index, ordinal1, ordinal2);
-					// 同じ移動を90[deg]回転x3行う
-					for (int power = 1; power < 4; power++) {
-						// MoveTableを用いて，ある移動に対する状態遷移後の序数を取得する
-						ordinal1 = m_moveTableRef1[ordinal1][move];
-						ordinal2 = m_moveTableRef2[ordinal2][move];
-						// 2つの序数からPruningTableのインデックスを取得
-						int index2 = MoveTableIndicesToPruningTableIndex(ordinal1, ordinal2);
-
-						// 既にindex2の場所に状態が設定されていたら飛ばす
-						if (GetValue(index2) == Empty) {
-							SetValue(index2, depth + 1);
-							numberOfNodes++;
-						}
-					}
-				}
-			}
-		}
-		// 探索が終了したらdepthを深くする
-		depth++;
-        //std::cout << "Completed Depth = " << depth << std::endl;
-        emit notifySolverMessage("Completed Depth = " + QString::number(depth));
-	}
-}
-
-// PruningTableのIndexからMoveTableの序数を取得
-void CPruningTable::PruningTableIndexToMoveTableIndices(const int p_index, int& ordinal1, int& ordinal2) const
-{
-	ordinal1 = p_index / m_moveTable2Size;
-	ordinal2 = p_index % m_moveTable2Size;
+	// m_tableはm_tableFileが解放する
 }
 
-// MoveTableの序数からPruningTableのIndexを取得
-int CPruningTable::MoveTableIndicesToPruningTableIndex(const int p_ordinal1, const int p_ordinal2) const
+// 全てのIndexを空にする
+void CPruningTable::Clear()
 {
-	// 序数を組み合わせる
-	return p_ordinal1 * m_moveTable2Size + p_ordinal2;
+	// 全ての4bitをEmpty(0x0F)にする
+	std::memset(m_table, 0xFF, m_allocationSize);
 }
 
-// PruningTableのDepthを取得
-unsigned int CPruningTable::GetValue(const int p_index) const
+// 4bitのDepthのTableを，Depthを3で割った余りの2bitのTableに詰め直す
+// MaxDepth以上のDepthと空のIndex(作成後はTableの端数のみ)はModulo3MaxDepthにする
+void CPruningTable::PackModulo3(const unsigned char* p_source, unsigned char* p_destination) const
 {
-	// indexが奇数:Table[i]の前半4ビットにdepthを格納
-	// indexが偶数:Table[i]の後半4ビットにdepthを格納
-	if (p_index % 2) {
-		// 奇数
-		return (m_table[p_index / 2] & 0xF0) >> 4;
-	}
-	else {
-		// 偶数
-		return (m_table[p_index / 2] & 0x0F) >> 0;
+	std::memset(p_destination, 0xFF, m_tableFile.GetDataBytes());
+	for (int index = 0; index < m_tableSize; index++) {
+		unsigned int value = (p_source[index >> 1] >> ((index & 1) << 2)) & 0x0F;
+		unsigned int residue = (value >= MaxDepth) ? (unsigned int)Modulo3MaxDepth : value % 3;
+		int shift = (index & 3) << 1;
+		p_destination[index >> 2] = (unsigned char)((p_destination[index >> 2] & ~(0x03 << shift)) | (residue << shift));
 	}
 }
 
-// PruningTableにDepthを格納
-void CPruningTable::SetValue(int p_index, unsigned int p_value) const
+// 1つのdepthの探索が終了したことを通知する
+// 格納済みのIndexの数と割合を進捗として出力する
+void CPruningTable::NotifyDepthCompleted(const unsigned int p_depth, const int p_numberOfNodes)
 {
-	int i = p_index / 2;
-	// indexが奇数:Table[i]の前半を0でマスクする(Table[i] & ~(0xF0))
-	//            :Table[i]の前半4ビットにdepthを格納
-	//            :valueを4ビット右シフトする
-	// indexが偶数:Table[i]の後半を0でマスクする(Table[i] & ~(0x0F))
-	//            :Table[i]の後半4ビットにdepthを格納
-	//            :valueをシフトしない
-	if (p_index % 2) {
-		// 奇数
-		m_table[i] = (m_table[i] & 0x0F) | (p_value << 4);
-	}
-	else {
-		// 偶数
-		m_table[i] = (m_table[i] & 0xF0) | (p_value << 0);
-	}
+    emit notifySolverMessage("Completed Depth = " + QString::number(p_depth)
+        + " (" + QString::number(p_numberOfNodes) + " / " + QString::number(m_tableSize)
+        + ", " + QString::number((int)(100.0 * p_numberOfNodes / m_tableSize)) + "%)");
 }
 
 // PruningTableを標準出力で表示
 void CPruningTable::PrintPruningTable() const
 {
 	for (int index = 0; index < m_tableSize; index++){
-		std::cout << std::setw(7) << index << ": " << std::setw(2) << GetValue(index) << std::endl;
+		std::cout << std::setw(7) << index << ": " << std::setw(2)
+			<< ((m_encoding == FourBitDepth) ? GetValue(index) : GetValueModulo3(index)) << std::endl;
 	}
 }
@@ -2,14 +2,21 @@
 #define	_PRUNINGTABLE_H_
 
 #include "movetable.h"
+#include "tablefile.h"
 
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <cstdint>
 #include <QObject>
 
-// パターンデータベースのクラス
-// ある状態遷移を行った時の2種類のMoveTableの序数をIndexとして初期状態からのコスト(Depth)を格納する
+// パターンデータベースの基底クラス
+// 状態を表すIndexに対して初期状態からのコスト(Depth)を4bitずつ格納する
+// Indexの決め方とTableの作成は継承したクラスで実装する
 class CPruningTable : public QObject
 {
     Q_OBJECT
@@ -17,58 +24,284 @@ signals:
     void notifySolverMessage(QString p_message);
 
 public:
-	// 組み合わせる2つのMoveTableとcleanCubeにおける各序数を格納する
-	CPruningTable(
-		CMoveTable& moveTable1, CMoveTable& moveTable2,
-		const int p_homeOrdinal1, const int p_homeOrdinal2
-		);
+	// Tableの格納形式
+	enum Encoding
+	{
+		FourBitDepth,	// Depthを4bitで格納する(1 byteに2つ)
+		TwoBitModulo3	// Depthを3で割った余りを2bitで格納する(1 byteに4つ，メモリは半分)
+	};
 
-	~CPruningTable();
+	virtual ~CPruningTable();
 
-	// 幅優先探索のためのPruningTableを作成
-	void Initialize(const std::string p_fileName);
+	// ファイルをメモリマップしてPruningTableとして使用する
+	// 数百MBのTableをヒープに読み込まずに，OSのページキャッシュで共有する(読み出し専用)
+	// ファイルが無いとき，ヘッダかチェックサムが一致しないときは幅優先探索で作成して保存する
+	// p_bundleを指定したときはバンドルの中のTableを使い，見つからなければfalseを返す
+	bool Initialize(const std::string p_fileName, const CTableBundle* p_bundle = NULL);
 
-	// PruningTableのIndexからMoveTableの序数を取得
-	void PruningTableIndexToMoveTableIndices(const int p_index, int& ordinal1, int& ordinal2) const;
+	// PruningTableのDepthを取得(FourBitDepthのみ)
+	// 探索のheuristic関数から呼び出すので，インライン展開できるようにヘッダで定義する
+	inline unsigned int GetValue(const int p_index) const
+	{
+		// indexが奇数:Table[i]の前半4ビットにdepthを格納
+		// indexが偶数:Table[i]の後半4ビットにdepthを格納
+		return (m_table[p_index >> 1] >> ((p_index & 1) << 2)) & 0x0F;
+	}
 
-	// MoveTableの序数からPruningTableのIndexを取得
-	int MoveTableIndicesToPruningTableIndex(const int p_ordinal1, const int p_ordinal2) const;
+	// PruningTableのDepthを3で割った余りを取得(TwoBitModulo3のみ)
+	// MaxDepth以上のDepthはModulo3MaxDepthを返す
+	inline unsigned int GetValueModulo3(const int p_index) const
+	{
+		// Table[i]の下位bitから順に4つのIndexの余りを2bitずつ格納
+		return (m_table[p_index >> 2] >> ((p_index & 3) << 1)) & 0x03;
+	}
 
-	// PruningTableのDepthを取得
-	unsigned int GetValue(const int p_index) const;
+	// 隣接する状態の正確なDepth(p_neighborDepth)から，p_indexの正確なDepthを取得
+	// FourBitDepthでは格納したDepthをそのまま返す
+	// TwoBitModulo3では，1手で移る状態のDepthの差は-1,0,+1のいずれかなので，余りの差から復元する
+	// 探索では親ノードのDepthを渡して，子ノードのDepthを順に求める
+	inline unsigned int GetDepth(const int p_index, const unsigned int p_neighborDepth) const
+	{
+		if (m_encoding == FourBitDepth) {
+			return GetValue(p_index);
+		}
+		unsigned int residue = GetValueModulo3(p_index);
+		if (residue == Modulo3MaxDepth) {
+			return MaxDepth;
+		}
+		// (余り - 親の余り + 1) mod 3 = Depthの差 + 1
+		// (親がMaxDepthのときも，MaxDepthより小さい子は正確にMaxDepth - 1になる)
+		return p_neighborDepth + (residue + 4 - p_neighborDepth % 3) % 3 - 1;
+	}
+
+	// 探索の根の状態p_stateの正確なDepthを取得(探索中はGetDepthで親ノードから求める)
+	// TwoBitModulo3では，Depthが1つ小さい(余りが1つ小さい)隣接状態を完成状態まで辿って手数を数える
+	// (完成状態以外には必ずDepthが1つ小さい隣接状態がある)
+	// p_getIndex(state) : 状態のIndex, p_applyMove(state, move) : 状態にmoveを行った状態
+	// p_isPhase2 : Phase 2の移動のみで作成したTableか
+	template <class TState, class TGetIndex, class TApplyMove>
+	unsigned int GetRootDepth(TState p_state, const bool p_isPhase2, TGetIndex p_getIndex, TApplyMove p_applyMove) const
+	{
+		if (m_encoding == FourBitDepth) {
+			return GetValue(p_getIndex(p_state));
+		}
+		unsigned int depth = 0;
+		unsigned int residue = GetValueModulo3(p_getIndex(p_state));
+		if (residue == Modulo3MaxDepth) {
+			return MaxDepth;
+		}
+		while (true) {
+			const unsigned int lowerResidue = (residue + 2) % 3;
+			int move = CCube::Move::U;
+			for (; move < CCube::Move::NumberOfMoves; move++) {
+				if (p_isPhase2 && !CCube::IsPhase2Move(move)) {
+					continue;
+				}
+				TState nextState = p_applyMove(p_state, move);
+				if (GetValueModulo3(p_getIndex(nextState)) == lowerResidue) {
+					p_state = nextState;
+					break;
+				}
+			}
+			// Depthが1つ小さい隣接状態が無ければ完成状態
+			if (move == CCube::Move::NumberOfMoves) {
+				return depth;
+			}
+			residue = lowerResidue;
+			depth++;
+		}
+	}
 
 	// PruningTableにDepthを格納
-	void SetValue(int p_index, unsigned int p_value) const;
+	inline void SetValue(int p_index, unsigned int p_value) const
+	{
+		int i = p_index / 2;
+		// indexが奇数:Table[i]の前半を0でマスクする(Table[i] & ~(0xF0))
+		//            :Table[i]の前半4ビットにdepthを格納
+		// indexが偶数:Table[i]の後半を0でマスクする(Table[i] & ~(0x0F))
+		//            :Table[i]の後半4ビットにdepthを格納
+		if (p_index % 2) {
+			// 奇数
+			m_table[i] = (m_table[i] & 0x0F) | (p_value << 4);
+		}
+		else {
+			// 偶数
+			m_table[i] = (m_table[i] & 0xF0) | (p_value << 0);
+		}
+	}
+
+	// TwoBitModulo3でMaxDepth以上のDepth(およびTableの端数)を表す値
+	enum { Modulo3MaxDepth = 3 };
 
 	// PruningTableのサイズを取得
 	int GetSize() const { return m_tableSize; }
+	// PruningTableの格納形式を取得
+	Encoding GetEncoding() const { return m_encoding; }
+
+	// PruningTableの作成に用いるスレッド数を設定する(1以下なら1スレッドで作成する)
+	void SetNumberOfThreads(const int p_numberOfThreads)
+	{
+		m_numberOfThreads = (p_numberOfThreads > 1) ? p_numberOfThreads : 1;
+	}
 
 	// PruningTableを標準出力で表示
 	void PrintPruningTable() const;
 
-private:
-	// PruningTableのindex位置が空の時のdepth
-	enum { Empty = 0x0F };
+protected:
+	// PruningTableのサイズと格納形式を設定する
+	// 継承したクラスでGeneratePruningTableを実装する
+	CPruningTable(const int p_tableSize, const Encoding p_encoding = FourBitDepth);
+
+	// PruningTableのindex位置が空の時のdepth(Empty)と，格納するdepthの最大値(MaxDepth)
+	// Emptyと区別するため，MaxDepth以上のdepthはMaxDepthとして格納する(コストの下限として使える)
+	enum { Empty = 0x0F, MaxDepth = Empty - 1 };
 
 	// PruningTableを作成する
-	void GeneratePruningTable();
-
-	// MoveTableへのReference
-	CMoveTable& m_moveTableRef1;
-	CMoveTable& m_moveTableRef2;
-	// PruningTable作成の初期位置
-	int m_homeOrdinal1;
-	int m_homeOrdinal2;
-	// 各MoveTableのサイズ
-	int m_moveTable1Size;
-	int m_moveTable2Size;
+	// 格納形式によらず4bitのDepthで作成する(TwoBitModulo3は作成後に詰め直す)
+	virtual void GeneratePruningTable() = 0;
+
+	// 並列に作成するための関数
+	// 1 byteに2つのIndexのdepthを格納しているので，別のスレッドが同じbyteの
+	// もう一方のdepthを書き換えていても壊さないように，byte単位のatomic操作で読み書きする
+
+	// 全てのIndexを空にする
+	void Clear();
+
+	// 作成中のPruningTableのDepthを取得
+	inline unsigned int GetValueAtomic(const int p_index) const
+	{
+		return (AtomicByte(p_index).load(std::memory_order_relaxed) >> ((p_index & 1) << 2)) & 0x0F;
+	}
+
+	// 作成中のPruningTableのIndexが空ならDepthを格納する
+	// 格納したらtrueを返す(既に別のスレッドが格納していたらfalse)
+	inline bool SetValueIfEmpty(const int p_index, const unsigned int p_value) const
+	{
+		std::atomic<unsigned char>& byte = AtomicByte(p_index);
+		int shift = (p_index & 1) << 2;
+		unsigned char expected = byte.load(std::memory_order_relaxed);
+		do {
+			if (((expected >> shift) & 0x0F) != Empty) {
+				return false;
+			}
+		} while (!byte.compare_exchange_weak(expected,
+			(unsigned char)((expected & ~(0x0F << shift)) | (p_value << shift)), std::memory_order_relaxed));
+		return true;
+	}
+
+	// [p_index, p_end)のうち，Depthがp_valueである最初のIndexを取得(無ければp_endを返す)
+	// 64bitのwordに16個のIndexを格納しているので，wordごとにまとめて比較して，
+	// 一致するDepthが1つも無いwordは読み飛ばす
+	inline int FindValue(int p_index, const int p_end, const unsigned int p_value) const
+	{
+		// wordの境界までは1つずつ調べる
+		for (; p_index < p_end && (p_index & (IndicesPerWord - 1)); p_index++) {
+			if (GetValueAtomic(p_index) == p_value) {
+				return p_index;
+			}
+		}
+		// 全てのnibbleにp_valueを並べたwordと排他的論理和を取ると，一致したnibbleが0になる
+		// 0のnibbleは(x - 0x1111...) & ~x & 0x8888...で最上位bitが立つ
+		// (桁借りで誤って立つのは本当に0のnibbleより上位だけなので，最下位のものは正しい)
+		const uint64_t pattern = 0x1111111111111111ULL * p_value;
+		for (; p_index + IndicesPerWord <= p_end; p_index += IndicesPerWord) {
+			uint64_t word = AtomicWord(p_index).load(std::memory_order_relaxed) ^ pattern;
+			uint64_t zero = (word - 0x1111111111111111ULL) & ~word & 0x8888888888888888ULL;
+			if (zero) {
+				while (!(zero & 0x08)) {
+					zero >>= 4;
+					p_index++;
+				}
+				return p_index;
+			}
+		}
+		// 残りは1つずつ調べる
+		for (; p_index < p_end; p_index++) {
+			if (GetValueAtomic(p_index) == p_value) {
+				return p_index;
+			}
+		}
+		return p_end;
+	}
+
+	// 次のdepthを逆向きに探索した方が速いか判定する
+	// 前向き:depthのIndex(p_frontier個)から全ての移動を行う
+	// 逆向き:空のIndexから移動を行い，depthのIndexが見つかれば打ち切る
+	// 空のIndexの方が少なくなったら逆向きにする
+	bool IsBackwardSearchEfficient(const int p_frontier, const int p_numberOfNodes) const
+	{
+		return p_frontier > GetSize() - p_numberOfNodes;
+	}
+
+	// [0, p_count)をp_chunkSizeごとに分割して，m_numberOfThreads個のスレッドで
+	// p_function(begin, end)を並列に実行する
+	// p_functionは新たに格納したIndexの数を返し，その合計をreturnする
+	template <class TFunction>
+	int ParallelFor(const int p_count, const int p_chunkSize, TFunction p_function)
+	{
+		std::atomic<int> nextBegin(0);
+		std::atomic<int> numberOfNodes(0);
+		auto worker = [&]() {
+			int nodes = 0;
+			int begin;
+			// 空いたスレッドが次の範囲を取るので，範囲ごとの処理量に偏りがあっても均等になる
+			while ((begin = nextBegin.fetch_add(p_chunkSize)) < p_count) {
+				nodes += p_function(begin, std::min(begin + p_chunkSize, p_count));
+			}
+			numberOfNodes += nodes;
+		};
+
+		std::vector<std::thread> threads;
+		for (int i = 1; i < m_numberOfThreads; i++) {
+			threads.push_back(std::thread(worker));
+		}
+		worker();
+		for (size_t i = 0; i < threads.size(); i++) {
+			threads[i].join();
+		}
+		return numberOfNodes;
+	}
+
+	// 1つのdepthの探索が終了したことを通知する
+	void NotifyDepthCompleted(const unsigned int p_depth, const int p_numberOfNodes);
+
+private:
+	// 1 wordに格納するIndexの数
+	enum { IndicesPerWord = 16 };
+
+	// 4bitのDepthのTable(p_source)を，Depthを3で割った余りの2bitのTable(p_destination)に詰め直す
+	void PackModulo3(const unsigned char* p_source, unsigned char* p_destination) const;
+
+	// Indexを含む64bitのwordをatomic変数として参照する(p_indexはIndicesPerWordの倍数)
+	// Tableの先頭はnew[]またはmapで8byte境界に揃っている
+	// (偶数のIndexが下位4bitなので，wordのnibbleの順序はリトルエンディアンを前提とする)
+	inline std::atomic<uint64_t>& AtomicWord(const int p_index) const
+	{
+		static_assert(sizeof(std::atomic<uint64_t>) == 8, "std::atomic<uint64_t> must be 8 bytes");
+		return reinterpret_cast<std::atomic<uint64_t>&>(m_table[p_index >> 1]);
+	}
+
+	// Indexを含むbyteをatomic変数として参照する
+	inline std::atomic<unsigned char>& AtomicByte(const int p_index) const
+	{
+		static_assert(sizeof(std::atomic<unsigned char>) == 1, "std::atomic<unsigned char> must be 1 byte");
+		return reinterpret_cast<std::atomic<unsigned char>&>(m_table[p_index >> 1]);
+	}
 
 	// PruningTableのサイズ
 	int m_tableSize;
-	// メモリ上のPruningTableのサイズ(byte)
+	// PruningTableの格納形式
+	Encoding m_encoding;
+	// PruningTableの作成に用いるスレッド数
+	int m_numberOfThreads;
+	// 作成中の4bitのPruningTableのサイズ(byte)
 	int m_allocationSize;
 	// PrunignTable
+	// メモリマップしたファイルか，作成用にヒープに確保したメモリを指す
+	// (TwoBitModulo3の作成中は4bitのTableを指す)
 	unsigned char *m_table;
+	// PruningTableのファイル
+	CTableFile m_tableFile;
 };
 
 #endif	// _PRUNINGTABLE_H_
@@ -0,0 +1,281 @@
+﻿#include "solutioncache.h"
+#include "symmetry.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+
+const std::string CSolutionCache::DefaultFileName = "CubeSolverSolutions.cache";
+const int64_t CSolutionCache::CompletedSearch = INT64_MAX;
+
+// ファイルの1行目
+static const std::string FileHeader = "CubeSolverSolutionCache";
+
+CSolutionCache::CSolutionCache(const size_t p_capacity)
+	: m_capacity(p_capacity > 0 ? p_capacity : 1),
+	m_hits(0),
+	m_misses(0),
+	m_coalesced(0)
+{
+}
+
+CSolutionCache::~CSolutionCache()
+{
+}
+
+// 解法を保存するファイルを設定して，ファイルに保存されている解法を読み込む
+bool CSolutionCache::SetFileName(const std::string& p_fileName)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_fileName = p_fileName;
+	return !m_fileName.empty() && Load();
+}
+
+// Cubeの状態から，対称変換と逆元で移り合う状態の代表のキーを作成する
+// 48種類の対称変換 * (Cube, 逆元)の96通りの状態のうち，キーが最小になるものを代表とする
+CSolutionCache::SKey CSolutionCache::GetKey(const CCube& p_cube, const SearchType p_searchType, STransform& p_transform)
+{
+	CSymmetry::Initialize();
+
+	SKey minKey = { UINT64_MAX, UINT64_MAX };
+	for (int inverse = 0; inverse < 2; inverse++) {
+		CCube cube = p_cube;
+		if (inverse) {
+			cube.Invert();
+		}
+		for (int symmetry = 0; symmetry < CSymmetry::NumberOfSymmetries; symmetry++) {
+			CCube conjugated = cube;
+			CSymmetry::Conjugate(symmetry, conjugated);
+			SKey key = PackKey(conjugated, p_searchType);
+			if (key.corners < minKey.corners || (key.corners == minKey.corners && key.edges < minKey.edges)) {
+				minKey = key;
+				p_transform.symmetry = symmetry;
+				p_transform.isInverse = (inverse != 0);
+			}
+		}
+	}
+	return minKey;
+}
+
+// 解法を変換する
+// 代表 = S * X * S^-1 なので，Xの解法の各移動をSで対称変換すると代表の解法になる
+// Xが逆元のときは，逆順にして各移動を反対方向にするとCubeの解法になる
+// (解法の文字列は「長さ 移動 ... . 移動 ...」の形式で，長さと"."はそのまま残す
+//  逆順にすると"."の前後が入れ替わるので，"."は元の解法のPhaseの境界を表さなくなる
+//  CIDAstarSearchが逆元のCubeの解法を出力するときと同じ形式で，受け取る側は"."を区切りとしてのみ扱う)
+std::string CSolutionCache::TransformSolution(const std::string& p_solution, const STransform& p_transform, const bool p_isToRepresentative)
+{
+	std::istringstream input(p_solution);
+	std::string length;
+	input >> length;
+
+	// 移動記号を数値にする("."は-1)
+	std::vector<int> moves;
+	std::string name;
+	while (input >> name) {
+		int move = -1;
+		for (int i = CCube::U; i < CCube::NumberOfMoves; i++) {
+			if (name == CCube::GetNameOfMove(i)) {
+				move = i;
+			}
+		}
+		moves.push_back(move);
+	}
+
+	const int symmetry = p_isToRepresentative ? p_transform.symmetry : CSymmetry::GetInverseSymmetry(p_transform.symmetry);
+	for (size_t i = 0; i < moves.size(); i++) {
+		if (moves[i] >= 0) {
+			moves[i] = CSymmetry::ConjugateMove(symmetry, moves[i]);
+			if (p_transform.isInverse) {
+				moves[i] = CCube::GetInverseOfMove(moves[i]);
+			}
+		}
+	}
+	if (p_transform.isInverse) {
+		std::reverse(moves.begin(), moves.end());
+	}
+
+	std::string solution = length;
+	for (size_t i = 0; i < moves.size(); i++) {
+		solution += " " + ((moves[i] >= 0) ? CCube::GetNameOfMove(moves[i]) : std::string("."));
+	}
+	return solution;
+}
+
+// Cubeの状態をそのまま詰めたキーを作成する
+CSolutionCache::SKey CSolutionCache::PackKey(const CCube& p_cube, const SearchType p_searchType)
+{
+	SKey key = { 0, 0 };
+
+	const int* cornerPermutation = p_cube.GetCornerPermutation();
+	const int* cornerOrientations = p_cube.GetCornerOrientations();
+	for (int corner = CCube::FirstCornerSet; corner <= CCube::LastCornerSet; corner++) {
+		key.corners |= (uint64_t)cornerPermutation[corner] << (3 * corner);
+		key.corners |= (uint64_t)cornerOrientations[corner] << (3 * CCube::NumberOfCornerSets + 2 * corner);
+	}
+
+	const int* edgePermutation = p_cube.GetEdgePermutation();
+	const int* edgeOrientations = p_cube.GetEdgeOrientations();
+	for (int edge = CCube::FirstEdgeSet; edge <= CCube::LastEdgeSet; edge++) {
+		key.edges |= (uint64_t)edgePermutation[edge] << (4 * edge);
+		key.edges |= (uint64_t)edgeOrientations[edge] << (4 * CCube::NumberOfEdgeSets + edge);
+	}
+	key.edges |= (uint64_t)p_searchType << (5 * CCube::NumberOfEdgeSets);
+	return key;
+}
+
+// キャッシュから解法を取得し，無ければp_solveで解探索を行って保存する
+std::string CSolutionCache::Solve(const SKey& p_key, const STransform& p_transform, const int64_t p_timeOut, const std::function<std::string(bool& p_isCompleted)>& p_solve)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	// 同じキーの解探索が実行中なら，終了を待ってからもう一度探す
+	// (実行中の探索が解けなかった，またはタイムアウトが短かったときは，この呼び出しで解探索を行う)
+	bool isWaited = false;
+	std::string solution;
+	while (!Find(p_key, p_timeOut, solution)) {
+		if (m_inFlight.count(p_key) == 0) {
+			break;
+		}
+		isWaited = true;
+		m_completed.wait(lock);
+	}
+	if (!solution.empty()) {
+		m_hits++;
+		if (isWaited) {
+			m_coalesced++;
+		}
+		return TransformSolution(solution, p_transform, false);
+	}
+
+	// 解探索は時間がかかるので，lockを外して行う
+	m_misses++;
+	m_inFlight.insert(p_key);
+	lock.unlock();
+	bool isCompleted = false;
+	solution = p_solve(isCompleted);
+	lock.lock();
+	m_inFlight.erase(p_key);
+
+	if (!solution.empty()) {
+		SEntry entry;
+		entry.solution = TransformSolution(solution, p_transform, true);
+		entry.timeOut = isCompleted ? CompletedSearch : p_timeOut;
+		Insert(p_key, entry);
+		if (!m_fileName.empty()) {
+			Save();
+		}
+	}
+	// 待っているスレッドを起こす
+	m_completed.notify_all();
+	return solution;
+}
+
+// キャッシュから解法を取得できた回数
+uint64_t CSolutionCache::GetHits() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_hits;
+}
+
+// 解探索を行った回数
+uint64_t CSolutionCache::GetMisses() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_misses;
+}
+
+// 実行中の同じ解探索の終了を待って取得した回数
+uint64_t CSolutionCache::GetCoalesced() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_coalesced;
+}
+
+// 保存している解法の数
+size_t CSolutionCache::GetSize() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_entries.size();
+}
+
+// p_timeOut以上のタイムアウトで探索した解法を探して，見つかれば最近使った解法にする
+// より短いタイムアウトで打ち切った解法は，今回の要求ではより短い解法が見つかるかもしれないので使わない
+bool CSolutionCache::Find(const SKey& p_key, const int64_t p_timeOut, std::string& p_solution)
+{
+	auto it = m_index.find(p_key);
+	if (it == m_index.end() || it->second->second.timeOut < p_timeOut) {
+		return false;
+	}
+	m_entries.splice(m_entries.begin(), m_entries, it->second);
+	p_solution = it->second->second.solution;
+	return true;
+}
+
+// 解法を追加(同じキーがあれば置き換え)して，容量を超えたら最も古い解法を破棄する
+void CSolutionCache::Insert(const SKey& p_key, const SEntry& p_entry)
+{
+	auto it = m_index.find(p_key);
+	if (it != m_index.end()) {
+		it->second->second = p_entry;
+		m_entries.splice(m_entries.begin(), m_entries, it->second);
+		return;
+	}
+
+	m_entries.push_front(std::make_pair(p_key, p_entry));
+	m_index[p_key] = m_entries.begin();
+	while (m_entries.size() > m_capacity) {
+		m_index.erase(m_entries.back().first);
+		m_entries.pop_back();
+	}
+}
+
+// ファイルから解法を読み込む
+// 1行目は形式のバージョン，以降は1行に1つずつ「キー(16進数2つ) タイムアウト(10進数) 解法」の形式で古い順に並ぶ
+bool CSolutionCache::Load()
+{
+	std::ifstream input(m_fileName);
+	std::string header;
+	int version = 0;
+	if (!(input >> header >> version) || header != FileHeader || version != FormatVersion) {
+		return false;
+	}
+
+	std::string line;
+	std::getline(input, line);
+	while (std::getline(input, line)) {
+		std::istringstream ss(line);
+		SKey key;
+		SEntry entry;
+		if (!(ss >> std::hex >> key.corners >> key.edges >> std::dec >> entry.timeOut)
+			|| !std::getline(ss >> std::ws, entry.solution) || entry.solution.empty()) {
+			// 途中で切れた行などは読み飛ばす
+			continue;
+		}
+		Insert(key, entry);
+	}
+	return true;
+}
+
+// ファイルに解法を保存する
+// 一時ファイルに書き込んでから置き換えるので，途中で終了しても壊れたファイルは残らない
+bool CSolutionCache::Save() const
+{
+	const std::string tempFileName = m_fileName + ".tmp";
+	std::ofstream output(tempFileName);
+	output << FileHeader << " " << FormatVersion << "\n";
+	// 古い順に書き込む(読み込むと同じ順序になる)
+	for (auto it = m_entries.rbegin(); it != m_entries.rend(); ++it) {
+		output << std::hex << it->first.corners << " " << it->first.edges << " "
+			<< std::dec << it->second.timeOut << " " << it->second.solution << "\n";
+	}
+	output.close();
+	if (!output) {
+		std::remove(tempFileName.c_str());
+		return false;
+	}
+	std::remove(m_fileName.c_str());
+	return std::rename(tempFileName.c_str(), m_fileName.c_str()) == 0;
+}
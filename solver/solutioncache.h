@@ -0,0 +1,156 @@
+﻿#ifndef	_SOLUTIONCACHE_H_
+#define	_SOLUTIONCACHE_H_
+
+#include <string>
+#include <list>
+#include <utility>
+#include <unordered_map>
+#include <unordered_set>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+#include "cube.h"
+
+// 解探索の結果を保存するキャッシュ
+// 同じ状態のCubeが繰り返し送られてきたとき(通信が切れた後の再送，デモの同じスクランブルなど)は，
+// 解探索を行わずに保存した解法を返す
+// - キーはCubeの状態(CornerとEdgeの順列・方向)を詰めた128bitの値(異なる状態が同じキーにならない)
+// - Cube全体の回転・鏡映(48種類の対称変換)と逆元で移り合う状態は，キーが最小になる状態(代表)にまとめる
+//   解法は代表の状態の解法として保存し，取得するときに要求したCubeの解法に変換する
+//   (色の割り当てが異なる場合は，CGroupCubeが中央の色で面を決めるので同じ状態になる)
+// - 容量を超えたら，最も長い間使われていない解法から破棄する(LRU)
+// - ファイル名を設定すると，解法を追加するたびに保存し，次回の起動時に読み込む
+// - 同じキーの解探索が実行中のときは，新たに探索せずにその探索の終了を待つ
+// - タイムアウトで打ち切った探索の解法は最短とは限らないので，タイムアウトと一緒に保存し，
+//   より長いタイムアウトで要求されたときは解探索をやり直して置き換える
+// - 解法の"."は移動列を2つに分けるだけで，Phase 1とPhase 2の境界を表すとは限らない
+//   (逆元で変換した解法は「逆元のPhase 2 . 逆元のPhase 1」になり，対称変換ではPhase 2の軸がUDでなくなる
+//    Portfolio探索の解法と同じ形式なので，受け取る側は"."を読み飛ばして移動列として使うこと)
+// 複数のスレッドから同時に呼び出してもよい
+class CSolutionCache
+{
+public:
+	enum
+	{
+		DefaultCapacity = 4096,	// 保存する解法の数の上限
+		FormatVersion = 3	// ファイルの形式を変えたら増やす
+	};
+
+	// 解探索の種類(種類ごとに別の解法を保存する)
+	enum SearchType
+	{
+		TwoPhaseSearch,	// Two Phase Algorithm
+		OptimalSearch	// 最適解探索
+	};
+
+	// キャッシュのキー
+	struct SKey
+	{
+		uint64_t corners;	// Cornerの順列(3bit * 8) + 方向(2bit * 8)
+		uint64_t edges;	// Edgeの順列(4bit * 12) + 方向(1bit * 12) + 解探索の種類
+
+		bool operator==(const SKey& p_key) const
+		{
+			return corners == p_key.corners && edges == p_key.edges;
+		}
+	};
+
+	// Cubeを代表の状態に移す変換 (代表 = S * X * S^-1, X = Cube または Cubeの逆元)
+	struct STransform
+	{
+		int symmetry;	// 対称変換S
+		bool isInverse;	// Xが逆元か
+	};
+
+	// 標準のファイル名
+	static const std::string DefaultFileName;
+	// 探索を最後まで行った解法のタイムアウト(どのタイムアウトの要求にもそのまま返す)
+	static const int64_t CompletedSearch;
+
+	CSolutionCache(const size_t p_capacity = DefaultCapacity);
+	~CSolutionCache();
+
+	// 解法を保存するファイルを設定して，ファイルに保存されている解法を読み込む
+	// 空の文字列なら保存しない
+	// ファイルが無い，または形式が異なるときは空のキャッシュから始める(falseを返す)
+	bool SetFileName(const std::string& p_fileName);
+
+	// Cubeの状態から，対称変換と逆元で移り合う状態の代表のキーを作成する
+	// p_transformにはCubeを代表の状態に移す変換を返す
+	static SKey GetKey(const CCube& p_cube, const SearchType p_searchType, STransform& p_transform);
+
+	// キャッシュから解法を取得し，無ければp_solveで解探索を行って保存する
+	// p_keyとp_transformはGetKeyで作成したもの，p_timeOutは解探索のタイムアウト
+	// p_solveは要求したCubeの解法を返し，解けなかったときは空の文字列を返す(保存しない)
+	// 探索を最後まで行ったとき(タイムアウトしなかったとき)は，p_isCompletedをtrueにする
+	// 保存している解法がp_timeOutより短いタイムアウトで打ち切った探索のものなら，解探索をやり直す
+	// 同じキーの解探索が他のスレッドで実行中なら，その終了を待ってから取得する
+	std::string Solve(const SKey& p_key, const STransform& p_transform, const int64_t p_timeOut, const std::function<std::string(bool& p_isCompleted)>& p_solve);
+
+	// 解法を変換する
+	// 要求したCubeの解法から代表の状態の解法へ(p_isToRepresentativeがtrue)，またはその逆
+	// 逆元で変換するときは"."の前後の移動列が入れ替わる(Phase 1とPhase 2の境界は保たない)
+	static std::string TransformSolution(const std::string& p_solution, const STransform& p_transform, const bool p_isToRepresentative);
+
+	// キャッシュから解法を取得できた回数
+	uint64_t GetHits() const;
+	// 解探索を行った回数
+	uint64_t GetMisses() const;
+	// 実行中の同じ解探索の終了を待って取得した回数(GetHitsに含まれる)
+	uint64_t GetCoalesced() const;
+	// 保存している解法の数
+	size_t GetSize() const;
+
+private:
+	struct SKeyHash
+	{
+		size_t operator()(const SKey& p_key) const
+		{
+			return (size_t)(p_key.corners * 0x9e3779b97f4a7c15ULL ^ p_key.edges);
+		}
+	};
+	// Cubeの状態をそのまま詰めたキーを作成する
+	static SKey PackKey(const CCube& p_cube, const SearchType p_searchType);
+
+	// 保存する解法
+	struct SEntry
+	{
+		std::string solution;	// 代表の状態の解法
+		int64_t timeOut;	// 解探索のタイムアウト(最後まで探索したときはCompletedSearch)
+	};
+
+	// 先頭が最近使った解法
+	typedef std::list<std::pair<SKey, SEntry> > EntryList;
+
+	// p_timeOut以上のタイムアウトで探索した解法を探して，見つかれば最近使った解法にする(m_mutexをlockして呼び出す)
+	bool Find(const SKey& p_key, const int64_t p_timeOut, std::string& p_solution);
+	// 解法を追加(同じキーがあれば置き換え)して，容量を超えたら最も古い解法を破棄する(m_mutexをlockして呼び出す)
+	void Insert(const SKey& p_key, const SEntry& p_entry);
+
+	// ファイルの読み込み・保存(m_mutexをlockして呼び出す)
+	bool Load();
+	bool Save() const;
+
+	// 保存する解法の数の上限
+	size_t m_capacity;
+	// 解法を保存するファイル(空なら保存しない)
+	std::string m_fileName;
+
+	mutable std::mutex m_mutex;
+	// 実行中の解探索が終了したことを通知する
+	std::condition_variable m_completed;
+
+	EntryList m_entries;
+	std::unordered_map<SKey, EntryList::iterator, SKeyHash> m_index;
+	// 実行中の解探索のキー
+	std::unordered_set<SKey, SKeyHash> m_inFlight;
+
+	// 統計
+	uint64_t m_hits;
+	uint64_t m_misses;
+	uint64_t m_coalesced;
+};
+
+#endif	// _SOLUTIONCACHE_H_
@@ -0,0 +1,76 @@
+#-------------------------------------------------
+#
+# Solverのソースファイル
+# CubeSolverとTableGeneratorで共有する
+#
+#-------------------------------------------------
+
+INCLUDEPATH += $$PWD/..
+
+# 小さなMoveTableをコンパイル時に(constexprで)作成するので，定数式の評価の上限を上げる
+msvc: QMAKE_CXXFLAGS += /constexpr:steps100000000
+clang: QMAKE_CXXFLAGS += -fconstexpr-steps=100000000
+
+# CPackedCubeの移動をSSSE3のbyteの並べ替え(pshufb)で行う(x86以外では通常の配列の操作になる)
+# MSVCはオプション無しでSSSE3のintrinsicを使えるので，起動時にCPUIDで確認してから使う
+# (/arch:AVX以上を指定したときは確認せずに常に使う)
+!msvc {
+    contains(QT_ARCH, x86_64)|contains(QT_ARCH, i386): QMAKE_CXXFLAGS += -mssse3
+}
+
+SOURCES += $$PWD/cube.cpp \
+    $$PWD/cubeparser.cpp \
+    $$PWD/groupcube.cpp \
+    $$PWD/idastarsearch.cpp \
+    $$PWD/movetable.cpp \
+    $$PWD/staticmovetable.cpp \
+    $$PWD/ordinalcube.cpp \
+    $$PWD/printvector.cpp \
+    $$PWD/pruningtable.cpp \
+    $$PWD/tablefile.cpp \
+    $$PWD/tablebundle.cpp \
+    $$PWD/solvertables.cpp \
+    $$PWD/symmetry.cpp \
+    $$PWD/flipslicetable.cpp \
+    $$PWD/flipslicepruningtable.cpp \
+    $$PWD/cornerpermutationtable.cpp \
+    $$PWD/cornerpermutationpruningtable.cpp \
+    $$PWD/edgesubsetpruningtable.cpp \
+    $$PWD/optimalsolvertables.cpp \
+    $$PWD/optimalsearch.cpp \
+    $$PWD/solutioncache.cpp \
+    $$PWD/nearsolveddatabase.cpp \
+    $$PWD/packedcube.cpp \
+    $$PWD/phase2entrytable.cpp \
+    $$PWD/movesequenceautomaton.cpp
+
+HEADERS += $$PWD/cube.h \
+    $$PWD/cubeparser.h \
+    $$PWD/groupcube.h \
+    $$PWD/movetable.h \
+    $$PWD/staticmovetable.h \
+    $$PWD/printvector.h \
+    $$PWD/pruningtable.h \
+    $$PWD/tablefile.h \
+    $$PWD/tablebundle.h \
+    $$PWD/pairpruningtable.h \
+    $$PWD/submovetable.h \
+    $$PWD/timer.h \
+    $$PWD/calculateordinal.h \
+    $$PWD/idastarsearch.h \
+    $$PWD/ordinalcube.h \
+    $$PWD/solvertables.h \
+    $$PWD/lockfreequeue.h \
+    $$PWD/symmetry.h \
+    $$PWD/flipslicetable.h \
+    $$PWD/flipslicepruningtable.h \
+    $$PWD/cornerpermutationtable.h \
+    $$PWD/cornerpermutationpruningtable.h \
+    $$PWD/edgesubsetpruningtable.h \
+    $$PWD/optimalsolvertables.h \
+    $$PWD/optimalsearch.h \
+    $$PWD/solutioncache.h \
+    $$PWD/nearsolveddatabase.h \
+    $$PWD/packedcube.h \
+    $$PWD/phase2entrytable.h \
+    $$PWD/movesequenceautomaton.h
@@ -0,0 +1,172 @@
+﻿#include "solvertables.h"
+
+CSolverTables::CSolverTables()
+	: m_isInitialized(false),
+	// Clean Cubeを渡してconstructする
+	// (Phase 1のMoveTableとMiddle層のEdgeの順列のMoveTableはコンパイル時に作成済み)
+	// Phase 2のMoveTable
+	m_cornerPermutationMoveTable(m_cube),
+	m_upDownEdgePermutationMoveTable(m_cube),
+	m_upDownEdgeSplit1MoveTable(m_cube, CCube::UF),
+	m_upDownEdgeSplit2MoveTable(m_cube, CCube::UR),
+	m_middleEdgePositionsMoveTable(m_cube),
+
+	// MoveTable2つを組み合わせて，PruningTable(パターンデータベース)を作成する
+	// 数十MBの大きなTableはDepthを3で割った余りだけを格納して，メモリを半分にする
+	// (探索では親ノードのDepthから正確なDepthを復元する)
+	// Phase 1の刈込テーブル
+	// flipとchoiceは対称変換の同値類にまとめてtwistと組み合わせる
+	m_twistAndFlipSlicePruningTable(
+		m_twistMoveTable, m_flipMoveTable, m_choiceMoveTable, m_flipSliceSymmetryTable,
+		m_cube.GetTwistFromOrientations(), m_cube.GetFlipFromOrientations(), m_cube.GetChoiceFromEdgePermutation(),
+		CPruningTable::TwoBitModulo3),
+	// 逆元のheuristicに使用する刈込テーブル
+	m_twistAndChoicePruningTable(
+		m_twistMoveTable, m_choiceMoveTable,
+		m_cube.GetTwistFromOrientations(), m_cube.GetChoiceFromEdgePermutation()),
+	m_flipAndChoicePruningTable(
+		m_flipMoveTable, m_choiceMoveTable,
+		m_cube.GetFlipFromOrientations(), m_cube.GetChoiceFromEdgePermutation()),
+	// Phase 2の刈込テーブル
+	m_cornerAndMiddlePruningTable(
+		m_cornerPermutationMoveTable, m_middleEdgePermutationMoveTable,
+		m_cube.GetOrdinalFromCornerPermutation(), m_cube.GetOrdinalFromMiddleEdgePermutation()),
+	m_upDownAndMiddlePruningTable(
+		m_upDownEdgePermutationMoveTable, m_middleEdgePermutationMoveTable,
+		m_cube.GetOrdinalFromUpDownEdgePermutation(), m_cube.GetOrdinalFromMiddleEdgePermutation()),
+	// Cornerの順列は対称変換の同値類にまとめてUp層・Down層のEdgeの順列と組み合わせる
+	m_cornerAndUpDownPruningTable(
+		m_cornerPermutationMoveTable, m_upDownEdgePermutationMoveTable, m_cornerPermutationSymmetryTable,
+		m_cube.GetOrdinalFromCornerPermutation(), m_cube.GetOrdinalFromUpDownEdgePermutation(),
+		CPruningTable::TwoBitModulo3),
+	m_nearSolvedMemoryBudget((uint64_t)CNearSolvedDatabase::DefaultMemoryBudget << 20)
+{
+    // MoveTable connection
+    connect(&m_cornerPermutationMoveTable, SIGNAL(notifySolverMessage(QString)),
+            this, SLOT(onGetSolverMessage(QString)));
+    connect(&m_upDownEdgePermutationMoveTable, SIGNAL(notifySolverMessage(QString)),
+            this, SLOT(onGetSolverMessage(QString)));
+    connect(&m_upDownEdgeSplit1MoveTable, SIGNAL(notifySolverMessage(QString)),
+            this, SLOT(onGetSolverMessage(QString)));
+    connect(&m_upDownEdgeSplit2MoveTable, SIGNAL(notifySolverMessage(QString)),
+            this, SLOT(onGetSolverMessage(QString)));
+    connect(&m_middleEdgePositionsMoveTable, SIGNAL(notifySolverMessage(QString)),
+            this, SLOT(onGetSolverMessage(QString)));
+
+    // SymmetryTable connection
+    connect(&m_flipSliceSymmetryTable, SIGNAL(notifySolverMessage(QString)),
+            this, SLOT(onGetSolverMessage(QString)));
+    connect(&m_cornerPermutationSymmetryTable, SIGNAL(notifySolverMessage(QString)),
+            this, SLOT(onGetSolverMessage(QString)));
+
+    // PruningTable connection
+    connect(&m_twistAndFlipSlicePruningTable, SIGNAL(notifySolverMessage(QString)),
+            this, SLOT(onGetSolverMessage(QString)));
+    connect(&m_twistAndChoicePruningTable, SIGNAL(notifySolverMessage(QString)),
+            this, SLOT(onGetSolverMessage(QString)));
+    connect(&m_flipAndChoicePruningTable, SIGNAL(notifySolverMessage(QString)),
+            this, SLOT(onGetSolverMessage(QString)));
+    connect(&m_cornerAndMiddlePruningTable, SIGNAL(notifySolverMessage(QString)),
+            this, SLOT(onGetSolverMessage(QString)));
+    connect(&m_upDownAndMiddlePruningTable, SIGNAL(notifySolverMessage(QString)),
+            this, SLOT(onGetSolverMessage(QString)));
+    connect(&m_cornerAndUpDownPruningTable, SIGNAL(notifySolverMessage(QString)),
+            this, SLOT(onGetSolverMessage(QString)));
+}
+
+CSolverTables::~CSolverTables()
+{
+}
+
+// MoveTable,PruningTableを初期化する
+bool CSolverTables::Initialize(const CTableBundle* p_bundle)
+{
+	// 既に読み込み済みであれば何もしない
+	if (m_isInitialized) {
+		return true;
+	}
+	bool isLoaded = true;
+	m_fileNames.clear();
+
+	// Phase 1のMoveTableはコンパイル時に作成済みなので，読み込まない
+	// (twist, flip, choice, Middle層のEdgeの順列)
+
+	// Phase 2のMoveTableを作成する
+    //std::cout << "Initializing CornerPermutationMoveTable" << std::endl;
+    emit notifySolverMessage("Initializing CornerPermutationMoveTable");
+	isLoaded &= InitializeTable(m_cornerPermutationMoveTable, "CornerPermutationMoveTable.mt", p_bundle);
+    //std::cout << "Size = " << m_cornerPermutationMoveTable.GetSize() << std::endl;
+    //emit notifySolverMessage("Size = " + QString::number(m_cornerPermutationMoveTable.GetSize()));
+
+    //std::cout << "Initializing UpDownEdgePermutationMoveTable" << std::endl;
+    emit notifySolverMessage("Initializing UpDownEdgePermutationMoveTable");
+	isLoaded &= InitializeTable(m_upDownEdgePermutationMoveTable, "UpDownEdgePermutationMoveTable.mt", p_bundle);
+    //std::cout << "Size = " << m_upDownEdgePermutationMoveTable.GetSize() << std::endl;
+    //emit notifySolverMessage("Size = " + QString::number(m_upDownEdgePermutationMoveTable.GetSize()));
+
+	// Phase 1の探索中にPhase 2の座標を追跡するMoveTableを作成する
+    emit notifySolverMessage("Initializing UpDownEdgeSplitMoveTables");
+	isLoaded &= InitializeTable(m_upDownEdgeSplit1MoveTable, "UpDownEdgeSplit1MoveTable.mt", p_bundle);
+	isLoaded &= InitializeTable(m_upDownEdgeSplit2MoveTable, "UpDownEdgeSplit2MoveTable.mt", p_bundle);
+    emit notifySolverMessage("Initializing MiddleEdgePositionsMoveTable");
+	isLoaded &= InitializeTable(m_middleEdgePositionsMoveTable, "MiddleEdgePositionsMoveTable.mt", p_bundle);
+	m_phase2EntryTable.Initialize();
+
+	// 冗長な移動列を除外するオートマトンを作成する
+    emit notifySolverMessage("Initializing MoveSequenceAutomatons");
+	m_phase1MoveSequences.Initialize(false, CMoveSequenceAutomaton::Phase1MaxLength);
+	m_phase2MoveSequences.Initialize(true, CMoveSequenceAutomaton::Phase2MaxLength);
+    emit notifySolverMessage("States = " + QString::number(m_phase1MoveSequences.GetNumberOfStates())
+                             + ", " + QString::number(m_phase2MoveSequences.GetNumberOfStates()));
+
+	// flipsliceの同値類のTableを作成する
+    emit notifySolverMessage("Initializing FlipSliceSymmetryTable");
+	isLoaded &= InitializeTable(m_flipSliceSymmetryTable, "FlipSliceSymmetryTable.st", p_bundle);
+
+	// Cornerの順列の同値類のTableを作成する
+    emit notifySolverMessage("Initializing CornerPermutationSymmetryTable");
+	isLoaded &= InitializeTable(m_cornerPermutationSymmetryTable, "CornerPermutationSymmetryTable.st", p_bundle);
+
+	// Phase 1のPruningTableを作成する
+    //std::cout << "Initializing TwistAndFlipSlicePruningTable" << std::endl;
+    emit notifySolverMessage("Initializing TwistAndFlipSlicePruningTable");
+	isLoaded &= InitializeTable(m_twistAndFlipSlicePruningTable, "TwistAndFlipSlicePruningTable.pt", p_bundle);
+    //std::cout << "Size = " << m_twistAndFlipSlicePruningTable.GetSize() << std::endl;
+    //emit notifySolverMessage("Size = " + QString::number(m_twistAndFlipSlicePruningTable.GetSize()));
+
+    emit notifySolverMessage("Initializing TwistAndChoicePruningTable");
+	isLoaded &= InitializeTable(m_twistAndChoicePruningTable, "TwistAndChoicePruningTable.pt", p_bundle);
+    emit notifySolverMessage("Initializing FlipAndChoicePruningTable");
+	isLoaded &= InitializeTable(m_flipAndChoicePruningTable, "FlipAndChoicePruningTable.pt", p_bundle);
+
+	// Phase 2のPruningTableを作成する
+    //std::cout << "Initializing CornerAndMiddlePruningTable" << std::endl;
+    emit notifySolverMessage("Initializing CornerAndMiddlePruningTable");
+	isLoaded &= InitializeTable(m_cornerAndMiddlePruningTable, "CornerAndMiddlePruningTable.pt", p_bundle);
+    //std::cout << "Size = " << m_cornerAndMiddlePruningTable.GetSize() << std::endl;
+    //emit notifySolverMessage("Size = " + QString::number(m_cornerAndMiddlePruningTable.GetSize()));
+
+    //std::cout << "Initializing UpDownAndMiddlePruningTable" << std::endl;
+    emit notifySolverMessage("Initializing UpDownAndMiddlePruningTable");
+	isLoaded &= InitializeTable(m_upDownAndMiddlePruningTable, "UpDownAndMiddlePruningTable.pt", p_bundle);
+    //std::cout << "Size = " << m_upDownAndMiddlePruningTable.GetSize() << std::endl;
+    //emit notifySolverMessage("Size = " + QString::number(m_upDownAndMiddlePruningTable.GetSize()));
+
+    //std::cout << "Initializing CornerClassAndUpDownPruningTable" << std::endl;
+    emit notifySolverMessage("Initializing CornerClassAndUpDownPruningTable");
+	isLoaded &= InitializeTable(m_cornerAndUpDownPruningTable, "CornerClassAndUpDownPruningTable.pt", p_bundle);
+    //std::cout << "Size = " << m_cornerAndUpDownPruningTable.GetSize() << std::endl;
+    //emit notifySolverMessage("Size = " + QString::number(m_cornerAndUpDownPruningTable.GetSize()));
+
+	// 完成付近のデータベースを作成する
+	// (Tableの読み込みに失敗したときは解探索を行わないので作成しない)
+	if (isLoaded && m_nearSolvedMemoryBudget > 0) {
+        emit notifySolverMessage("Initializing NearSolvedDatabase");
+		m_nearSolvedDatabase.Initialize(m_nearSolvedMemoryBudget);
+        emit notifySolverMessage("Depth = " + QString::number(m_nearSolvedDatabase.GetDepth())
+                                 + ", States = " + QString::number(m_nearSolvedDatabase.GetNumberOfStates()));
+	}
+
+	m_isInitialized = isLoaded;
+	return isLoaded;
+}
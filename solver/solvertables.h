@@ -0,0 +1,112 @@
+﻿#ifndef	_SOLVERTABLES_H_
+#define	_SOLVERTABLES_H_
+
+#include <QObject>
+#include <string>
+#include <vector>
+
+#include "ordinalcube.h"
+#include "tablebundle.h"
+#include "submovetable.h"
+#include "pairpruningtable.h"
+#include "flipslicetable.h"
+#include "flipslicepruningtable.h"
+#include "cornerpermutationtable.h"
+#include "cornerpermutationpruningtable.h"
+#include "nearsolveddatabase.h"
+#include "phase2entrytable.h"
+#include "movesequenceautomaton.h"
+
+// Two Phase Algorithmで使用するMoveTable,PruningTableをまとめて保持するクラス
+// プロセス起動時に一度だけInitializeを呼び出し，以降は複数回の解探索(CIDAstarSearch)で共有する
+// Initialize後はTableを書き換えないので，探索側からは読み出し専用として扱う
+class CSolverTables : public QObject
+{
+    Q_OBJECT
+public slots:
+    void onGetSolverMessage(QString p_message)
+    {
+        emit notifySolverMessage(p_message);
+    }
+signals:
+    void notifySolverMessage(QString p_message);
+
+public:
+	CSolverTables();
+	~CSolverTables();
+
+	// MoveTable,PruningTableを初期化する
+	// p_bundleを指定したときはバンドルの中のTableだけを使い，1つでも無ければfalseを返す
+	// 指定しないときは，ファイルが存在すればメモリマップし，無ければ作成して保存する
+	bool Initialize(const CTableBundle* p_bundle = NULL);
+
+	// Initializeで使用したTableのファイル名(バンドルの作成に使用する)
+	const std::vector<std::string>& GetFileNames() const { return m_fileNames; }
+
+	// Tableの初期化が完了しているか
+	bool IsInitialized() const { return m_isInitialized; }
+
+	// 完成付近のデータベースのメモリの上限(byte)を設定する(Initializeより前に呼び出す)
+	// 上限に収まる最大の手数のデータベースを作成する(0なら作成しない)
+	void SetNearSolvedMemoryBudget(const uint64_t p_memoryBudget) { m_nearSolvedMemoryBudget = p_memoryBudget; }
+
+private:
+	// Tableを初期化して，ファイル名を記録する
+	template <class TTable>
+	bool InitializeTable(TTable& p_table, const std::string p_fileName, const CTableBundle* p_bundle)
+	{
+		m_fileNames.push_back(p_fileName);
+		return p_table.Initialize(p_fileName, p_bundle);
+	}
+
+	// 探索クラスからTableを直接参照する
+	friend class CIDAstarSearch;
+
+	// Tableの初期化が完了しているか
+	bool m_isInitialized;
+	// Tableのファイル名
+	std::vector<std::string> m_fileNames;
+
+	// MoveTableの初期化に使用するための変数
+	COrdinalCube m_cube;
+
+	// Phase 1のMoveTable(コンパイル時に作成済み)
+	CTwistMoveTable m_twistMoveTable;
+	CFlipMoveTable m_flipMoveTable;
+	CChoiceMoveTable m_choiceMoveTable;
+	// Phase 2のMoveTable
+	CCornerPermutationMoveTable m_cornerPermutationMoveTable;
+	CUpDownEdgePermutationMoveTable m_upDownEdgePermutationMoveTable;
+	CMiddleEdgePermutationMoveTable m_middleEdgePermutationMoveTable;	// コンパイル時に作成済み
+	// Phase 1の探索中にPhase 2の座標を追跡するMoveTable
+	CUpDownEdgeSplitMoveTable m_upDownEdgeSplit1MoveTable;	// UF,UL,UBの位置
+	CUpDownEdgeSplitMoveTable m_upDownEdgeSplit2MoveTable;	// UR,DF,DLの位置
+	CMiddleEdgePositionsMoveTable m_middleEdgePositionsMoveTable;
+	// 追跡した座標からPhase 1の完成状態のPhase 2の序数を求めるTable(ファイルには保存せず，起動時に作成する)
+	CPhase2EntryTable m_phase2EntryTable;
+
+	// 冗長な移動列を除外するオートマトン(ファイルには保存せず，起動時に作成する)
+	CMoveSequenceAutomaton m_phase1MoveSequences;
+	CMoveSequenceAutomaton m_phase2MoveSequences;
+
+	// flipsliceの対称変換による同値類
+	CFlipSliceSymmetryTable m_flipSliceSymmetryTable;
+	// Cornerの順列の対称変換による同値類
+	CCornerPermutationSymmetryTable m_cornerPermutationSymmetryTable;
+
+	// Phase 1のPruningTable
+	CTwistAndFlipSlicePruningTable m_twistAndFlipSlicePruningTable;
+	// 逆元のPhase 1のPruningTable(移動を先に行うのでDepthを復元できず，正確なDepthを格納する)
+	CPairPruningTable<CTwistMoveTable, CChoiceMoveTable> m_twistAndChoicePruningTable;
+	CPairPruningTable<CFlipMoveTable, CChoiceMoveTable> m_flipAndChoicePruningTable;
+	// Phase 2のPruningTable
+	CPairPruningTable<CCornerPermutationMoveTable, CMiddleEdgePermutationMoveTable> m_cornerAndMiddlePruningTable;
+	CPairPruningTable<CUpDownEdgePermutationMoveTable, CMiddleEdgePermutationMoveTable> m_upDownAndMiddlePruningTable;
+	CCornerAndUpDownPruningTable m_cornerAndUpDownPruningTable;
+
+	// 完成付近のデータベース(ファイルには保存せず，起動時に作成する)
+	CNearSolvedDatabase m_nearSolvedDatabase;
+	uint64_t m_nearSolvedMemoryBudget;
+};
+
+#endif	// _SOLVERTABLES_H_
@@ -0,0 +1,31 @@
+﻿#include "staticmovetable.h"
+
+// コンパイル時に作成したTable(読み出し専用のデータとして実行ファイルに格納される)
+// 要素は合計で約170KB
+namespace
+{
+	constexpr CTwistMoveTable::STable TwistMoveTable = CTwistMoveTable::Generate();
+	constexpr CFlipMoveTable::STable FlipMoveTable = CFlipMoveTable::Generate();
+	constexpr CChoiceMoveTable::STable ChoiceMoveTable = CChoiceMoveTable::Generate();
+	constexpr CMiddleEdgePermutationMoveTable::STable MiddleEdgePermutationMoveTable = CMiddleEdgePermutationMoveTable::Generate();
+}
+
+CTwistMoveTable::CTwistMoveTable()
+	: CStaticMoveTable(TwistMoveTable.m_table)
+{
+}
+
+CFlipMoveTable::CFlipMoveTable()
+	: CStaticMoveTable(FlipMoveTable.m_table)
+{
+}
+
+CChoiceMoveTable::CChoiceMoveTable()
+	: CStaticMoveTable(ChoiceMoveTable.m_table)
+{
+}
+
+CMiddleEdgePermutationMoveTable::CMiddleEdgePermutationMoveTable()
+	: CStaticMoveTable(MiddleEdgePermutationMoveTable.m_table)
+{
+}
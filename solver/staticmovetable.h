@@ -0,0 +1,191 @@
+﻿#ifndef	_STATICMOVETABLE_H_
+#define	_STATICMOVETABLE_H_
+
+#include "ordinalcube.h"
+
+#include <cstdint>
+
+// コンパイル時にMoveTableを作成するためのCubeの状態
+// CCubeと同じPermutationとOrientationを持ち，CCube::QuarterTurnsの定義に従って移動する
+struct SStaticCube
+{
+	int cornerPermutation[CCube::NumberOfCornerSets];
+	int cornerOrientations[CCube::NumberOfCornerSets];
+	int edgePermutation[CCube::NumberOfEdgeSets];
+	int edgeOrientations[CCube::NumberOfEdgeSets];
+
+	// Clean Cubeに戻す
+	constexpr void SetCleanCube()
+	{
+		for (int corner = CCube::FirstCornerSet; corner <= CCube::LastCornerSet; corner++) {
+			cornerPermutation[corner] = corner;
+			cornerOrientations[corner] = CCube::NoTwist;
+		}
+		for (int edge = CCube::FirstEdgeSet; edge <= CCube::LastEdgeSet; edge++) {
+			edgePermutation[edge] = edge;
+			edgeOrientations[edge] = CCube::NotFlipped;
+		}
+	}
+
+	// 時計回り90[deg]の移動を行う(CCube::ApplyMoveのU ~ Bと同じ)
+	constexpr void ApplyQuarterTurn(const int p_face)
+	{
+		const CCube::SQuarterTurn& turn = CCube::QuarterTurns[p_face];
+		ShiftVector(cornerPermutation, turn.corners);
+		ShiftVector(cornerOrientations, turn.corners);
+		ShiftVector(edgePermutation, turn.edges);
+		ShiftVector(edgeOrientations, turn.edges);
+		for (int i = 0; i < 4; i++) {
+			cornerOrientations[turn.corners[i]] = (cornerOrientations[turn.corners[i]] + turn.cornerTwists[i]) % CCube::NumberOfTwists;
+			edgeOrientations[turn.edges[i]] ^= turn.edgeFlips[i];
+		}
+	}
+
+	// 4か所の要素を p[0] -> p[1] -> p[2] -> p[3] -> p[0] の位置にシフトする
+	static constexpr void ShiftVector(int* vector, const int* p_positions)
+	{
+		int temp = vector[p_positions[3]];
+		vector[p_positions[3]] = vector[p_positions[2]];
+		vector[p_positions[2]] = vector[p_positions[1]];
+		vector[p_positions[1]] = vector[p_positions[0]];
+		vector[p_positions[0]] = temp;
+	}
+};
+
+// 序数の数が少ないMoveTableを，コンパイル時に作成して読み出し専用のデータとして実行ファイルに格納する
+// 起動時にファイルを読み込んだり作成したりせずに，最初のノードの展開から使用できる
+// TDerivedはGetOrdinalFromCubeState,SetCubeStateFromOrdinalをconstexprの静的関数として実装した継承先のクラス(CRTP)
+// 探索からはCBasicMoveTableと同じく m_table[ordinal][move] で参照する
+template <class TDerived, typename TEntry, int TSize, bool TIsPhase2>
+class CStaticMoveTable
+{
+public:
+	enum
+	{
+		Size = TSize,	// 序数の数
+		IsPhase2Table = TIsPhase2	// Phase 2の移動のみを格納するか
+	};
+
+	// コンパイル時に作成するTable
+	struct STable
+	{
+		TEntry m_table[TSize][CCube::Move::NumberOfMoves];
+	};
+
+	// privateなTableに対して，オブジェクトの添え字でアクセスするための演算子
+	// m_table[ordinal][move]は序数ordinalの状態のときにmoveの状態遷移をした後の序数を表す
+	inline const TEntry* operator[](const int p_index) const
+	{
+		return m_table[p_index];
+	}
+
+	// Tableのサイズ(序数の数)を取得
+	int GetSize() const { return TSize; }
+
+	// Phase 2の移動<U,D,R2,L2,F2,B2>のみを格納したTableか
+	bool IsPhase2() const { return TIsPhase2; }
+
+	// MoveTableを作成する(constexprの変数の初期化に使用する)
+	// 各序数の状態に対して時計回り90[deg]の移動を行った序数を格納し，
+	// 180[deg]，-90[deg]回転の序数は90[deg]回転のTableを繰り返し参照して求める
+	// (コンパイル時の評価の回数を減らす)
+	static constexpr STable Generate()
+	{
+		STable table = {};
+
+		for (int ordinal = 0; ordinal < TSize; ordinal++) {
+			// ordinalの値に応じたuniqueなcubeの状態を設定する
+			SStaticCube cube = {};
+			cube.SetCleanCube();
+			TDerived::SetCubeStateFromOrdinal(ordinal, cube);
+
+			for (int face = CCube::U; face < CCube::NumberOfClockwiseQuarterTurnMoves; face++) {
+				SStaticCube movedCube = cube;
+				movedCube.ApplyQuarterTurn(face);
+				if (!TIsPhase2 || CCube::IsPhase2Move(face)) {
+					table.m_table[ordinal][face] = (TEntry)TDerived::GetOrdinalFromCubeState(movedCube);
+				}
+				else {
+					// Phase 2の座標は90[deg]回転で定義されないので，180[deg]回転を直接求める
+					// それ以外の移動は0のままにしておく
+					movedCube.ApplyQuarterTurn(face);
+					table.m_table[ordinal][CCube::GetMoveOfPower(face, 2)] = (TEntry)TDerived::GetOrdinalFromCubeState(movedCube);
+				}
+			}
+		}
+
+		for (int ordinal = 0; ordinal < TSize; ordinal++) {
+			for (int face = CCube::U; face < CCube::NumberOfClockwiseQuarterTurnMoves; face++) {
+				if (!TIsPhase2 || CCube::IsPhase2Move(face)) {
+					const int quarterTurn = table.m_table[ordinal][face];
+					const int halfTurn = table.m_table[quarterTurn][face];
+					table.m_table[ordinal][CCube::GetMoveOfPower(face, 2)] = (TEntry)halfTurn;
+					table.m_table[ordinal][CCube::GetMoveOfPower(face, 3)] = table.m_table[halfTurn][face];
+				}
+			}
+		}
+		return table;
+	}
+
+protected:
+	// p_tableはコンパイル時に作成したTable
+	CStaticMoveTable(const TEntry (*p_table)[CCube::Move::NumberOfMoves])
+		: m_table(p_table)
+	{
+	}
+
+private:
+	// 配列 const TEntry[18] へのポインタ
+	// 読み出し専用のデータに置いたTEntry table[TSize][18]の領域を指す
+	const TEntry (*m_table)[CCube::Move::NumberOfMoves];
+};
+
+// Phase 1
+
+class CTwistMoveTable : public CStaticMoveTable<CTwistMoveTable, uint16_t, COrdinalCube::Twists, false>
+{
+public:
+	CTwistMoveTable();
+	// CStaticMoveTableから呼び出す
+	static constexpr int GetOrdinalFromCubeState(const SStaticCube& p_cube)
+		{ return COrdinalCube::GetTwistFromOrientations(p_cube.cornerOrientations); }
+	static constexpr void SetCubeStateFromOrdinal(const int p_ordinal, SStaticCube& p_cube)
+		{ COrdinalCube::SetOrientationsFromTwist(p_ordinal, p_cube.cornerOrientations); }
+};
+
+class CFlipMoveTable : public CStaticMoveTable<CFlipMoveTable, uint16_t, COrdinalCube::Flips, false>
+{
+public:
+	CFlipMoveTable();
+	// CStaticMoveTableから呼び出す
+	static constexpr int GetOrdinalFromCubeState(const SStaticCube& p_cube)
+		{ return COrdinalCube::GetFlipFromOrientations(p_cube.edgeOrientations); }
+	static constexpr void SetCubeStateFromOrdinal(const int p_ordinal, SStaticCube& p_cube)
+		{ COrdinalCube::SetOrientationsFromFlip(p_ordinal, p_cube.edgeOrientations); }
+};
+
+class CChoiceMoveTable : public CStaticMoveTable<CChoiceMoveTable, uint16_t, COrdinalCube::Choices, false>
+{
+public:
+	CChoiceMoveTable();
+	// CStaticMoveTableから呼び出す
+	static constexpr int GetOrdinalFromCubeState(const SStaticCube& p_cube)
+		{ return COrdinalCube::GetChoiceFromEdgePermutation(p_cube.edgePermutation); }
+	static constexpr void SetCubeStateFromOrdinal(const int p_ordinal, SStaticCube& p_cube)
+		{ COrdinalCube::ChoicePermutation(p_ordinal, p_cube.edgePermutation); }
+};
+
+// Phase 2
+
+class CMiddleEdgePermutationMoveTable : public CStaticMoveTable<CMiddleEdgePermutationMoveTable, uint16_t, COrdinalCube::MiddleEdgePermutations, true>
+{
+public:
+	CMiddleEdgePermutationMoveTable();
+	// CStaticMoveTableから呼び出す
+	static constexpr int GetOrdinalFromCubeState(const SStaticCube& p_cube)
+		{ return PermutationToOrdinal(&p_cube.edgePermutation[CCube::FirstMiddleEdgeSet], 4); }
+	static constexpr void SetCubeStateFromOrdinal(const int p_ordinal, SStaticCube& p_cube)
+		{ OrdinalToPermutation(p_ordinal, &p_cube.edgePermutation[CCube::FirstMiddleEdgeSet], 4, CCube::FirstMiddleEdgeSet); }
+};
+
+#endif	// _STATICMOVETABLE_H_
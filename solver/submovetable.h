@@ -1,98 +1,113 @@
-﻿#include "movetable.h"
+﻿#ifndef	_SUBMOVETABLE_H_
+#define	_SUBMOVETABLE_H_
+
+#include "movetable.h"
+#include "staticmovetable.h"
 #include "ordinalcube.h"
 
-class CTwistMoveTable : public CMoveTable
+// twist,flip,choice,Middle層のEdgeの順列のMoveTableはコンパイル時に作成する(staticmovetable.h)
+
+// Cornerの順列は全ての移動で定義されるので，Phase 2の座標だが18種類の移動を全て格納する
+// (最適解探索でも同じTableを使用する)
+class CCornerPermutationMoveTable : public CBasicMoveTable<CCornerPermutationMoveTable, uint16_t, COrdinalCube::CornerPermutations, false>
 {
 public:
-	CTwistMoveTable(COrdinalCube& cube)
-		: CMoveTable(cube, COrdinalCube::Twists, false),TheCube(cube)
+	CCornerPermutationMoveTable(COrdinalCube& cube)
+		: CBasicMoveTable(cube),TheCube(cube)
 	{
 
 	}
-private:
+	// CBasicMoveTableから呼び出す
 	inline int GetOrdinalFromCubeState() const
-		{ return TheCube.GetTwistFromOrientations(); }
+		{ return TheCube.GetOrdinalFromCornerPermutation(); }
 	inline void SetCubeStateFromOrdinal(const int p_ordinal)
-		{ TheCube.SetOrientationsFromTwist(p_ordinal); }
+		{ TheCube.SetCornerPermutationFromOrdinal(p_ordinal); }
+private:
 	COrdinalCube& TheCube;
 };
 
-class CFlipMoveTable : public CMoveTable
+class CUpDownEdgePermutationMoveTable : public CBasicMoveTable<CUpDownEdgePermutationMoveTable, uint16_t, COrdinalCube::UpDownEdgePermutations, true>
 {
 public:
-	CFlipMoveTable(COrdinalCube& cube)
-		: CMoveTable(cube, COrdinalCube::Flips, false),TheCube(cube)
+	CUpDownEdgePermutationMoveTable(COrdinalCube& cube)
+		: CBasicMoveTable(cube),TheCube(cube)
 	{
 
 	}
-private:
+	// CBasicMoveTableから呼び出す
 	inline int GetOrdinalFromCubeState() const
-		{ return TheCube.GetFlipFromOrientations(); }
+		{ return TheCube.GetOrdinalFromUpDownEdgePermutation(); }
 	inline void SetCubeStateFromOrdinal(const int p_ordinal)
-		{ TheCube.SetOrientationsFromFlip(p_ordinal); }
-	COrdinalCube& TheCube;
-};
-
-class CChoiceMoveTable : public CMoveTable
-{
-public:
-	CChoiceMoveTable(COrdinalCube& cube)
-		: CMoveTable(cube, COrdinalCube::Choices, false), TheCube(cube)
-	{
-	
-	}
+		{ TheCube.SetUpDownEdgePermutationFromOrdinal(p_ordinal); }
 private:
-	inline int GetOrdinalFromCubeState() const
-		{ return TheCube.GetChoiceFromEdgePermutation(); }
-	inline void SetCubeStateFromOrdinal(const int p_ordinal)
-		{ TheCube.SetChoiceFromEdgePermutation(p_ordinal); }
 	COrdinalCube& TheCube;
 };
 
-class CCornerPermutationMoveTable : public CMoveTable
+// Phase 1の探索中に追跡するPhase 2の座標
+// Phase 1の完成状態に至る移動を，Cubeを動かさずにMoveTableで追跡して，Phase 2の序数を求める
+// (Up層・Down層のEdgeの順列とMiddle層のEdgeの順列はPhase 2の移動でしか定義されないので，全ての移動で定義される座標を使う)
+
+// Up層・Down層の8個のEdgeのうち，p_firstEdgeから連続する3個のEdgeの位置のMoveTable
+// UF,UL,UBの組とUR,DF,DLの組の2つを使い，残りのDB,DRの位置は順列の偶奇から決める
+class CUpDownEdgeSplitMoveTable : public CBasicMoveTable<CUpDownEdgeSplitMoveTable, uint16_t, COrdinalCube::UpDownEdgeSplitPositions, false>
 {
 public:
-	CCornerPermutationMoveTable(COrdinalCube& cube)
-		: CMoveTable(cube, COrdinalCube::CornerPermutations, true),TheCube(cube)
+	CUpDownEdgeSplitMoveTable(COrdinalCube& cube, const int p_firstEdge)
+		: CBasicMoveTable(cube),TheCube(cube),m_firstEdge(p_firstEdge)
 	{
 
 	}
-private:
+	// CBasicMoveTableから呼び出す
 	inline int GetOrdinalFromCubeState() const
-		{ return TheCube.GetOrdinalFromCornerPermutation(); }
+		{ return TheCube.GetOrdinalFromEdgeSubsetPositions(m_firstEdge, COrdinalCube::UpDownEdgeSplitSize); }
 	inline void SetCubeStateFromOrdinal(const int p_ordinal)
-		{ TheCube.SetCornerPermutationFromOrdinal(p_ordinal); }
+		{ TheCube.SetEdgeSubsetPositionsFromOrdinal(p_ordinal, m_firstEdge, COrdinalCube::UpDownEdgeSplitSize); }
+private:
 	COrdinalCube& TheCube;
+	int m_firstEdge;
 };
 
-class CUpDownEdgePermutationMoveTable : public CMoveTable
+// Middle層の4個のEdgeの位置(順番を含む)のMoveTable
+class CMiddleEdgePositionsMoveTable : public CBasicMoveTable<CMiddleEdgePositionsMoveTable, uint16_t, COrdinalCube::MiddleEdgePositions, false>
 {
 public:
-	CUpDownEdgePermutationMoveTable(COrdinalCube& cube)
-		: CMoveTable(cube, COrdinalCube::UpDownEdgePermutations, true),TheCube(cube)
+	CMiddleEdgePositionsMoveTable(COrdinalCube& cube)
+		: CBasicMoveTable(cube),TheCube(cube)
 	{
 
 	}
-private:
+	// CBasicMoveTableから呼び出す
 	inline int GetOrdinalFromCubeState() const
-		{ return TheCube.GetOrdinalFromUpDownEdgePermutation(); }
+		{ return TheCube.GetOrdinalFromEdgeSubsetPositions(CCube::FirstMiddleEdgeSet, 4); }
 	inline void SetCubeStateFromOrdinal(const int p_ordinal)
-		{ TheCube.SetUpDownEdgePermutationFromOrdinal(p_ordinal); }
+		{ TheCube.SetEdgeSubsetPositionsFromOrdinal(p_ordinal, CCube::FirstMiddleEdgeSet, 4); }
+private:
 	COrdinalCube& TheCube;
 };
 
-class CMiddleEdgePermutationMoveTable : public CMoveTable
+// 最適解探索
+
+// p_firstEdgeから連続する6個のEdgeの位置のMoveTable
+// 移動後の位置の序数を6ビット左シフトし，下位6ビットに移動で反転したEdgeを格納する
+// (移動前のOrientationは全て0なので，移動後のOrientationが反転したEdgeを表す)
+// 値が65536以上になるので，1要素4byteのTableを用いる
+class CEdgeSubsetMoveTable : public CBasicMoveTable<CEdgeSubsetMoveTable, uint32_t, COrdinalCube::EdgeSubsetPositions, false>
 {
 public:
-	CMiddleEdgePermutationMoveTable(COrdinalCube& cube)
-		: CMoveTable(cube, COrdinalCube::MiddleEdgePermutations, true),TheCube(cube)
+	CEdgeSubsetMoveTable(COrdinalCube& cube, const int p_firstEdge)
+		: CBasicMoveTable(cube),TheCube(cube),m_firstEdge(p_firstEdge)
 	{
-	
+
 	}
-private:
+	// CBasicMoveTableから呼び出す
 	inline int GetOrdinalFromCubeState() const
-		{ return TheCube.GetOrdinalFromMiddleEdgePermutation(); }
+		{ return (TheCube.GetOrdinalFromEdgeSubsetPositions(m_firstEdge) << COrdinalCube::EdgeSubsetSize)
+			| TheCube.GetEdgeSubsetOrientations(m_firstEdge); }
 	inline void SetCubeStateFromOrdinal(const int p_ordinal)
-		{ TheCube.SetMiddleEdgePermutationFromOrdinal(p_ordinal); }
+		{ TheCube.SetEdgeSubsetPositionsFromOrdinal(p_ordinal, m_firstEdge); }
+private:
 	COrdinalCube& TheCube;
+	int m_firstEdge;
 };
+
+#endif	// _SUBMOVETABLE_H_
@@ -0,0 +1,121 @@
+﻿#include "symmetry.h"
+
+#include <mutex>
+
+CCube CSymmetry::SymmetryCubes[NumberOfSymmetries];
+int CSymmetry::InverseSymmetries[NumberOfSymmetries];
+int CSymmetry::ConjugateMoves[NumberOfSymmetries][CCube::NumberOfMoves];
+
+// 対称変換のTableを作成する
+// 複数回・複数のスレッドから呼び出しても作成は1回だけ行う
+void CSymmetry::Initialize()
+{
+	static std::once_flag initialized;
+	std::call_once(initialized, GenerateTables);
+}
+
+// Cubeを対称変換する (cube = S * cube * S^-1)
+void CSymmetry::Conjugate(const int p_symmetry, CCube& cube)
+{
+	CCube conjugated = SymmetryCubes[p_symmetry];
+	conjugated.Multiply(cube);
+	conjugated.Multiply(SymmetryCubes[InverseSymmetries[p_symmetry]]);
+	cube.SetState(
+		conjugated.GetCornerPermutation(), conjugated.GetCornerOrientations(),
+		conjugated.GetEdgePermutation(), conjugated.GetEdgeOrientations());
+}
+
+// Tableを作成する
+void CSymmetry::GenerateTables()
+{
+	enum { URF3, F2, U4, LR2 };
+	CCube basic[4];
+	for (int i = URF3; i <= LR2; i++) {
+		basic[i].SetState(
+			BasicCornerPermutations[i], BasicCornerOrientations[i],
+			BasicEdgePermutations[i], BasicEdgeOrientations[i]);
+	}
+
+	// 48種類の対称変換を基本対称変換の積で作成する
+	// 番号 = 16 * URF3 + 8 * F2 + 2 * U4 + LR2
+	CCube cube;
+	for (int symmetry = 0; symmetry < NumberOfSymmetries; symmetry++) {
+		SymmetryCubes[symmetry] = cube;
+		cube.Multiply(basic[LR2]);
+		if (symmetry % 2 == 1) cube.Multiply(basic[U4]);
+		if (symmetry % 8 == 7) cube.Multiply(basic[F2]);
+		if (symmetry % 16 == 15) cube.Multiply(basic[URF3]);
+	}
+
+	// 逆変換を探す
+	CCube clean;
+	for (int symmetry = 0; symmetry < NumberOfSymmetries; symmetry++) {
+		for (int inverse = 0; inverse < NumberOfSymmetries; inverse++) {
+			CCube product = SymmetryCubes[symmetry];
+			product.Multiply(SymmetryCubes[inverse]);
+			if (product == clean) {
+				InverseSymmetries[symmetry] = inverse;
+				break;
+			}
+		}
+	}
+
+	// 各移動を対称変換した移動を探す
+	CCube moveCubes[CCube::NumberOfMoves];
+	for (int move = CCube::U; move < CCube::NumberOfMoves; move++) {
+		moveCubes[move].ApplyMove(move);
+	}
+	for (int symmetry = 0; symmetry < NumberOfSymmetries; symmetry++) {
+		for (int move = CCube::U; move < CCube::NumberOfMoves; move++) {
+			CCube conjugated = moveCubes[move];
+			Conjugate(symmetry, conjugated);
+			for (int move2 = CCube::U; move2 < CCube::NumberOfMoves; move2++) {
+				if (conjugated == moveCubes[move2]) {
+					ConjugateMoves[symmetry][move] = move2;
+					break;
+				}
+			}
+		}
+	}
+}
+
+// 基本対称変換のPermutation
+// Cornerの番号は CCube::CornerSet, Edgeの番号は CCube::EdgeSet
+// CornerのOrientationが3以上のものは鏡映された回転状態
+const int CSymmetry::BasicCornerPermutations[4][CCube::NumberOfCornerSets] =
+{
+	{ CCube::URF, CCube::DFR, CCube::DLF, CCube::UFL, CCube::UBR, CCube::DRB, CCube::DBL, CCube::ULB },	// URF3
+	{ CCube::DLF, CCube::DFR, CCube::DRB, CCube::DBL, CCube::UFL, CCube::URF, CCube::UBR, CCube::ULB },	// F2
+	{ CCube::UBR, CCube::URF, CCube::UFL, CCube::ULB, CCube::DRB, CCube::DFR, CCube::DLF, CCube::DBL },	// U4
+	{ CCube::UFL, CCube::URF, CCube::UBR, CCube::ULB, CCube::DLF, CCube::DFR, CCube::DRB, CCube::DBL }	// LR2
+};
+
+// 基本対称変換のCornerのOrientation
+const int CSymmetry::BasicCornerOrientations[4][CCube::NumberOfCornerSets] =
+{
+	{ 2, 1, 2, 1, 1, 2, 1, 2 },	// URF3
+	{ 0, 0, 0, 0, 0, 0, 0, 0 },	// F2
+	{ 0, 0, 0, 0, 0, 0, 0, 0 },	// U4
+	{ 3, 3, 3, 3, 3, 3, 3, 3 }	// LR2
+};
+
+// 基本対称変換のEdgeのPermutation
+const int CSymmetry::BasicEdgePermutations[4][CCube::NumberOfEdgeSets] =
+{
+	{ CCube::RF, CCube::DF, CCube::FL, CCube::UF, CCube::RB, CCube::DB, CCube::LB, CCube::UB, CCube::UR, CCube::DR, CCube::DL, CCube::UL },	// URF3
+	{ CCube::DF, CCube::DR, CCube::DB, CCube::DL, CCube::UF, CCube::UR, CCube::UB, CCube::UL, CCube::FL, CCube::RF, CCube::RB, CCube::LB },	// F2
+	{ CCube::UR, CCube::UF, CCube::UL, CCube::UB, CCube::DR, CCube::DF, CCube::DL, CCube::DB, CCube::RB, CCube::RF, CCube::FL, CCube::LB },	// U4
+	{ CCube::UF, CCube::UR, CCube::UB, CCube::UL, CCube::DF, CCube::DR, CCube::DB, CCube::DL, CCube::FL, CCube::RF, CCube::RB, CCube::LB }	// LR2
+};
+
+// 基本対称変換のEdgeのOrientation
+// Up層・Down層のEdgeはU,D面，Middle層のEdgeはR,L面を基準にして反転を表すので，
+// U-D軸周りの90[deg]回転ではMiddle層のEdgeが反転する
+// URF3は全Edgeを反転したものも対称変換として働くが，URF3^3 = Iとなる方を用いる
+const int CSymmetry::BasicEdgeOrientations[4][CCube::NumberOfEdgeSets] =
+{
+	{ 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0 },	// URF3
+	{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },	// F2
+	{ 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1 },	// U4
+	{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }	// LR2
+};
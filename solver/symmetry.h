@@ -0,0 +1,78 @@
+﻿#ifndef	_SYMMETRY_H_
+#define	_SYMMETRY_H_
+
+#include "cube.h"
+
+// Cube全体の対称変換(回転・鏡映)を扱うクラス
+// http://kociemba.org/math/symmetric.htm
+// 48種類の対称変換は，4種類の基本対称変換の積で表現する
+//   URF3 : URF-DBLの対角線周りの120[deg]回転 (3通り)
+//   F2   : F-B軸周りの180[deg]回転 (2通り)
+//   U4   : U-D軸周りの90[deg]回転 (4通り)
+//   LR2  : L-R方向の鏡映 (2通り)
+// 対称変換の番号は 16 * URF3 + 8 * F2 + 2 * U4 + LR2 とする
+// 0 - 15 番はU-D軸を保存する対称変換になる
+class CSymmetry
+{
+public:
+	enum
+	{
+		NumberOfSymmetries = 48,	// 対称変換の数
+		NumberOfUpDownSymmetries = 16,	// U-D軸を保存する対称変換の数
+		NumberOfAxes = 3	// URF3で移り合う軸の数(U-D, F-B, R-L)
+	};
+
+	// 対称変換のTableを作成する
+	// 複数回・複数のスレッドから呼び出しても作成は1回だけ行う
+	static void Initialize();
+
+	// 対称変換を表すCubeを取得する
+	static const CCube& GetSymmetryCube(const int p_symmetry)
+	{
+		return SymmetryCubes[p_symmetry];
+	}
+
+	// 逆変換の番号を取得する
+	static int GetInverseSymmetry(const int p_symmetry)
+	{
+		return InverseSymmetries[p_symmetry];
+	}
+
+	// 移動を対称変換した移動を取得する (S * move * S^-1)
+	static int ConjugateMove(const int p_symmetry, const int p_move)
+	{
+		return ConjugateMoves[p_symmetry][p_move];
+	}
+
+	// U-D軸をp_axis回だけURF3で移す対称変換の番号を取得する
+	static int GetAxisSymmetry(const int p_axis)
+	{
+		return 16 * p_axis;
+	}
+
+	// Cubeを対称変換する (cube = S * cube * S^-1)
+	// 変換後のCubeの解法の各移動をConjugateMove(GetInverseSymmetry(p_symmetry), move)で
+	// 変換すると，変換前のCubeの解法になる
+	static void Conjugate(const int p_symmetry, CCube& cube);
+
+private:
+	// Tableを作成する
+	static void GenerateTables();
+
+	// 対称変換を表すCube
+	static CCube SymmetryCubes[NumberOfSymmetries];
+	// 逆変換の番号
+	static int InverseSymmetries[NumberOfSymmetries];
+	// 対称変換した移動
+	static int ConjugateMoves[NumberOfSymmetries][CCube::NumberOfMoves];
+
+	// 基本対称変換のPermutationとOrientation
+	// Corner:URF, UFL, ULB, UBR, DFR, DLF, DBL, DRB
+	// Edge  :UF, UL, UB, UR, DF, DL, DB, DR, RF, LF, LB, RB
+	static const int BasicCornerPermutations[4][CCube::NumberOfCornerSets];
+	static const int BasicCornerOrientations[4][CCube::NumberOfCornerSets];
+	static const int BasicEdgePermutations[4][CCube::NumberOfEdgeSets];
+	static const int BasicEdgeOrientations[4][CCube::NumberOfEdgeSets];
+};
+
+#endif	// _SYMMETRY_H_
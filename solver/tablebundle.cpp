@@ -0,0 +1,276 @@
+﻿#include "tablebundle.h"
+#include "tablefile.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include <chrono>
+
+const std::string CTableBundle::DefaultFileName = "CubeSolverTables.bundle";
+const std::string CTableBundle::DefaultSharedMemoryKey = "CubeSolverTables-" + std::to_string(CTableFile::FormatVersion);
+
+CTableBundle::CTableBundle()
+	: m_mappedFile(NULL),
+	m_sharedMemory(NULL),
+	m_base(NULL),
+	m_fileBytes(0),
+	m_entries(NULL),
+	m_numberOfEntries(0)
+{
+	static_assert(sizeof(SHeader) <= HeaderSize, "SHeader must fit in HeaderSize");
+	static_assert(sizeof(SEntry) == 64, "SEntry must be 64 bytes");
+}
+
+CTableBundle::~CTableBundle()
+{
+	if (m_mappedFile) {
+		m_mappedFile->unmap(m_base);
+		delete m_mappedFile;
+	}
+	// 最後に切断したプロセスで共有メモリが解放される
+	delete m_sharedMemory;
+}
+
+// バンドルのファイルをメモリマップして，ヘッダと目次を確認する
+CTableBundle::Status CTableBundle::Open(const std::string& p_fileName)
+{
+	if (IsOpen()) {
+		return Loaded;
+	}
+
+	QFile* file = new QFile(QString::fromStdString(p_fileName));
+	if (!file->exists() || !file->open(QIODevice::ReadOnly)) {
+		delete file;
+		return NotFound;
+	}
+	const qint64 fileBytes = file->size();
+	if (fileBytes < HeaderSize) {
+		delete file;
+		return Invalid;
+	}
+	unsigned char* base = file->map(0, fileBytes);
+	if (base == NULL) {
+		delete file;
+		return Invalid;
+	}
+
+	Status status = Attach(base, fileBytes);
+	if (status != Loaded) {
+		file->unmap(base);
+		delete file;
+		return status;
+	}
+	m_mappedFile = file;
+	return Loaded;
+}
+
+// 名前付き共有メモリのバンドルを開く
+CTableBundle::Status CTableBundle::OpenShared(const std::string& p_fileName, const std::string& p_key)
+{
+	if (IsOpen()) {
+		return Loaded;
+	}
+
+	QSharedMemory* sharedMemory = new QSharedMemory(QString::fromStdString(p_key));
+	// 既に他のプロセスが作成していれば，読み出し専用で接続する
+	if (!sharedMemory->attach(QSharedMemory::ReadOnly)) {
+		// 最初のプロセスはバンドルのファイルを共有メモリにコピーする
+		Status status = CreateSharedMemory(sharedMemory, p_fileName);
+		if (status != Loaded) {
+			delete sharedMemory;
+			return status;
+		}
+	}
+
+	// 作成したプロセスがコピーを終えるまで待つ(ヘッダはコピーの最後に書き込まれる)
+	const unsigned char* base = (const unsigned char*)sharedMemory->constData();
+	SHeader header;
+	for (int retry = 0; ; retry++) {
+		sharedMemory->lock();
+		std::memcpy(&header, base, sizeof(header));
+		sharedMemory->unlock();
+		if (header.magic == Magic || retry >= SharedMemoryRetries) {
+			break;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+
+	// 共有メモリは読み出し専用として扱う(Tableは書き換えない)
+	Status status = Attach(const_cast<unsigned char*>(base), sharedMemory->size());
+	if (status != Loaded) {
+		delete sharedMemory;
+		return status;
+	}
+	m_sharedMemory = sharedMemory;
+	return Loaded;
+}
+
+// メモリ上のバンドルのヘッダと目次を確認して，このバンドルとして使用する
+CTableBundle::Status CTableBundle::Attach(unsigned char* p_base, const uint64_t p_bytes)
+{
+	if (p_bytes < HeaderSize) {
+		return Invalid;
+	}
+
+	// ヘッダを確認する
+	// (共有メモリはページ単位で確保されるので，ファイルより大きいことがある)
+	SHeader header;
+	std::memcpy(&header, p_base, sizeof(header));
+	if (header.magic != Magic || header.fileBytes < HeaderSize || header.fileBytes > p_bytes) {
+		return Invalid;
+	}
+	if (header.version != CTableFile::FormatVersion) {
+		return VersionMismatch;
+	}
+	if (HeaderSize + (uint64_t)header.numberOfEntries * sizeof(SEntry) > header.fileBytes) {
+		return Invalid;
+	}
+
+	// 目次の各項目がファイルの範囲内にあるか確認する
+	const SEntry* entries = (const SEntry*)(p_base + HeaderSize);
+	for (uint32_t i = 0; i < header.numberOfEntries; i++) {
+		if (entries[i].offset > header.fileBytes || entries[i].bytes > header.fileBytes - entries[i].offset
+			|| entries[i].name[NameSize - 1] != '\0') {
+			return Invalid;
+		}
+	}
+
+	m_base = p_base;
+	m_fileBytes = header.fileBytes;
+	m_entries = entries;
+	m_numberOfEntries = header.numberOfEntries;
+	return Loaded;
+}
+
+// 共有メモリを作成して，バンドルのファイルをコピーする
+CTableBundle::Status CTableBundle::CreateSharedMemory(QSharedMemory* p_sharedMemory, const std::string& p_fileName)
+{
+	QFile file(QString::fromStdString(p_fileName));
+	if (!file.exists() || !file.open(QIODevice::ReadOnly)) {
+		return NotFound;
+	}
+	const qint64 fileBytes = file.size();
+	if (fileBytes < HeaderSize) {
+		return Invalid;
+	}
+
+	if (!p_sharedMemory->create(fileBytes)) {
+		// 同時に起動した他のプロセスが先に作成したときは，そちらに接続する
+		return p_sharedMemory->attach(QSharedMemory::ReadOnly) ? Loaded : Invalid;
+	}
+
+	// ヘッダは最後に書き込む(接続したプロセスはヘッダが書き込まれるまで待つ)
+	p_sharedMemory->lock();
+	char* data = (char*)p_sharedMemory->data();
+	bool isCopied = file.seek(HeaderSize)
+		&& file.read(data + HeaderSize, fileBytes - HeaderSize) == fileBytes - HeaderSize
+		&& file.seek(0)
+		&& file.read(data, HeaderSize) == HeaderSize;
+	p_sharedMemory->unlock();
+	return isCopied ? Loaded : Invalid;
+}
+
+// Tableのファイル名からバンドル内のファイルの内容を取得する
+bool CTableBundle::Find(const std::string& p_name, const unsigned char*& p_image, uint64_t& p_bytes) const
+{
+	for (uint32_t i = 0; i < m_numberOfEntries; i++) {
+		if (p_name == m_entries[i].name) {
+			p_image = m_base + m_entries[i].offset;
+			p_bytes = m_entries[i].bytes;
+			return true;
+		}
+	}
+	return false;
+}
+
+// Tableのファイルをまとめてバンドルを作成する
+bool CTableBundle::Write(const std::string& p_fileName, const std::vector<std::string>& p_tableFileNames)
+{
+	// 同じファイル名は1回だけ格納する
+	std::vector<std::string> names;
+	for (size_t i = 0; i < p_tableFileNames.size(); i++) {
+		bool isDuplicated = false;
+		for (size_t j = 0; j < names.size(); j++) {
+			isDuplicated |= (names[j] == p_tableFileNames[i]);
+		}
+		if (!isDuplicated) {
+			if (p_tableFileNames[i].size() >= NameSize) {
+				return false;
+			}
+			names.push_back(p_tableFileNames[i]);
+		}
+	}
+
+	// 各Tableのファイルのサイズから目次を作成する
+	std::vector<SEntry> entries(names.size());
+	uint64_t offset = Align(HeaderSize + names.size() * sizeof(SEntry));
+	for (size_t i = 0; i < names.size(); i++) {
+		std::ifstream input(names[i], std::ios::in | std::ios::binary | std::ios::ate);
+		if (!input) {
+			return false;
+		}
+		std::memset(&entries[i], 0, sizeof(SEntry));
+		std::strncpy(entries[i].name, names[i].c_str(), NameSize - 1);
+		entries[i].offset = offset;
+		entries[i].bytes = (uint64_t)input.tellg();
+		offset = Align(offset + entries[i].bytes);
+	}
+
+	unsigned char header[HeaderSize];
+	SHeader bundleHeader;
+	std::memset(header, 0, sizeof(header));
+	bundleHeader.magic = Magic;
+	bundleHeader.version = CTableFile::FormatVersion;
+	bundleHeader.numberOfEntries = (uint32_t)names.size();
+	bundleHeader.reserved = 0;
+	bundleHeader.fileBytes = offset;
+	std::memcpy(header, &bundleHeader, sizeof(bundleHeader));
+
+	// 一時ファイルに書き込んでから置き換える
+	const std::string tempFileName = p_fileName + ".tmp";
+	std::ofstream output(tempFileName, std::ios::out | std::ios::binary);
+	const char padding[64] = {0};
+	output.write((const char*)header, HeaderSize);
+	output.write((const char*)entries.data(), entries.size() * sizeof(SEntry));
+	uint64_t position = HeaderSize + entries.size() * sizeof(SEntry);
+	for (size_t i = 0; i < names.size(); i++) {
+		output.write(padding, entries[i].offset - position);
+		// 数十MBのTableもあるので，少しずつコピーする
+		std::ifstream input(names[i], std::ios::in | std::ios::binary);
+		std::vector<char> buffer(1 << 20);
+		uint64_t copiedBytes = 0;
+		while (input && copiedBytes < entries[i].bytes) {
+			input.read(buffer.data(), buffer.size());
+			output.write(buffer.data(), input.gcount());
+			copiedBytes += input.gcount();
+		}
+		if (copiedBytes != entries[i].bytes) {
+			output.setstate(std::ios::failbit);
+		}
+		position = entries[i].offset + entries[i].bytes;
+	}
+	output.write(padding, offset - position);
+	output.close();
+	if (!output) {
+		std::remove(tempFileName.c_str());
+		return false;
+	}
+	std::remove(p_fileName.c_str());
+	return std::rename(tempFileName.c_str(), p_fileName.c_str()) == 0;
+}
+
+// Openの結果のメッセージ
+std::string CTableBundle::GetStatusText(const Status p_status)
+{
+	switch (p_status) {
+	case Loaded:
+		return "Table bundle was loaded.";
+	case NotFound:
+		return "Table bundle was not found.";
+	case VersionMismatch:
+		return "Table bundle version does not match. Regenerate it with TableGenerator.";
+	default:
+		return "Table bundle is corrupted. Regenerate it with TableGenerator.";
+	}
+}
@@ -0,0 +1,109 @@
+﻿#ifndef	_TABLEBUNDLE_H_
+#define	_TABLEBUNDLE_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <QFile>
+#include <QSharedMemory>
+
+// 全てのMoveTable,PruningTableを1つにまとめたファイル(バンドル)
+// 配布用にTableGeneratorで事前に作成し，起動時に1回だけメモリマップする
+// 1台で複数のCubeSolverを起動するときは，名前付き共有メモリにバンドルを置いて全てのプロセスで共有できる
+// ファイルの構成:
+//   ヘッダ(形式のバージョン，Tableの数)
+//   目次(Tableのファイル名，バンドル内の位置とサイズ)
+//   各Tableのファイルの内容(CTableFileのヘッダ + データ，64byte境界に揃える)
+class CTableBundle
+{
+public:
+	enum
+	{
+		Magic = 0x44425343,	// "CSBD"
+		HeaderSize = 64,	// ヘッダのサイズ(byte)
+		NameSize = 48,	// 目次のTableのファイル名の最大の長さ(終端を含む)
+		SharedMemoryRetries = 3000	// 共有メモリへのコピーが終わるのを待つ回数(10ms間隔)
+	};
+
+	// Openの結果
+	enum Status
+	{
+		Loaded,	// 読み込めた
+		NotFound,	// ファイルが無い
+		VersionMismatch,	// 形式のバージョンが異なる(TableGeneratorで作成し直す必要がある)
+		Invalid	// ファイルが壊れている
+	};
+
+	// 標準のバンドルのファイル名
+	static const std::string DefaultFileName;
+	// 標準の共有メモリの名前(形式のバージョンごとに異なる名前にする)
+	static const std::string DefaultSharedMemoryKey;
+
+	CTableBundle();
+	~CTableBundle();
+
+	// バンドルのファイルをメモリマップして，ヘッダと目次を確認する
+	// 各Tableのヘッダとチェックサムは，CTableFile::OpenでTableごとに確認する
+	Status Open(const std::string& p_fileName);
+
+	// 名前付き共有メモリのバンドルを開く
+	// 共有メモリが無ければ(最初のプロセスでは)バンドルのファイルを共有メモリにコピーし，
+	// 既にあれば(以降のプロセスでは)読み出し専用で接続する
+	// 共有メモリは接続している全てのプロセスが終了すると解放される
+	Status OpenShared(const std::string& p_fileName, const std::string& p_key);
+
+	// バンドルを開いているか
+	bool IsOpen() const { return m_base != NULL; }
+
+	// Tableのファイル名からバンドル内のファイルの内容を取得する
+	// 見つからなければfalse
+	bool Find(const std::string& p_name, const unsigned char*& p_image, uint64_t& p_bytes) const;
+
+	// Tableのファイルをまとめてバンドルを作成する(同じファイル名は1回だけ格納する)
+	static bool Write(const std::string& p_fileName, const std::vector<std::string>& p_tableFileNames);
+
+	// Openの結果のメッセージ
+	static std::string GetStatusText(const Status p_status);
+
+private:
+	// バンドルの先頭に保存するヘッダ
+	struct SHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t numberOfEntries;
+		uint32_t reserved;
+		uint64_t fileBytes;
+	};
+
+	// 目次の1項目
+	struct SEntry
+	{
+		char name[NameSize];
+		uint64_t offset;
+		uint64_t bytes;
+	};
+
+	// メモリ上のバンドルのヘッダと目次を確認して，このバンドルとして使用する
+	Status Attach(unsigned char* p_base, const uint64_t p_bytes);
+
+	// 共有メモリを作成して，バンドルのファイルをコピーする
+	static Status CreateSharedMemory(QSharedMemory* p_sharedMemory, const std::string& p_fileName);
+
+	// 64byte境界に切り上げる
+	static uint64_t Align(const uint64_t p_bytes) { return (p_bytes + 63) & ~(uint64_t)63; }
+
+	// マップしたファイル(共有メモリのときはNULL)
+	QFile* m_mappedFile;
+	// 接続した共有メモリ(ファイルのときはNULL)
+	QSharedMemory* m_sharedMemory;
+	// ファイルの先頭アドレス
+	unsigned char* m_base;
+	// ファイルのサイズ(byte)
+	uint64_t m_fileBytes;
+	// 目次
+	const SEntry* m_entries;
+	uint32_t m_numberOfEntries;
+};
+
+#endif	// _TABLEBUNDLE_H_
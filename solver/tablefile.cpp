@@ -0,0 +1,186 @@
+﻿#include "tablefile.h"
+#include "tablebundle.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+// Tableの寸法を設定する
+CTableFile::CTableFile(const uint32_t p_rows, const uint32_t p_columns, const uint32_t p_entryBits, const uint64_t p_dataBytes)
+	: m_mappedFile(NULL),
+	m_base(NULL),
+	m_heap(NULL),
+	m_data(NULL)
+{
+	static_assert(sizeof(SHeader) <= HeaderSize, "SHeader must fit in HeaderSize");
+
+	std::memset(&m_header, 0, sizeof(m_header));
+	m_header.magic = Magic;
+	m_header.version = FormatVersion;
+	m_header.rows = p_rows;
+	m_header.columns = p_columns;
+	m_header.entryBits = p_entryBits;
+	m_header.dataBytes = p_dataBytes;
+}
+
+CTableFile::~CTableFile()
+{
+	Release();
+}
+
+// ファイルをメモリマップして，ヘッダとチェックサムを確認する
+CTableFile::Status CTableFile::Open(const std::string& p_fileName)
+{
+	Release();
+
+	QFile* file = new QFile(QString::fromStdString(p_fileName));
+	if (!file->exists() || !file->open(QIODevice::ReadOnly)) {
+		delete file;
+		return NotFound;
+	}
+
+	// サイズが異なるファイル(途中で切れたファイル，ヘッダの無い古い形式のファイル)はマップしない
+	const qint64 fileBytes = HeaderSize + (qint64)m_header.dataBytes;
+	if (file->size() != fileBytes) {
+		delete file;
+		return Invalid;
+	}
+
+	m_base = file->map(0, fileBytes);
+	if (m_base != NULL) {
+		m_mappedFile = file;
+	}
+	else {
+		// マップできなかったときはヒープに読み込む
+		Allocate();
+		file->seek(0);
+		bool isRead = (file->read((char*)m_base, fileBytes) == fileBytes);
+		delete file;
+		if (!isRead) {
+			Release();
+			return Invalid;
+		}
+	}
+	m_data = m_base + HeaderSize;
+
+	if (!IsValid()) {
+		Release();
+		return Invalid;
+	}
+	return Loaded;
+}
+
+// バンドルの中のTableのファイルのヘッダとチェックサムを確認して使用する
+CTableFile::Status CTableFile::Open(const CTableBundle& p_bundle, const std::string& p_name)
+{
+	Release();
+
+	const unsigned char* image;
+	uint64_t bytes;
+	if (!p_bundle.Find(p_name, image, bytes)) {
+		return NotFound;
+	}
+	if (bytes != HeaderSize + m_header.dataBytes) {
+		return Invalid;
+	}
+
+	// バンドルのマップは読み出し専用(Tableは書き換えない)
+	m_base = const_cast<unsigned char*>(image);
+	m_data = m_base + HeaderSize;
+	if (!IsValid()) {
+		Release();
+		return Invalid;
+	}
+	return Loaded;
+}
+
+// Tableを作成するためのメモリをヒープに確保する
+unsigned char* CTableFile::Allocate()
+{
+	Release();
+
+	m_heap = new uint64_t[(HeaderSize + m_header.dataBytes + 7) / 8];
+	m_base = (unsigned char*)m_heap;
+	m_data = m_base + HeaderSize;
+	return m_data;
+}
+
+// データにヘッダを付けてファイルに保存する
+bool CTableFile::Save(const std::string& p_fileName)
+{
+	if (m_heap == NULL) {
+		return false;
+	}
+
+	SHeader header = m_header;
+	header.checksum = Checksum(m_data, m_header.dataBytes);
+	std::memset(m_base, 0, HeaderSize);
+	std::memcpy(m_base, &header, sizeof(header));
+
+	const std::string tempFileName = p_fileName + ".tmp";
+	std::ofstream output(tempFileName, std::ios::out | std::ios::binary);
+	output.write((const char*)m_base, HeaderSize + m_header.dataBytes);
+	output.close();
+	if (!output) {
+		std::remove(tempFileName.c_str());
+		return false;
+	}
+
+	// 書き込みが完了してから置き換える
+	std::remove(p_fileName.c_str());
+	return std::rename(tempFileName.c_str(), p_fileName.c_str()) == 0;
+}
+
+// データのチェックサム
+// FNV-1aを64bitのwordごとに適用する(1byteごとより速く，数百MBのTableでも起動時に確認できる)
+uint64_t CTableFile::Checksum(const unsigned char* p_data, const uint64_t p_bytes)
+{
+	const uint64_t prime = 0x100000001b3ULL;
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	uint64_t i = 0;
+
+	for (; i + 8 <= p_bytes; i += 8) {
+		uint64_t word;
+		std::memcpy(&word, p_data + i, sizeof(word));
+		hash = (hash ^ word) * prime;
+		// 乗算は上位bitにしか伝わらないので，上位bitを下位bitに混ぜる
+		hash ^= hash >> 32;
+	}
+	for (; i < p_bytes; i++) {
+		hash = (hash ^ p_data[i]) * prime;
+	}
+	return hash;
+}
+
+// マップしたファイルまたはヒープを解放する
+void CTableFile::Release()
+{
+	if (m_mappedFile) {
+		m_mappedFile->unmap(m_base);
+		delete m_mappedFile;
+		m_mappedFile = NULL;
+	}
+	delete [] m_heap;
+	m_heap = NULL;
+	m_base = NULL;
+	m_data = NULL;
+}
+
+// ヘッダとチェックサムを確認する
+bool CTableFile::IsValid() const
+{
+	SHeader header;
+	std::memcpy(&header, m_base, sizeof(header));
+	return IsSameFormat(header) && header.checksum == Checksum(m_data, m_header.dataBytes);
+}
+
+// ヘッダの値を読み込んだファイルと比較する(チェックサム以外)
+bool CTableFile::IsSameFormat(const SHeader& p_header) const
+{
+	return p_header.magic == m_header.magic
+		&& p_header.version == m_header.version
+		&& p_header.rows == m_header.rows
+		&& p_header.columns == m_header.columns
+		&& p_header.entryBits == m_header.entryBits
+		&& p_header.dataBytes == m_header.dataBytes;
+}
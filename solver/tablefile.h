@@ -0,0 +1,97 @@
+﻿#ifndef	_TABLEFILE_H_
+#define	_TABLEFILE_H_
+
+#include <string>
+#include <cstdint>
+#include <QFile>
+
+class CTableBundle;
+
+// Tableのファイル(ヘッダ + データ)の読み込み・保存を行うクラス
+// ファイルは読み出し専用でメモリマップするので，起動時にデータをコピーせず，
+// 複数のプロセスでOSのページキャッシュを共有する
+// ヘッダ(形式のバージョン，Tableの寸法，チェックサム)が一致しないファイルは読み込まない
+// (古い形式のファイル，途中で書き込みが止まったファイル，壊れたファイルは作成し直す)
+class CTableFile
+{
+public:
+	enum
+	{
+		Magic = 0x42545343,	// "CSTB"
+		FormatVersion = 2,	// Tableの形式を変えたら増やす
+		HeaderSize = 64	// データを64byte境界に揃えるためのヘッダのサイズ(byte)
+	};
+
+	// Openの結果
+	enum Status
+	{
+		Loaded,	// ヘッダとチェックサムが一致した
+		NotFound,	// ファイルが無い
+		Invalid	// ヘッダかチェックサムが一致しない
+	};
+
+	// Tableの寸法を設定する(ファイルのヘッダと比較する)
+	// p_rows : 序数の数, p_columns : 1つの序数あたりの要素の数
+	// p_entryBits : 1要素のサイズ(bit), p_dataBytes : データのサイズ(byte)
+	CTableFile(const uint32_t p_rows, const uint32_t p_columns, const uint32_t p_entryBits, const uint64_t p_dataBytes);
+	~CTableFile();
+
+	// ファイルをメモリマップして，ヘッダとチェックサムを確認する
+	// マップできないときはヒープに読み込む
+	Status Open(const std::string& p_fileName);
+
+	// バンドルの中のTableのファイル(p_nameはTableのファイル名)のヘッダとチェックサムを確認して使用する
+	// データはバンドルのマップを直接参照する
+	Status Open(const CTableBundle& p_bundle, const std::string& p_name);
+
+	// Tableを作成するためのメモリをヒープに確保する
+	unsigned char* Allocate();
+
+	// データにヘッダを付けてファイルに保存する
+	// 一時ファイルに書き込んでから置き換えるので，途中で終了しても壊れたファイルは残らない
+	bool Save(const std::string& p_fileName);
+
+	// データの先頭アドレス
+	unsigned char* GetData() const { return m_data; }
+	// データのサイズ(byte)
+	uint64_t GetDataBytes() const { return m_header.dataBytes; }
+
+	// データのチェックサム
+	static uint64_t Checksum(const unsigned char* p_data, const uint64_t p_bytes);
+
+private:
+	// ファイルの先頭に保存するヘッダ
+	struct SHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t rows;
+		uint32_t columns;
+		uint32_t entryBits;
+		uint32_t reserved;
+		uint64_t dataBytes;
+		uint64_t checksum;
+	};
+
+	// マップしたファイルまたはヒープを解放する
+	void Release();
+
+	// ヘッダの値を読み込んだファイルと比較する(チェックサム以外)
+	bool IsSameFormat(const SHeader& p_header) const;
+	// ヘッダとチェックサムを確認する
+	bool IsValid() const;
+
+	// このTableのヘッダ(チェックサムはSaveで設定する)
+	SHeader m_header;
+
+	// マップしたファイル(ヒープ，バンドルのときはNULL)
+	QFile* m_mappedFile;
+	// ヘッダを含むファイル全体の先頭アドレス(マップ，ヒープまたはバンドル)
+	unsigned char* m_base;
+	// ヒープに確保したときのメモリ(64bit単位で確保して境界を揃える)
+	uint64_t* m_heap;
+	// データの先頭アドレス(m_base + HeaderSize)
+	unsigned char* m_data;
+};
+
+#endif	// _TABLEFILE_H_
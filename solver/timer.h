@@ -19,11 +19,21 @@ public:
 	}
 	void start()
 	{
+		struct timespec ts;
 		timespec_get(&ts, TIME_UTC);	// システム時間を取得
 		m_startTime = ts.tv_sec * (int64_t)1E9 + ts.tv_nsec;	// ナノ秒単位のシステム時間として保存
 	}
-	bool isTimeOut()
+	// startからの経過時間[us]
+	int64_t getElapsedTime() const
 	{
+		struct timespec ts;
+		timespec_get(&ts, TIME_UTC);	// システム時間を取得
+		return (ts.tv_sec * (int64_t)1E9 + ts.tv_nsec - m_startTime) / (int64_t)1E3;
+	}
+	// 複数のスレッドから呼び出せるように，メンバ変数は変更しない
+	bool isTimeOut() const
+	{
+		struct timespec ts;
 		timespec_get(&ts, TIME_UTC);	// システム時間を取得
 		int64_t nowTime = ts.tv_sec * (int64_t)1E9 + ts.tv_nsec;	// ナノ秒単位のシステム時間として保存
 		
@@ -38,7 +48,6 @@ public:
 	}
 
 private:
-	struct timespec ts;
 	// 内部時間はナノ秒単位
 	int64_t m_timeOut;	// [ms]
 	int64_t m_startTime;	// [ms]
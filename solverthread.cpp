@@ -1,13 +1,49 @@
 #include "solverthread.h"
 
 #include "solver/idastarsearch.h"
+#include "solver/optimalsearch.h"
 #include "solver/ordinalcube.h"
 #include "solver/groupcube.h"
 #include "solver/cubeparser.h"
 
+SolverThread::SolverThread(QObject *parent)
+    : QThread(parent),
+      m_timeOut(0),
+      m_initializeOnly(false),
+      m_optimalSolve(false),
+      m_sharedTables(false),
+      m_multiLookup(false),
+      m_childOrdering(false),
+      m_bundleStatus(CTableBundle::NotFound)
+{
+    // Table connection
+    connect(&m_tables, SIGNAL(notifySolverMessage(QString)),
+            this, SLOT(onGetSolverMessage(QString)));
+    connect(&m_optimalTables, SIGNAL(notifySolverMessage(QString)),
+            this, SLOT(onGetSolverMessage(QString)));
+}
+
 // run前にsetTimeOutとsetStrCubeStateを設定する
+// 初回のみMoveTable,PruningTableを読み込む
 void SolverThread::run()
 {
+    // Tableは一度だけ読み込み，以降の解探索ではメモリ上のものを使う
+    if(!m_tables.IsInitialized()){
+        emit notifyMessage("Start to initialize the solver tables.");
+        if(!openTableBundle() || !m_tables.Initialize(getTableBundle())){
+            // バンドルが使えないときは，Tableを作成し直さずに解探索を行わない
+            emit notifySolverMessage("Failed to initialize the solver tables.");
+            if(!m_initializeOnly){
+                emit notifyCompleted(false, "");
+            }
+            return;
+        }
+        emit notifyMessage("Finish initializing the solver tables.");
+    }
+    if(m_initializeOnly){
+        return;
+    }
+
     // 解探索を開始
     emit notifyMessage("Start to solve the cube.");
 
@@ -36,15 +72,64 @@ void SolverThread::run()
         return;
     }
 
-    CIDAstarSearch idaStarSearch;
-    // Set connection
-    connect(&idaStarSearch, SIGNAL(notifySolverMessage(QString)),
-            this, SLOT(onGetSolverMessage(QString)));
-    idaStarSearch.InitializeTables();
-    idaStarSearch.Solve(ordinalCube, m_timeOut);
+    // 同じ状態のCubeの解法がキャッシュにあれば，解探索を行わずにそれを返す
+    // (Cube全体の回転・鏡映や逆元で移り合う状態も同じ状態として扱う)
+    // (同じ状態の解探索が実行中なら，その終了を待つ)
+    CSolutionCache::STransform cacheTransform;
+    const CSolutionCache::SKey cacheKey = CSolutionCache::GetKey(ordinalCube,
+        m_optimalSolve ? CSolutionCache::OptimalSearch : CSolutionCache::TwoPhaseSearch, cacheTransform);
+    bool isTableLoaded = true;
+    // (タイムアウトで打ち切った探索の解法は，より長いタイムアウトで要求されたときに探索し直す)
+    QString strSolution = QString::fromStdString(m_solutionCache.Solve(cacheKey, cacheTransform, m_timeOut, [&](bool& isCompleted) -> std::string {
+        std::string solution;
+        if(m_optimalSolve){
+            // 最適解探索のTableは一度だけ読み込む
+            if(!m_optimalTables.IsInitialized()){
+                emit notifyMessage("Start to initialize the optimal solver tables.");
+                if(!m_optimalTables.Initialize(getTableBundle())){
+                    isTableLoaded = false;
+                    return "";
+                }
+                emit notifyMessage("Finish initializing the optimal solver tables.");
+            }
 
-    emit notifySolverMessage(QString::fromStdString(idaStarSearch.GetSolution()).trimmed());
-    QString strSolution = QString::fromStdString(idaStarSearch.GetSolution()).trimmed();
+            COptimalSearch optimalSearch(m_optimalTables);
+            // Set connection
+            connect(&optimalSearch, SIGNAL(notifySolverMessage(QString)),
+                    this, SLOT(onGetSolverMessage(QString)));
+            isCompleted = (optimalSearch.Solve(ordinalCube, m_timeOut) != COptimalSearch::TIME_OUT);
+            solution = QString::fromStdString(optimalSearch.GetSolution()).trimmed().toStdString();
+        }else{
+            CIDAstarSearch idaStarSearch(m_tables);
+            // Set connection
+            connect(&idaStarSearch, SIGNAL(notifySolverMessage(QString)),
+                    this, SLOT(onGetSolverMessage(QString)));
+            // コアの半分でPhase 1を並列に探索し，残りでPhase 2をパイプライン探索する
+            int numberOfCores = QThread::idealThreadCount();
+            idaStarSearch.SetParallelSearch(numberOfCores - numberOfCores / 2, 3);
+            idaStarSearch.SetPipelinedSearch(numberOfCores / 2);
+            // 3軸とその逆元の6通りを同時に探索する(スレッド数は6つの探索で分け合う)
+            idaStarSearch.SetPortfolioSearch(true);
+            idaStarSearch.SetMultiLookupHeuristic(m_multiLookup);
+            idaStarSearch.SetChildOrdering(m_childOrdering);
+            isCompleted = (idaStarSearch.Solve(ordinalCube, m_timeOut) != CIDAstarSearch::TIME_OUT);
+            solution = QString::fromStdString(idaStarSearch.GetSolution()).trimmed().toStdString();
+        }
+        // 解けなかったときはキャッシュに保存しない
+        return (solution[0] == 'S') ? "" : solution;   // "Solution was not found"
+    }));
+    if(!isTableLoaded){
+        emit notifySolverMessage("Failed to initialize the optimal solver tables.");
+        emit notifyCompleted(false, "");
+        return;
+    }
+    if(strSolution.isEmpty()){
+        strSolution = "Solution was not found.";
+    }
+    emit notifySolverMessage(strSolution);
+    emit notifySolverMessage("Solution cache: hits = " + QString::number(m_solutionCache.GetHits())
+                             + ", misses = " + QString::number(m_solutionCache.GetMisses())
+                             + ", coalesced = " + QString::number(m_solutionCache.GetCoalesced()));
 
     emit notifyMessage("Finish solving the cube.");
 
@@ -60,3 +145,23 @@ void SolverThread::run()
         emit notifyCompleted(true, strSolution);
     }
 }
+
+// 起動時に1回だけTableのバンドルを開く
+// バンドルが無いときは，Tableごとのファイルを使う(無ければ作成する)
+// バンドルのバージョンが一致しない，または壊れているときはfalseを返す
+// (配布した環境で，解探索の途中にTableを作成し直さないようにする)
+bool SolverThread::openTableBundle()
+{
+    if(m_bundleStatus == CTableBundle::NotFound){
+        if(m_sharedTables){
+            m_bundleStatus = m_tableBundle.OpenShared(CTableBundle::DefaultFileName, CTableBundle::DefaultSharedMemoryKey);
+        }
+        else{
+            m_bundleStatus = m_tableBundle.Open(CTableBundle::DefaultFileName);
+        }
+        if(m_bundleStatus != CTableBundle::NotFound){
+            emit notifySolverMessage(QString::fromStdString(CTableBundle::GetStatusText(m_bundleStatus)));
+        }
+    }
+    return m_bundleStatus == CTableBundle::Loaded || m_bundleStatus == CTableBundle::NotFound;
+}
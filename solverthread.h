@@ -3,10 +3,23 @@
 
 #include <QThread>
 
+#include "solver/solvertables.h"
+#include "solver/optimalsolvertables.h"
+#include "solver/tablebundle.h"
+#include "solver/solutioncache.h"
+
 class SolverThread : public QThread
 {
     Q_OBJECT
 public:
+    SolverThread(QObject *parent = 0);
+
+    // trueのときはTableの読み込みだけを行い，解探索は行わない
+    // 起動時にTableを読み込んでおくために使用する
+    void setInitializeOnly(bool p_initializeOnly)
+    {
+        m_initializeOnly = p_initializeOnly;
+    }
     void setTimeOut(qint64 p_timeOut)
     {
         m_timeOut = p_timeOut;
@@ -15,6 +28,40 @@ public:
     {
         m_message = p_message;
     }
+    // trueのときはTwo Phase Algorithmの代わりに最適解探索を行う
+    // 最適解探索のTableは初めて最適解探索を行うときに読み込む
+    void setOptimalSolve(bool p_optimalSolve)
+    {
+        m_optimalSolve = p_optimalSolve;
+    }
+    // trueのときはTableのバンドルを名前付き共有メモリに置き，同時に起動した他のプロセスと共有する
+    // 最初のプロセスがバンドルをコピーし，以降のプロセスは読み出し専用で接続する
+    void setSharedTables(bool p_sharedTables)
+    {
+        m_sharedTables = p_sharedTables;
+    }
+    // trueのときはPhase 1の探索で他の軸・逆元のCubeのPruningTableも引き，今までの解法より短くならない部分木を刈り込む
+    void setMultiLookupHeuristic(bool p_multiLookup)
+    {
+        m_multiLookup = p_multiLookup;
+    }
+    // trueのときは子ノードをheuristicコストの小さい順に探索し，最初の解法を早く見つける
+    void setChildOrdering(bool p_childOrdering)
+    {
+        m_childOrdering = p_childOrdering;
+    }
+    // 解法のキャッシュを保存するファイルを設定する(空ならファイルに保存しない)
+    // 保存されている解法を読み込み，以降は解法を追加するたびに保存する
+    void setSolutionCacheFile(const QString& p_fileName)
+    {
+        m_solutionCache.SetFileName(p_fileName.toStdString());
+    }
+    // 完成付近のデータベースのメモリの上限(MB)を設定する(0なら作成しない)
+    // 上限に収まる最大の手数のデータベースをTableと一緒に作成するので，最初のrunより前に設定する
+    void setNearSolvedMemoryBudget(qint64 p_megabytes)
+    {
+        m_tables.SetNearSolvedMemoryBudget((uint64_t)p_megabytes << 20);
+    }
 
 public slots:
     void onGetSolverMessage(QString p_message)
@@ -24,8 +71,17 @@ public slots:
 
 protected:
     // run前にsetTimeOutとsetStrCubeStateを設定する
+    // 初回のみMoveTable,PruningTableを読み込む
     virtual void run();
 
+    // Tableのバンドルを開く(バンドルが使えないときはfalse)
+    bool openTableBundle();
+    // 開いたバンドル(バンドルが無いときはNULL)
+    const CTableBundle* getTableBundle() const
+    {
+        return m_tableBundle.IsOpen() ? &m_tableBundle : NULL;
+    }
+
 signals:
     void notifyCompleted(bool isSuccess, QString solution);
     void notifyMessage(QString p_message);
@@ -38,6 +94,26 @@ signals:
 private:
     qint64 m_timeOut;
     QString m_message;
+    bool m_initializeOnly;
+    bool m_optimalSolve;
+    bool m_sharedTables;
+    bool m_multiLookup;
+    bool m_childOrdering;
+
+    // 全てのTableをまとめたバンドル(TableGeneratorで作成する)
+    // Tableはバンドルのマップを参照するので，Tableより先に宣言する
+    CTableBundle m_tableBundle;
+    CTableBundle::Status m_bundleStatus;
+
+    // 解探索で共有するMoveTable,PruningTable
+    // スレッドの生存期間中(=プロセスの起動中)は保持し続ける
+    CSolverTables m_tables;
+    // 最適解探索で共有するMoveTable,PruningTable(パターンデータベースはメモリマップする)
+    COptimalSolverTables m_optimalTables;
+
+    // 解探索の結果のキャッシュ
+    // 同じ状態のCubeが再送されたときは解探索を行わずに返す
+    CSolutionCache m_solutionCache;
 };
 
 #endif // SOLVERTHREAD_H
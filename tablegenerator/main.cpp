@@ -0,0 +1,15 @@
+#include "tablegenerator.h"
+#include "solver/tablebundle.h"
+
+#include <QCoreApplication>
+
+// TableGenerator [バンドルのファイル名]
+// ファイル名を省略したときはCubeSolverが起動時に開くCubeSolverTables.bundleを作成する
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    std::string fileName = (argc > 1) ? std::string(argv[1]) : CTableBundle::DefaultFileName;
+
+    TableGenerator generator;
+    return generator.run(fileName) ? 0 : 1;
+}
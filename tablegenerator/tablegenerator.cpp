@@ -0,0 +1,67 @@
+#include "tablegenerator.h"
+
+#include "solver/solvertables.h"
+#include "solver/optimalsolvertables.h"
+#include "solver/tablebundle.h"
+
+#include <iostream>
+
+TableGenerator::TableGenerator(QObject *parent)
+    : QObject(parent)
+{
+}
+
+bool TableGenerator::run(const std::string p_fileName)
+{
+    std::vector<std::string> fileNames;
+
+    // Tableごとのファイルを作成する
+    {
+        CSolverTables tables;
+        COptimalSolverTables optimalTables;
+        connect(&tables, SIGNAL(notifySolverMessage(QString)),
+                this, SLOT(onGetSolverMessage(QString)));
+        connect(&optimalTables, SIGNAL(notifySolverMessage(QString)),
+                this, SLOT(onGetSolverMessage(QString)));
+
+        // 完成付近のデータベースはファイルに保存しないので作成しない
+        tables.SetNearSolvedMemoryBudget(0);
+        tables.Initialize();
+        optimalTables.Initialize();
+        fileNames = tables.GetFileNames();
+        fileNames.insert(fileNames.end(), optimalTables.GetFileNames().begin(), optimalTables.GetFileNames().end());
+    }
+
+    // バンドルにまとめる
+    std::cout << "Writing " << p_fileName << std::endl;
+    if (!CTableBundle::Write(p_fileName, fileNames)) {
+        std::cerr << "Failed to write " << p_fileName << std::endl;
+        return false;
+    }
+
+    // 作成したバンドルから全てのTableを読み込めることを確認する
+    CTableBundle bundle;
+    CTableBundle::Status status = bundle.Open(p_fileName);
+    if (status != CTableBundle::Loaded) {
+        std::cerr << CTableBundle::GetStatusText(status) << std::endl;
+        return false;
+    }
+    CSolverTables tables;
+    COptimalSolverTables optimalTables;
+    connect(&tables, SIGNAL(notifySolverMessage(QString)),
+            this, SLOT(onGetSolverMessage(QString)));
+    connect(&optimalTables, SIGNAL(notifySolverMessage(QString)),
+            this, SLOT(onGetSolverMessage(QString)));
+    tables.SetNearSolvedMemoryBudget(0);
+    if (!tables.Initialize(&bundle) || !optimalTables.Initialize(&bundle)) {
+        std::cerr << "Failed to verify " << p_fileName << std::endl;
+        return false;
+    }
+    std::cout << "Done" << std::endl;
+    return true;
+}
+
+void TableGenerator::onGetSolverMessage(QString p_message)
+{
+    std::cout << p_message.toStdString() << std::endl;
+}
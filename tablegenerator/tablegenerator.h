@@ -0,0 +1,24 @@
+#ifndef TABLEGENERATOR_H
+#define TABLEGENERATOR_H
+
+#include <QObject>
+#include <string>
+
+// 全てのMoveTable,PruningTableを作成して，1つのバンドルにまとめるクラス
+// Tableの作成中のメッセージは標準出力に表示する
+class TableGenerator : public QObject
+{
+    Q_OBJECT
+public:
+    TableGenerator(QObject *parent = 0);
+
+    // 作業ディレクトリにTableのファイルを作成し(既にあれば再利用する)，
+    // p_fileNameのバンドルにまとめる
+    // 作成したバンドルから全てのTableを読み込めることを確認する
+    bool run(const std::string p_fileName);
+
+public slots:
+    void onGetSolverMessage(QString p_message);
+};
+
+#endif // TABLEGENERATOR_H
@@ -0,0 +1,24 @@
+#-------------------------------------------------
+#
+# TableGenerator
+# 全てのMoveTable,PruningTableを作成して，1つのバンドルにまとめる
+# (配布用のイメージを作成するときに実行する)
+#
+#-------------------------------------------------
+
+QT       += core
+QT       -= gui
+
+TARGET = TableGenerator
+TEMPLATE = app
+
+CONFIG += c++14 console
+CONFIG -= app_bundle
+
+
+SOURCES += main.cpp \
+    tablegenerator.cpp
+
+HEADERS  += tablegenerator.h
+
+include(../solver/solver.pri)
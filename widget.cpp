@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <QTcpSocket>
 #include <QDateTime>
+#include <QCoreApplication>
 
 Widget::Widget(QWidget *parent) :
     QWidget(parent),
@@ -54,6 +55,28 @@ Widget::Widget(QWidget *parent) :
     connect(&worker, SIGNAL(notifyCompleted(bool,QString)), this, SLOT(onCompleted(bool,QString)));
     connect(&worker, SIGNAL(notifySolverMessage(QString)), this, SLOT(appendSolverMessage(QString)));
 
+    // 起動時にMoveTable,PruningTableを読み込んでおく
+    // (解探索のたびにTableを読み込まないようにする)
+    // 引数に--shared-tablesを指定すると，Tableのバンドルを同時に起動した他のプロセスと共有メモリで共有する
+    worker.setSharedTables(QCoreApplication::arguments().contains("--shared-tables"));
+    // 引数に--persistent-cacheを指定すると，解法のキャッシュをファイルに保存して次回の起動時にも使う
+    if(QCoreApplication::arguments().contains("--persistent-cache")){
+        worker.setSolutionCacheFile(QString::fromStdString(CSolutionCache::DefaultFileName));
+    }
+    // 引数に--multi-lookupを指定すると，Phase 1の探索で他の軸・逆元のCubeのPruningTableも引いて刈り込む
+    worker.setMultiLookupHeuristic(QCoreApplication::arguments().contains("--multi-lookup"));
+    // 引数に--child-orderingを指定すると，子ノードをheuristicコストの小さい順に探索する
+    worker.setChildOrdering(QCoreApplication::arguments().contains("--child-ordering"));
+    // 引数に--optimalを指定すると，Two Phase Algorithmの代わりに最適解探索を行う(数分から数時間かかることがある)
+    worker.setOptimalSolve(QCoreApplication::arguments().contains("--optimal"));
+    // 引数に--near-solved-memory <MB>を指定すると，完成付近のデータベースのメモリの上限を変更する(0なら使用しない)
+    int nearSolvedMemoryIndex = QCoreApplication::arguments().indexOf("--near-solved-memory");
+    if(nearSolvedMemoryIndex >= 0 && nearSolvedMemoryIndex + 1 < QCoreApplication::arguments().size()){
+        worker.setNearSolvedMemoryBudget(QCoreApplication::arguments().at(nearSolvedMemoryIndex + 1).toLongLong());
+    }
+    worker.setInitializeOnly(true);
+    worker.start();
+
     // GUI connection
     connect(ui->pushButtonSolverClear, SIGNAL(clicked(bool)), ui->textBrowserSolver, SLOT(clear()));
     connect(ui->SliderX, SIGNAL(valueChanged(int)), ui->GLwidget, SLOT(eyeXChanged(int)));
@@ -65,6 +88,9 @@ Widget::Widget(QWidget *parent) :
 
 Widget::~Widget()
 {
+    // Table読み込み・解探索の終了を待つ
+    worker.wait();
+
     timer->stop();
     delete timer;
     timerScroll->stop();
@@ -244,6 +270,12 @@ void Widget::receiveData()
     }
 
     // 受信できたのでデータをparse
+    if(busy && QString(buffer).trimmed() == m_solvingRequest){
+        // 解探索中のCubeと同じデータが再送されたときは，同じ解探索の終了を待つ
+        // (解法は最後に接続したクライアントに送信する)
+        appendMessage("The same cube state is being solved. The solution will be sent when the search finishes.");
+        return;
+    }
     if(busy || worker.isRunning()){
         appendMessage("Solver is busy now.");
         if(ServerIsValid){
@@ -302,7 +334,9 @@ void Widget::receiveData()
 
     // スルーモードの時はそのまま解きます
     if(ui->checkBoxThrough->isChecked()){
-        solve(timeOut, strCubeState.trimmed());
+        if(solve(timeOut, strCubeState.trimmed())){
+            m_solvingRequest = QString(buffer).trimmed();
+        }
     }
 }
 
@@ -361,6 +395,7 @@ bool Widget::solve(int p_timeOut, QString p_message)
         appendMessage("Finish parsing a cube state data.");
         */
         // Solverの初期設定
+        worker.setInitializeOnly(false);
         worker.setTimeOut(p_timeOut);
         worker.setStrCubeState(p_message.trimmed());
         // Solverスタート
@@ -397,6 +432,7 @@ void Widget::updateProgress()
 void Widget::onCompleted(bool isSuccess, QString solution)
 {
     busy = false;
+    m_solvingRequest.clear();
     if(isSuccess){
         QStringList tempList = solution.split(' ');
         m_moveTimes = QString(tempList.at(0)).toInt();
@@ -54,6 +54,8 @@ private:
     bool ServerIsValid;
     // Solverの処理フラグ
     bool busy;
+    // 解探索中のCubeの受信データ(同じデータが再送されたときはbusyを返さずに解法を送る)
+    QString m_solvingRequest;
 
     // ネットワーク関連変数
     int m_port;